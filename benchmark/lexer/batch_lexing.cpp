@@ -0,0 +1,66 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/batch_lexing.hpp"
+#include "./benchmark_common.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+   /// Returns a batch shaped like a build's: a thousand modules of a few functions each, and a
+   /// handful that are a hundred times larger.
+   ///
+   std::vector<std::string> make_batch()
+   {
+      auto batch = std::vector<std::string>{};
+      for (auto i = 0; i != 1'000; ++i) {
+         auto const functions = i % 200 == 0 ? 500 : 1 + i % 9;
+         auto module = std::string{"module benchmark.lexer;\n"};
+         for (auto j = 0; j != functions; ++j) {
+            module += lexer_benchmark::function;
+         }
+         batch.push_back(std::move(module));
+      }
+      return batch;
+   }
+
+   /// Compare the rate at one thread with the rate at n to see how lexing scales with cores.
+   ///
+   void lex_batch(benchmark::State& state)
+   {
+      auto const batch = make_batch();
+      auto const sources = std::vector<std::string_view>(batch.begin(), batch.end());
+      auto bytes = std::int64_t{0};
+      for (auto const source : sources) {
+         bytes += static_cast<std::int64_t>(source.size());
+      }
+
+      auto const how = ltcpp::batch_lexing{static_cast<std::size_t>(state.range(0))};
+      for (auto _ : state) {
+         auto const lexed = ltcpp::lex_files(sources, how);
+         benchmark::DoNotOptimize(lexed.data());
+      }
+      state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(sources.size()));
+      state.SetBytesProcessed(state.iterations() * bytes);
+   }
+   BENCHMARK(lex_batch)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,65 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef BENCHMARK_LEXER_BENCHMARK_COMMON_HPP
+#define BENCHMARK_LEXER_BENCHMARK_COMMON_HPP
+
+#include <string>
+#include <string_view>
+
+namespace lexer_benchmark {
+   using namespace std::string_view_literals;
+
+   /// \brief A function that uses most of the language's tokens, which the lexer benchmarks repeat
+   ///        to make a program.
+   ///
+   inline constexpr auto function = "fun frobnicate(x: mutable float64, name: ref string) -> int32 {\n"
+                                    "   let count: int32 <- 0; // how many times we've been round\n"
+                                    "   while (x >= 1.5e-3 and not (count = 100)) {\n"
+                                    "      x <- x / 2.0 - 0.125 * x;\n"
+                                    "      count++;\n"
+                                    "   }\n"
+                                    "   assert(name != \"\" or count < 10, 'c', \"count\");\n"
+                                    "   return count % 7 + sizeof(name[0]);\n"
+                                    "}\n"sv;
+
+   /// \brief Documentation for `function`.
+   ///
+   /// Documentation and indentation make up most of many real files, and are what the two-stage
+   /// lexer skips in bulk.
+   ///
+   inline constexpr auto documented_function =
+      "/// \\brief Halves x until it's small, and counts how many times that took.\n"
+      "/// \\param x The number to halve.\n"
+      "/// \\param name Must not be empty unless x starts off small.\n"
+      "///\n"sv;
+
+   /// \brief Returns a module made of `functions` copies of `function`, each preceded by
+   ///        `documented_function` if `documented` is true.
+   ///
+   inline std::string make_program(int const functions = 2'000, bool const documented = false)
+   {
+      auto result = std::string{"module benchmark.lexer;\n"};
+      for (auto i = 0; i != functions; ++i) {
+         if (documented) {
+            result += documented_function;
+         }
+         result += function;
+      }
+      return result;
+   }
+} // namespace lexer_benchmark
+
+#endif // BENCHMARK_LEXER_BENCHMARK_COMMON_HPP
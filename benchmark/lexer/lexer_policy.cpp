@@ -0,0 +1,70 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer_policy.hpp"
+#include "ltcpp/lexer/token_visitor.hpp"
+#include "ltcpp/reporter.hpp"
+#include "./benchmark_common.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+   struct without_positions : ltcpp::unreported_lexer_policy {
+      static constexpr bool positions = false;
+   };
+
+   struct with_trivia : ltcpp::default_lexer_policy {
+      static constexpr bool trivia = true;
+   };
+
+   /// Lexes the program with Policy, touching everything that the policy keeps.
+   ///
+   template<class Policy>
+   void lex_with(benchmark::State& state)
+   {
+      auto const program = lexer_benchmark::make_program();
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto tokens = std::int64_t{0};
+      auto const visit = [&tokens](auto const kind, std::string_view const spelling,
+                                   ltcpp::source_coordinate_range const position) noexcept {
+         benchmark::DoNotOptimize(kind);
+         benchmark::DoNotOptimize(spelling);
+         benchmark::DoNotOptimize(position);
+         ++tokens;
+      };
+
+      for (auto _ : state) {
+         if constexpr (Policy::diagnostics) {
+            ltcpp::lex<Policy>(program, report, visit);
+         }
+         else {
+            ltcpp::lex<Policy>(program, visit);
+         }
+      }
+      state.SetItemsProcessed(tokens);
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(program.size()));
+   }
+   BENCHMARK(lex_with<ltcpp::default_lexer_policy>);
+   BENCHMARK(lex_with<ltcpp::unreported_lexer_policy>);
+   BENCHMARK(lex_with<without_positions>);
+   BENCHMARK(lex_with<with_trivia>);
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/detail/scan_dfa.hpp"
+#include "ltcpp/lexer/detail/scan_identifier.hpp"
+#include "ltcpp/lexer/detail/scan_number.hpp"
+#include "ltcpp/lexer/detail/scan_string_literal.hpp"
+#include "ltcpp/lexer/detail/scan_symbol.hpp"
+#include "ltcpp/lexer/detail/scan_whitespace.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "./benchmark_common.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace {
+   namespace detail = ltcpp::detail_lexer;
+
+   ltcpp::token scan_hand_written(std::string_view& in, ltcpp::source_coordinate const cursor) noexcept
+   {
+      auto const c = detail::char_traits::to_int_type(in.front());
+      return detail::is_digit(c)           ? detail::scan_number(in, cursor)
+           : detail::is_identifier_head(c) ? detail::scan_identifier(in, cursor)
+           : c == '"'                      ? detail::scan_string_literal(in, cursor)
+           : c == '\''                     ? detail::scan_character_literal(in, cursor)
+                                           : detail::scan_symbol(in, cursor);
+   }
+
+   /// Lexes all of program with `scan`, after skipping whitespace the same way for both scanners.
+   ///
+   template<class Scanner>
+   std::int64_t lex(std::string_view program, Scanner scan)
+   {
+      auto tokens = std::int64_t{0};
+      auto cursor = ltcpp::source_coordinate{};
+      while (true) {
+         cursor = *detail::scan_whitespace_like(program, cursor);
+         if (program.empty()) {
+            return tokens;
+         }
+
+         auto const result = scan(program, cursor);
+         cursor = result.position().end();
+         benchmark::DoNotOptimize(result);
+         ++tokens;
+      }
+   }
+
+   template<class Scanner>
+   void run(benchmark::State& state, Scanner scan)
+   {
+      auto const program = lexer_benchmark::make_program(200);
+      auto tokens = std::int64_t{0};
+      for (auto _ : state) {
+         tokens += lex(program, scan);
+      }
+      state.SetItemsProcessed(tokens);
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(program.size()));
+   }
+
+   void lex_with_hand_written_scanners(benchmark::State& state)
+   {
+      run(state, [](std::string_view& in, ltcpp::source_coordinate const cursor) {
+         return scan_hand_written(in, cursor);
+      });
+   }
+   BENCHMARK(lex_with_hand_written_scanners);
+
+   void lex_with_dfa(benchmark::State& state)
+   {
+      run(state, [](std::string_view& in, ltcpp::source_coordinate const cursor) {
+         return detail::scan_dfa(in, cursor);
+      });
+   }
+   BENCHMARK(lex_with_dfa);
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,88 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_identifier.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "../../test/random_source.hpp"
+
+namespace {
+   using namespace std::string_view_literals;
+
+   constexpr auto identifier_count = std::int64_t{10'000};
+
+   /// Returns identifier_count space-separated identifiers: roughly a quarter are keywords and the
+   /// rest are between one and 24 characters long.
+   ///
+   std::string make_identifiers()
+   {
+      constexpr auto keywords = std::array{"let"sv, "fun"sv, "int32"sv, "return"sv, "if"sv,
+         "while"sv, "mutable"sv, "float64"sv};
+      constexpr auto tail = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_"sv;
+
+      auto seed = std::uint32_t{2'147'483'647};
+      auto result = std::string{};
+      for (auto i = std::int64_t{0}; i != identifier_count; ++i) {
+         if (random_below(seed, 4) == 0) {
+            result += keywords[random_below(seed, static_cast<std::uint32_t>(keywords.size()))];
+         }
+         else {
+            result += random_source(seed, tail.substr(0, 26), 1);
+            result += random_source(seed, tail, random_below(seed, 24));
+         }
+         result += ' ';
+      }
+      return result;
+   }
+
+   void scan_identifier_istream(benchmark::State& state)
+   {
+      auto const identifiers = make_identifiers();
+      for (auto _ : state) {
+         auto in = std::istringstream{identifiers};
+         for (auto i = std::int64_t{0}; i != identifier_count; ++i) {
+            benchmark::DoNotOptimize(ltcpp::detail_lexer::scan_identifier(in, ltcpp::source_coordinate{}));
+            in.get();
+         }
+      }
+      state.SetItemsProcessed(state.iterations() * identifier_count);
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(identifiers.size()));
+   }
+   BENCHMARK(scan_identifier_istream);
+
+   void scan_identifier_buffer(benchmark::State& state)
+   {
+      auto const identifiers = make_identifiers();
+      for (auto _ : state) {
+         auto in = std::string_view{identifiers};
+         for (auto i = std::int64_t{0}; i != identifier_count; ++i) {
+            benchmark::DoNotOptimize(ltcpp::detail_lexer::scan_identifier(in, ltcpp::source_coordinate{}));
+            in.remove_prefix(1);
+         }
+      }
+      state.SetItemsProcessed(state.iterations() * identifier_count);
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(identifiers.size()));
+   }
+   BENCHMARK(scan_identifier_buffer);
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,113 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/lexer/token_cache.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/text_edit.hpp"
+#include "./benchmark_common.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+   template<class... Mode>
+   void run(benchmark::State& state, bool const documented, Mode const... mode)
+   {
+      auto const program = lexer_benchmark::make_program(2'000, documented);
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto tokens = std::int64_t{0};
+      for (auto _ : state) {
+         auto const buffer = ltcpp::token_buffer{program, report, mode...};
+         benchmark::DoNotOptimize(buffer.kind(buffer.size() - 1));
+         tokens += static_cast<std::int64_t>(buffer.size());
+      }
+      state.SetItemsProcessed(tokens);
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(program.size()));
+   }
+
+   void lex_sequentially(benchmark::State& state)
+   { run(state, false); }
+   BENCHMARK(lex_sequentially);
+
+   void lex_in_two_stages(benchmark::State& state)
+   { run(state, false, ltcpp::two_stage_lexing); }
+   BENCHMARK(lex_in_two_stages);
+
+   void lex_documented_sequentially(benchmark::State& state)
+   { run(state, true); }
+   BENCHMARK(lex_documented_sequentially);
+
+   void lex_documented_in_two_stages(benchmark::State& state)
+   { run(state, true, ltcpp::two_stage_lexing); }
+   BENCHMARK(lex_documented_in_two_stages);
+
+   /// Types a space into the middle of the program and deletes it again, as someone typing would.
+   /// The two texts are made up front, so that what's measured is the edits rather than the program's
+   /// size.
+   ///
+   void edit_in_place(benchmark::State& state)
+   {
+      auto const program = lexer_benchmark::make_program();
+      auto const offset = program.size() / 2;
+      auto spaced = program;
+      spaced.insert(offset, 1, ' ');
+
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto buffer = ltcpp::token_buffer{program, report};
+      for (auto _ : state) {
+         benchmark::DoNotOptimize(buffer.edit(spaced, ltcpp::text_edit{offset, 0, 1}, report));
+         benchmark::DoNotOptimize(buffer.edit(program, ltcpp::text_edit{offset, 1, 0}, report));
+      }
+      state.SetItemsProcessed(2 * state.iterations());
+   }
+   BENCHMARK(edit_in_place);
+
+   /// A cache hit hashes the source and maps the entry, and then the kinds are walked as a parser
+   /// would.
+   ///
+   void find_in_cache(benchmark::State& state)
+   {
+      auto const program = lexer_benchmark::make_program();
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto const directory = std::filesystem::temp_directory_path() / "ltcpp-benchmark-token-cache";
+      auto const cache = ltcpp::token_cache{directory};
+      cache.store(ltcpp::token_buffer{program, report});
+
+      auto tokens = std::int64_t{0};
+      for (auto _ : state) {
+         auto const cached = cache.find(program);
+         auto identifiers = 0;
+         for (auto const kind : cached->kinds()) {
+            identifiers += kind == ltcpp::token_kind::identifier;
+         }
+         benchmark::DoNotOptimize(identifiers);
+         tokens += static_cast<std::int64_t>(cached->size());
+      }
+      state.SetItemsProcessed(tokens);
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(program.size()));
+      std::filesystem::remove_all(directory);
+   }
+   BENCHMARK(find_in_cache);
+} // namespace
+
+BENCHMARK_MAIN();
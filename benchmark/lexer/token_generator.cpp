@@ -0,0 +1,105 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/lexer_view.hpp"
+#include "ltcpp/lexer/token_generator.hpp"
+#include "ltcpp/lexer/token_visitor.hpp"
+#include "ltcpp/reporter.hpp"
+#include "./benchmark_common.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+   /// Runs consume over the program's tokens, which it returns the number of.
+   ///
+   template<class Consume>
+   void run(benchmark::State& state, Consume consume)
+   {
+      auto const program = lexer_benchmark::make_program();
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto tokens = std::int64_t{0};
+      for (auto _ : state) {
+         tokens += consume(std::string_view{program}, report);
+      }
+      state.SetItemsProcessed(tokens);
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(program.size()));
+   }
+
+   void pull_tokens(benchmark::State& state)
+   {
+      run(state, [](std::string_view in, ltcpp::reporter& report) {
+         auto count = std::int64_t{0};
+         auto cursor = ltcpp::source_coordinate{};
+         for (;;) {
+            auto const t = ltcpp::generate_token(in, report, cursor);
+            benchmark::DoNotOptimize(t.kind());
+            ++count;
+            if (t.kind() == ltcpp::token_kind::eof) {
+               return count;
+            }
+            cursor = t.position().end();
+         }
+      });
+   }
+   BENCHMARK(pull_tokens);
+
+   void yield_tokens(benchmark::State& state)
+   {
+      run(state, [](std::string_view const in, ltcpp::reporter& report) {
+         auto count = std::int64_t{0};
+         for (auto const& t : ltcpp::yield_tokens(in, report)) {
+            benchmark::DoNotOptimize(t.kind());
+            ++count;
+         }
+         return count;
+      });
+   }
+   BENCHMARK(yield_tokens);
+
+   void view_tokens(benchmark::State& state)
+   {
+      run(state, [](std::string_view const in, ltcpp::reporter& report) {
+         auto count = std::int64_t{0};
+         for (auto const& t : ltcpp::lexer_view{in, report}) {
+            benchmark::DoNotOptimize(t.kind());
+            ++count;
+         }
+         return count;
+      });
+   }
+   BENCHMARK(view_tokens);
+
+   void visit_tokens(benchmark::State& state)
+   {
+      run(state, [](std::string_view const in, ltcpp::reporter&) {
+         auto count = std::int64_t{0};
+         ltcpp::lex(in, [&count](ltcpp::token_kind const kind, std::string_view,
+                                 ltcpp::source_coordinate_range) noexcept {
+            benchmark::DoNotOptimize(kind);
+            ++count;
+         });
+         return count;
+      });
+   }
+   BENCHMARK(visit_tokens);
+} // namespace
+
+BENCHMARK_MAIN();
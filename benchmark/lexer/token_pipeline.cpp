@@ -0,0 +1,86 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token_pipeline.hpp"
+#include "ltcpp/reporter.hpp"
+#include "./benchmark_common.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+   /// Stands in for a parser that spends about as long on each token as the lexer does.
+   ///
+   std::uint64_t parse(ltcpp::token const& t, std::uint64_t hash)
+   {
+      for (auto i = 0; i != 16; ++i) {
+         for (auto const c : t.spelling()) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100'0000'01b3;
+         }
+      }
+      return hash;
+   }
+
+   void lex_then_parse(benchmark::State& state)
+   {
+      auto const program = lexer_benchmark::make_program();
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      for (auto _ : state) {
+         auto in = std::string_view{program};
+         auto cursor = ltcpp::source_coordinate{};
+         auto hash = std::uint64_t{0};
+         for (;;) {
+            auto const t = ltcpp::generate_token(in, report, cursor);
+            hash = parse(t, hash);
+            if (t.kind() == ltcpp::token_kind::eof) {
+               break;
+            }
+            cursor = t.position().end();
+         }
+         benchmark::DoNotOptimize(hash);
+      }
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(program.size()));
+   }
+   BENCHMARK(lex_then_parse)->UseRealTime();
+
+   void lex_while_parsing(benchmark::State& state)
+   {
+      auto const program = lexer_benchmark::make_program();
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto const how = ltcpp::pipelined_lexing{.batch_size = static_cast<std::size_t>(state.range(0))};
+      for (auto _ : state) {
+         auto pipeline = ltcpp::token_pipeline{program, report, how};
+         auto hash = std::uint64_t{0};
+         for (;;) {
+            auto const& t = pipeline.next();
+            hash = parse(t, hash);
+            if (t.kind() == ltcpp::token_kind::eof) {
+               break;
+            }
+         }
+         benchmark::DoNotOptimize(hash);
+      }
+      state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(program.size()));
+   }
+   BENCHMARK(lex_while_parsing)->RangeMultiplier(8)->Range(64, 4096)->UseRealTime();
+} // namespace
+
+BENCHMARK_MAIN();
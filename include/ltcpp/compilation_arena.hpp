@@ -0,0 +1,70 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_COMPILATION_ARENA_HPP
+#define LTCPP_COMPILATION_ARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+
+namespace ltcpp {
+   /// \brief A monotonic memory_resource that holds everything built while compiling one
+   ///        translation unit.
+   ///
+   /// Storage is handed out by bumping a pointer and is never given back piecemeal: deallocation
+   /// is a no-op, and the arena returns all of its blocks to the upstream resource at once, when
+   /// it's released or destroyed. Containers built on it can therefore skip their element-by-
+   /// element teardown.
+   ///
+   class compilation_arena {
+   public:
+      /// \brief Makes an arena whose first block is initial_size bytes.
+      ///
+      explicit compilation_arena(std::size_t const initial_size = 64 * 1024,
+         std::pmr::memory_resource* const upstream = std::pmr::get_default_resource())
+         : memory_{initial_size, upstream}
+      {}
+
+      /// \brief Makes an arena whose first block is large enough to lex source into a
+      ///        `token_buffer` without going back to the upstream resource.
+      ///
+      explicit compilation_arena(std::string_view const source,
+         std::pmr::memory_resource* const upstream = std::pmr::get_default_resource())
+         : compilation_arena{estimate(source.size()), upstream}
+      {}
+
+      compilation_arena(compilation_arena const&) = delete;
+      compilation_arena& operator=(compilation_arena const&) = delete;
+
+      std::pmr::memory_resource* resource() noexcept
+      { return &memory_; }
+
+      /// \brief Frees everything that was allocated from the arena.
+      /// \pre Nothing allocated from the arena is used again.
+      ///
+      void release() noexcept
+      { memory_.release(); }
+   private:
+      std::pmr::monotonic_buffer_resource memory_;
+
+      // A token_buffer reserves nine bytes for every five characters, and a line_table four for
+      // every 32; the rest is slack for whatever's built next.
+      static constexpr std::size_t estimate(std::size_t const source_size) noexcept
+      { return source_size * 2 + 4 * 1024; }
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_COMPILATION_ARENA_HPP
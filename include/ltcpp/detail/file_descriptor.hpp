@@ -0,0 +1,63 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef LTCPP_DETAIL_FILE_DESCRIPTOR_HPP
+#define LTCPP_DETAIL_FILE_DESCRIPTOR_HPP
+
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+
+namespace ltcpp::detail {
+   /// \brief Throws a std::system_error for errno, saying what couldn't be done to path.
+   ///
+   [[noreturn]] inline void throw_system_error(std::string_view const what,
+      std::filesystem::path const& path)
+   {
+      throw std::system_error{errno, std::generic_category(),
+         std::string{what} + " '" + path.string() + "'"};
+   }
+
+   /// \brief Owns a POSIX file descriptor, and closes it when destroyed.
+   ///
+   /// It can hold the -1 that a failed `open` returns, so that the caller can check errno before
+   /// deciding whether that's an error.
+   ///
+   class file_descriptor {
+   public:
+      explicit file_descriptor(int const fd) noexcept
+         : fd_{fd}
+      {}
+
+      file_descriptor(file_descriptor const&) = delete;
+      file_descriptor& operator=(file_descriptor const&) = delete;
+
+      ~file_descriptor()
+      {
+         if (fd_ != -1) {
+            ::close(fd_);
+         }
+      }
+
+      int get() const noexcept
+      { return fd_; }
+   private:
+      int fd_;
+   };
+} // namespace ltcpp::detail
+
+#endif // LTCPP_DETAIL_FILE_DESCRIPTOR_HPP
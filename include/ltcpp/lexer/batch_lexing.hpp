@@ -0,0 +1,84 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_BATCH_LEXING_HPP
+#define LTCPP_LEXER_BATCH_LEXING_HPP
+
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/source_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ltcpp {
+   /// \brief How `lex_files` spreads a batch of files over threads.
+   ///
+   struct batch_lexing {
+      /// The most threads to lex on, including the calling thread.
+      std::size_t threads = std::thread::hardware_concurrency();
+   };
+
+   /// \brief The tokens of one file in a batch, and the diagnostics that lexing it produced.
+   ///
+   struct lexed_file {
+      token_buffer tokens;
+
+      /// The diagnostics, formatted exactly as a reporter would have written them.
+      std::string diagnostics;
+
+      std::intmax_t errors;
+      std::intmax_t warnings;
+   };
+
+   /// \brief A file that `lex_files` read, along with its tokens.
+   ///
+   struct lexed_source_file {
+      /// Owns the text that `lexed.tokens` refers to.
+      source_file file;
+
+      lexed_file lexed;
+   };
+
+   /// \brief Lexes each of sources on a pool of threads.
+   ///
+   /// The files are handed out largest first, spread evenly over the threads, and a thread that
+   /// runs out of work takes the largest file that another hasn't started yet, so a few large
+   /// files don't leave the other threads idle at the end of a batch of small ones. Each file is
+   /// lexed by one thread, in two stages, into a token_buffer of its own.
+   ///
+   /// \param sources The text of each file. Each must outlive the token_buffer lexed from it.
+   /// \returns One lexed_file for each source, in the same order, whose tokens are identified by
+   ///          `file_id{i}` for the ith source. The results don't depend on the number of threads.
+   /// \throws std::length_error if a source is too large for its offsets to fit in 32 bits.
+   ///
+   std::vector<lexed_file>
+   lex_files(std::span<std::string_view const> sources, batch_lexing how = {}) noexcept(false);
+
+   /// \brief Reads and lexes each of paths on a pool of threads, balancing the work as the
+   ///        std::string_view overload does.
+   ///
+   /// \returns One lexed_source_file for each path, in the same order.
+   /// \throws std::system_error if a file cannot be opened, mapped, or read.
+   ///
+   std::vector<lexed_source_file>
+   lex_files(std::span<std::filesystem::path const> paths, batch_lexing how = {}) noexcept(false);
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_BATCH_LEXING_HPP
@@ -0,0 +1,81 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_CHUNKED_SOURCE_HPP
+#define LTCPP_LEXER_CHUNKED_SOURCE_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace ltcpp {
+   /// \brief A bounded window over a file descriptor that is refilled with read(2) one chunk at a
+   ///        time.
+   ///
+   /// Only the characters that have been read but not yet consumed are kept, so memory stays
+   /// proportional to the chunk size plus the longest token, no matter how much input the descriptor
+   /// produces.
+   ///
+   class chunked_source {
+   public:
+      static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+      /// \brief Prepares to read from fd, which must remain open for the lifetime of the
+      ///        chunked_source. No characters are read until the first call to `refill`.
+      /// \param fd A file descriptor open for reading. It can be a pipe or any other descriptor
+      ///           that read(2) accepts.
+      /// \param chunk_size The smallest number of bytes requested by each read(2).
+      ///
+      explicit chunked_source(int fd, std::size_t chunk_size = default_chunk_size);
+
+      /// \brief Returns the characters that have been read but not consumed.
+      ///
+      std::string_view unscanned() const noexcept
+      { return std::string_view{buffer_.data() + first_, last_ - first_}; }
+
+      /// \brief Discards the first n unscanned characters.
+      /// \pre `n <= unscanned().size()`
+      ///
+      void consume(std::size_t const n) noexcept
+      { first_ += n; }
+
+      /// \brief Returns true once read(2) has reported end-of-file.
+      ///
+      bool exhausted() const noexcept
+      { return exhausted_; }
+
+      /// \brief Reads more characters onto the end of `unscanned()`, moving the unscanned characters
+      ///        to the front of the buffer first and growing the buffer when they already fill more
+      ///        than half of it.
+      /// \returns false if end-of-file was reached before any new characters were read.
+      /// \throws std::system_error if read(2) fails.
+      ///
+      bool refill() noexcept(false);
+
+      /// \brief Returns the number of bytes currently allocated for the window.
+      ///
+      std::size_t capacity() const noexcept
+      { return buffer_.size(); }
+   private:
+      int fd_;
+      std::size_t chunk_size_;
+      std::vector<char> buffer_;
+      std::size_t first_ = 0;
+      std::size_t last_ = 0;
+      bool exhausted_ = false;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_CHUNKED_SOURCE_HPP
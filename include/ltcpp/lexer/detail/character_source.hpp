@@ -0,0 +1,238 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_CHARACTER_SOURCE_HPP
+#define LTCPP_LEXER_DETAIL_CHARACTER_SOURCE_HPP
+
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ltcpp::detail_lexer {
+   using char_traits = std::char_traits<char>;
+   using int_type = char_traits::int_type;
+
+   /// \brief A CharacterSource is the minimal interface the scanners need from their input:
+   ///        one character of lookahead, consumption, and the ability to give back the most
+   ///        recently consumed character.
+   ///
+   template<class S>
+   concept CharacterSource = requires(S& s) {
+      { s.peek() } -> std::same_as<int_type>;
+      { s.get() } -> std::same_as<int_type>;
+      s.unget();
+   };
+
+   /// \brief A ContiguousSource also exposes everything it hasn't consumed as one view, so that
+   ///        scanners can examine many characters at a time.
+   ///
+   template<class S>
+   concept ContiguousSource = CharacterSource<S> and requires(S& s, std::size_t const n) {
+      { s.unscanned() } -> std::same_as<std::string_view>;
+      s.consume(n);
+   };
+
+   /// \brief Adapts a std::istream so that it models CharacterSource.
+   ///
+   class istream_source {
+   public:
+      explicit istream_source(std::istream& in) noexcept
+         : in_{std::addressof(in)}
+      {}
+
+      int_type peek() noexcept
+      { return in_->peek(); }
+
+      int_type get() noexcept
+      { return in_->get(); }
+
+      void unget() noexcept
+      { in_->unget(); }
+   private:
+      std::istream* in_;
+   };
+
+   /// \brief Adapts a contiguous buffer so that it models CharacterSource.
+   ///
+   /// Each operation is a pointer comparison and an increment or decrement; the view that was
+   /// passed in is advanced past every character that has been consumed.
+   ///
+   class buffer_source {
+   public:
+      explicit buffer_source(std::string_view& in) noexcept
+         : in_{std::addressof(in)}
+      {}
+
+      int_type peek() const noexcept
+      { return in_->empty() ? char_traits::eof() : char_traits::to_int_type(in_->front()); }
+
+      int_type get() noexcept
+      {
+         auto const result = peek();
+         if (not in_->empty()) {
+            in_->remove_prefix(1);
+         }
+         return result;
+      }
+
+      void unget() noexcept
+      { *in_ = std::string_view{in_->data() - 1, in_->size() + 1}; }
+
+      /// \brief Returns the characters that haven't been consumed.
+      ///
+      std::string_view unscanned() const noexcept
+      { return *in_; }
+
+      /// \brief Consumes the first n unscanned characters.
+      /// \pre `n <= unscanned().size()`
+      ///
+      void consume(std::size_t const n) noexcept
+      { in_->remove_prefix(n); }
+   private:
+      std::string_view* in_;
+   };
+
+   /// \brief Records the characters that a scanner extracts, which become the spelling of the token
+   ///        that it produces.
+   ///
+   /// A ContiguousSource still holds every character that's been extracted from it, so the
+   /// spelling is a view of the source and nothing is copied. Any other source is accumulated into
+   /// a std::string.
+   ///
+   template<CharacterSource Source>
+   class lexeme {
+   public:
+      explicit lexeme(Source& in) noexcept
+         : in_{std::addressof(in)}
+      {
+         if constexpr (ContiguousSource<Source>) {
+            text_ = in.unscanned();
+         }
+      }
+
+      int_type peek() noexcept
+      { return in_->peek(); }
+
+      /// \brief Extracts the next character from the source and appends it to the lexeme.
+      ///
+      int_type get() noexcept
+      {
+         auto const c = in_->get();
+         if constexpr (not ContiguousSource<Source>) {
+            if (c != char_traits::eof()) {
+               text_ += char_traits::to_char_type(c);
+            }
+         }
+         return c;
+      }
+
+      /// \brief Returns every character that's been extracted.
+      ///
+      std::string_view view() const noexcept
+      {
+         if constexpr (ContiguousSource<Source>) {
+            return text_.substr(0, text_.size() - in_->unscanned().size());
+         }
+         else {
+            return text_;
+         }
+      }
+
+      /// \brief Makes a token spelled by every character that's been extracted.
+      ///
+      token make_token(source_coordinate const cursor, token_kind const kind) && noexcept
+      {
+         if constexpr (ContiguousSource<Source>) {
+            return ltcpp::make_token(borrowed_spelling, view(), cursor, kind);
+         }
+         else {
+            return ltcpp::make_token(std::move(text_), cursor, kind);
+         }
+      }
+   private:
+      Source* in_;
+      std::conditional_t<ContiguousSource<Source>, std::string_view, std::string> text_ = {};
+   };
+
+   /// \brief Returns the character that the escape sequence `\c` denotes, if it's valid.
+   ///
+   constexpr std::optional<char> decode_escape(int_type const c) noexcept
+   {
+      switch (c) {
+      case 'b':
+         return '\b';
+      case 'f':
+         return '\f';
+      case 'n':
+         return '\n';
+      case 'r':
+         return '\r';
+      case 't':
+         return '\t';
+      case '\'':
+         return '\'';
+      case '"':
+         return '"';
+      case '\\':
+         return '\\';
+      default:
+         return std::nullopt;
+      }
+   }
+
+   constexpr bool is_digit(int_type const c) noexcept
+   { return '0' <= c and c <= '9'; }
+
+   constexpr bool is_alpha(int_type const c) noexcept
+   { return ('a' <= c and c <= 'z') or ('A' <= c and c <= 'Z'); }
+
+   constexpr bool is_identifier_head(int_type const c) noexcept
+   { return is_alpha(c) or c == '_'; }
+
+   constexpr bool is_identifier_tail(int_type const c) noexcept
+   { return is_identifier_head(c) or is_digit(c); }
+
+   /// \brief Moves cursor `n` columns to the right.
+   ///
+   constexpr source_coordinate advance_column(source_coordinate const cursor,
+      std::intmax_t const n = 1) noexcept
+   {
+      return source_coordinate::shift(cursor, source_coordinate{
+         source_coordinate::line_type{0},
+         source_coordinate::column_type{n}
+      });
+   }
+
+   /// \brief Moves cursor to the first column of the next line.
+   ///
+   constexpr source_coordinate advance_line(source_coordinate const cursor) noexcept
+   {
+      return source_coordinate::shift(cursor, source_coordinate{
+         source_coordinate::line_type{1},
+         source_coordinate::column_type{0}
+      });
+   }
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_CHARACTER_SOURCE_HPP
@@ -0,0 +1,111 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_DECODE_NUMBER_HPP
+#define LTCPP_LEXER_DETAIL_DECODE_NUMBER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+namespace ltcpp::detail_lexer {
+   /// \brief Loads the eight characters at `text[i]`, the first into the lowest byte.
+   /// \pre `i + 8 <= text.size()`
+   ///
+   /// Building the word a byte at a time keeps the order independent of the processor's, and
+   /// compilers turn it into a single load on little-endian machines.
+   ///
+   constexpr std::uint64_t load_eight_characters(std::string_view const text, std::size_t const i) noexcept
+   {
+      auto word = std::uint64_t{0};
+      for (auto k = std::size_t{0}; k != 8; ++k) {
+         word |= std::uint64_t{static_cast<unsigned char>(text[i + k])} << (8 * k);
+      }
+      return word;
+   }
+
+   /// \brief Returns the value of eight decimal digits that have been loaded by
+   ///        `load_eight_characters`.
+   ///
+   /// The digits are combined in three multiplies rather than eight: first into pairs, then into
+   /// groups of four, and finally into one eight-digit number.
+   ///
+   constexpr std::uint32_t parse_eight_digits(std::uint64_t chunk) noexcept
+   {
+      chunk -= 0x3030'3030'3030'3030;
+      chunk = chunk * 10 + (chunk >> 8);
+      chunk = ((chunk & 0x0000'00FF'0000'00FF) * (100 + (std::uint64_t{1'000'000} << 32))
+             + ((chunk >> 16) & 0x0000'00FF'0000'00FF) * (1 + (std::uint64_t{10'000} << 32))) >> 32;
+      return static_cast<std::uint32_t>(chunk);
+   }
+
+   /// \brief Returns the value of a string of decimal digits, or `std::nullopt` if it's too large
+   ///        for 64 bits.
+   /// \pre digits consists of only '0' through '9'.
+   ///
+   constexpr std::optional<std::uint64_t> decode_integer(std::string_view digits) noexcept
+   {
+      auto const significant = digits.find_first_not_of('0');
+      if (significant == std::string_view::npos) {
+         return std::uint64_t{0};
+      }
+      digits.remove_prefix(significant);
+
+      // No 19-digit number can overflow, so only a twentieth digit needs checking.
+      constexpr auto max_digits = std::size_t{std::numeric_limits<std::uint64_t>::digits10} + 1;
+      if (digits.size() > max_digits) {
+         return std::nullopt;
+      }
+
+      auto const unchecked = digits.size() < max_digits ? digits.size() : max_digits - 1;
+      auto value = std::uint64_t{0};
+      auto i = std::size_t{0};
+      for (; i + 8 <= unchecked; i += 8) {
+         value = value * 100'000'000 + parse_eight_digits(load_eight_characters(digits, i));
+      }
+      for (; i != unchecked; ++i) {
+         value = value * 10 + static_cast<std::uint64_t>(digits[i] - '0');
+      }
+
+      if (unchecked != digits.size()) {
+         auto const last = static_cast<std::uint64_t>(digits.back() - '0');
+         if (value > (std::numeric_limits<std::uint64_t>::max() - last) / 10) {
+            return std::nullopt;
+         }
+         value = value * 10 + last;
+      }
+      return value;
+   }
+
+   /// \brief Returns the double nearest to a floating-point literal, or `std::nullopt` if its
+   ///        magnitude is too large or too small for a double to represent.
+   /// \pre spelling is a well-formed floating-point literal.
+   ///
+   inline std::optional<double> decode_floating(std::string_view const spelling) noexcept
+   {
+      auto value = 0.0;
+      auto const [end, error] = std::from_chars(spelling.data(), spelling.data() + spelling.size(), value);
+      if (error != std::errc{} or end != spelling.data() + spelling.size()) {
+         return std::nullopt;
+      }
+      return value;
+   }
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_DECODE_NUMBER_HPP
@@ -0,0 +1,280 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_GAP_BUFFER_HPP
+#define LTCPP_LEXER_DETAIL_GAP_BUFFER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace ltcpp::detail_lexer {
+   /// \brief A sequence that's cheap to edit near where it was last edited.
+   ///
+   /// The elements are stored in one array with a gap in it, which sits just after the most recent
+   /// replacement. Replacing elements moves the gap there first, so the cost of an edit is
+   /// proportional to its size and to how far it is from the previous one, rather than to the
+   /// number of elements after it, and edits that follow one another through a file, as typing
+   /// does, are cheap however large the file is.
+   ///
+   /// When T is an unsigned integer, such as an offset into a source file, the elements after the
+   /// gap are stored relative to it: `shift_tail` adds a number to all of them at once, and they're
+   /// only rewritten when the gap moves past them.
+   ///
+   template<class T>
+   class gap_buffer {
+   public:
+      class const_iterator;
+
+      explicit gap_buffer(std::pmr::memory_resource* const memory = std::pmr::get_default_resource())
+         : storage_{memory}
+      {}
+
+      /// \brief Holds elements, with the gap after them.
+      ///
+      explicit gap_buffer(std::pmr::vector<T> elements) noexcept
+         : storage_{std::move(elements)}
+         , gap_begin_{storage_.size()}
+         , gap_end_{storage_.size()}
+      {}
+
+      std::size_t size() const noexcept
+      { return storage_.size() - (gap_end_ - gap_begin_); }
+
+      bool empty() const noexcept
+      { return size() == 0; }
+
+      /// \pre `i < size()`
+      ///
+      T operator[](std::size_t const i) const noexcept
+      { return i < gap_begin_ ? storage_[i] : after_gap(storage_[i + (gap_end_ - gap_begin_)]); }
+
+      /// \pre `not empty()`
+      ///
+      T back() const noexcept
+      { return (*this)[size() - 1]; }
+
+      const_iterator begin() const noexcept
+      { return const_iterator{*this, 0}; }
+
+      const_iterator end() const noexcept
+      { return const_iterator{*this, size()}; }
+
+      /// \brief Returns whether the elements are stored as one array, as they are until the first
+      ///        `replace` and again after `compact`.
+      ///
+      bool is_contiguous() const noexcept
+      { return gap_begin_ == gap_end_ and bias_ == T{}; }
+
+      /// \brief Returns the elements as one array.
+      /// \pre `is_contiguous()`
+      ///
+      std::span<T const> contiguous() const noexcept
+      {
+         assert(is_contiguous());
+         return storage_;
+      }
+
+      std::pmr::polymorphic_allocator<T> get_allocator() const noexcept
+      { return storage_.get_allocator(); }
+
+      void reserve(std::size_t const capacity)
+      { storage_.reserve(capacity + (gap_end_ - gap_begin_)); }
+
+      void push_back(T const value)
+      { storage_.push_back(stored_after_gap(value)); }
+
+      /// \brief Replaces the `removed` elements from the `first` on with inserted, and moves the gap
+      ///        to just after them.
+      /// \pre `first + removed <= size()`
+      ///
+      template<std::ranges::sized_range R>
+      void replace(std::size_t const first, std::size_t const removed, R const& inserted)
+      {
+         move_gap(first + removed);
+         gap_begin_ = first;
+         auto const count = static_cast<std::size_t>(std::ranges::size(inserted));
+         if (gap_end_ - gap_begin_ < count) {
+            grow(count);
+         }
+
+         std::ranges::copy(inserted, storage_.begin() + static_cast<std::ptrdiff_t>(gap_begin_));
+         gap_begin_ += count;
+      }
+
+      /// \brief Adds delta to every element after the gap: after a `replace`, to every element after
+      ///        those that were inserted.
+      ///
+      void shift_tail(T const delta) noexcept
+      requires std::unsigned_integral<T>
+      { bias_ = static_cast<T>(bias_ + delta); }
+
+      /// \brief Closes the gap, so that the elements are stored as one array again. Costs time in
+      ///        proportion to the number of elements after the gap.
+      ///
+      void compact()
+      {
+         move_gap(size());
+         storage_.resize(gap_begin_);
+         gap_end_ = gap_begin_;
+         bias_ = T{};
+      }
+   private:
+      std::pmr::vector<T> storage_;
+      std::size_t gap_begin_ = 0;
+      std::size_t gap_end_ = 0;
+
+      // What `shift_tail` has added to the elements after the gap since they were stored.
+      T bias_ = T{};
+
+      T after_gap(T const stored) const noexcept
+      {
+         if constexpr (std::unsigned_integral<T>) {
+            return static_cast<T>(stored + bias_);
+         }
+         else {
+            return stored;
+         }
+      }
+
+      T stored_after_gap(T const value) const noexcept
+      {
+         if constexpr (std::unsigned_integral<T>) {
+            return static_cast<T>(value - bias_);
+         }
+         else {
+            return value;
+         }
+      }
+
+      /// Moves the gap so that the first `index` elements are before it.
+      ///
+      void move_gap(std::size_t const index) noexcept
+      {
+         while (gap_begin_ > index) {
+            storage_[--gap_end_] = stored_after_gap(storage_[--gap_begin_]);
+         }
+         while (gap_begin_ < index) {
+            storage_[gap_begin_++] = after_gap(storage_[gap_end_++]);
+         }
+      }
+
+      /// Widens the gap to hold at least count elements, with room to spare in proportion to the
+      /// size, so that a run of insertions reallocates a logarithmic number of times.
+      ///
+      void grow(std::size_t const count)
+      {
+         auto const gap = count + size() / 8 + 16;
+         auto grown = std::pmr::vector<T>{storage_.get_allocator()};
+         grown.reserve(size() + gap);
+         grown.insert(grown.end(), storage_.begin(), storage_.begin() + static_cast<std::ptrdiff_t>(gap_begin_));
+         grown.resize(gap_begin_ + gap);
+         grown.insert(grown.end(), storage_.begin() + static_cast<std::ptrdiff_t>(gap_end_), storage_.end());
+         gap_end_ = gap_begin_ + gap;
+         storage_.swap(grown);
+      }
+   };
+
+   /// \brief Reads the elements of a gap_buffer in order. Its reference type is T itself, because
+   ///        elements after the gap are computed rather than stored as they are.
+   ///
+   template<class T>
+   class gap_buffer<T>::const_iterator {
+   public:
+      using iterator_concept = std::random_access_iterator_tag;
+      using iterator_category = std::input_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+
+      const_iterator() = default;
+
+      const_iterator(gap_buffer const& buffer, std::size_t const index) noexcept
+         : buffer_{&buffer}
+         , index_{index}
+      {}
+
+      T operator*() const noexcept
+      { return (*buffer_)[index_]; }
+
+      T operator[](difference_type const n) const noexcept
+      { return *(*this + n); }
+
+      const_iterator& operator++() noexcept
+      {
+         ++index_;
+         return *this;
+      }
+
+      const_iterator operator++(int) noexcept
+      {
+         auto const result = *this;
+         ++index_;
+         return result;
+      }
+
+      const_iterator& operator--() noexcept
+      {
+         --index_;
+         return *this;
+      }
+
+      const_iterator operator--(int) noexcept
+      {
+         auto const result = *this;
+         --index_;
+         return result;
+      }
+
+      const_iterator& operator+=(difference_type const n) noexcept
+      {
+         index_ = static_cast<std::size_t>(static_cast<difference_type>(index_) + n);
+         return *this;
+      }
+
+      const_iterator& operator-=(difference_type const n) noexcept
+      { return *this += -n; }
+
+      friend const_iterator operator+(const_iterator i, difference_type const n) noexcept
+      { return i += n; }
+
+      friend const_iterator operator+(difference_type const n, const_iterator i) noexcept
+      { return i += n; }
+
+      friend const_iterator operator-(const_iterator i, difference_type const n) noexcept
+      { return i -= n; }
+
+      friend difference_type operator-(const_iterator const a, const_iterator const b) noexcept
+      { return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_); }
+
+      friend bool operator==(const_iterator const a, const_iterator const b) noexcept
+      { return a.index_ == b.index_; }
+
+      friend std::strong_ordering operator<=>(const_iterator const a, const_iterator const b) noexcept
+      { return a.index_ <=> b.index_; }
+   private:
+      gap_buffer const* buffer_ = nullptr;
+      std::size_t index_ = 0;
+   };
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_GAP_BUFFER_HPP
@@ -0,0 +1,91 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_INTERN_TABLE_HPP
+#define LTCPP_LEXER_DETAIL_INTERN_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace ltcpp::detail_lexer {
+   /// \brief Hashes a spelling eight bytes at a time.
+   ///
+   std::uint64_t hash_spelling(std::string_view spelling) noexcept;
+
+   /// \brief Copies strings into large blocks that are never moved or freed until the arena is
+   ///        destroyed, so every view that it hands out stays valid for the arena's lifetime.
+   ///
+   class string_arena {
+   public:
+      /// \param upstream Supplies the blocks.
+      ///
+      explicit string_arena(std::pmr::memory_resource* const upstream = std::pmr::get_default_resource())
+         : blocks_{block_size, upstream}
+      {}
+
+      /// \brief Returns a view of a copy of s that lives as long as the arena.
+      ///
+      std::string_view copy(std::string_view s);
+   private:
+      static constexpr std::size_t block_size = 64 * 1024;
+
+      std::pmr::monotonic_buffer_resource blocks_;
+   };
+
+   /// \brief An open-addressing hash table from spellings to the ids they were interned as.
+   ///
+   /// Spellings aren't owned: each one must outlive the index. Slots are probed linearly, and the
+   /// table doubles in size whenever it becomes half full.
+   ///
+   class hash_index {
+   public:
+      /// \param memory Supplies the table's slots.
+      ///
+      explicit hash_index(std::pmr::memory_resource* const memory = std::pmr::get_default_resource())
+         noexcept
+         : slots_{memory}
+      {}
+
+      /// \brief Returns the id of spelling, if it's been inserted.
+      /// \param hash `hash_spelling(spelling)`
+      ///
+      std::optional<std::uint32_t> find(std::uint64_t hash, std::string_view spelling) const noexcept;
+
+      /// \brief Adds spelling with the given id.
+      /// \param hash `hash_spelling(spelling)`
+      /// \pre `not find(hash, spelling)`
+      ///
+      void insert(std::uint64_t hash, std::string_view spelling, std::uint32_t id);
+   private:
+      static constexpr auto empty = ~std::uint32_t{0};
+
+      struct slot {
+         std::string_view spelling;
+         std::uint32_t hash = 0;
+         std::uint32_t id = empty;
+      };
+
+      std::pmr::vector<slot> slots_;
+      std::size_t size_ = 0;
+
+      void grow();
+   };
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_INTERN_TABLE_HPP
@@ -0,0 +1,79 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_KEYWORDS_HPP
+#define LTCPP_LEXER_DETAIL_KEYWORDS_HPP
+
+#include "ltcpp/lexer/token.hpp"
+#include <array>
+#include <string_view>
+
+namespace ltcpp::detail_lexer {
+   /// \brief Pairs a reserved spelling with the token_kind that it's lexed as.
+   ///
+   struct keyword {
+      std::string_view spelling;
+      token_kind kind = token_kind::identifier;
+   };
+
+   /// \brief Every spelling that matches the identifier pattern but isn't lexed as an identifier.
+   ///
+   /// Adding a keyword only needs a line here: `identifier_kind` builds its lookup table from this
+   /// list at compile time.
+   ///
+   inline constexpr auto keywords = std::array{
+      keyword{"and", token_kind::and_},
+      keyword{"or", token_kind::or_},
+      keyword{"not", token_kind::not_},
+      keyword{"true", token_kind::boolean_literal},
+      keyword{"false", token_kind::boolean_literal},
+      keyword{"bool", token_kind::bool_},
+      keyword{"char8", token_kind::char8},
+      keyword{"float16", token_kind::float16},
+      keyword{"float32", token_kind::float32},
+      keyword{"float64", token_kind::float64},
+      keyword{"int8", token_kind::int8},
+      keyword{"int16", token_kind::int16},
+      keyword{"int32", token_kind::int32},
+      keyword{"int64", token_kind::int64},
+      keyword{"string", token_kind::string_},
+      keyword{"void", token_kind::void_},
+      keyword{"addressof", token_kind::addressof_},
+      keyword{"assert", token_kind::assert_},
+      keyword{"break", token_kind::break_},
+      keyword{"continue", token_kind::continue_},
+      keyword{"copy", token_kind::copy_},
+      keyword{"enum", token_kind::enum_},
+      keyword{"export", token_kind::export_},
+      keyword{"for", token_kind::for_},
+      keyword{"fun", token_kind::fun_},
+      keyword{"if", token_kind::if_},
+      keyword{"import", token_kind::import_},
+      keyword{"in", token_kind::in_},
+      keyword{"let", token_kind::let_},
+      keyword{"module", token_kind::module_},
+      keyword{"mutable", token_kind::mutable_},
+      keyword{"readable", token_kind::readable_},
+      keyword{"ref", token_kind::ref_},
+      keyword{"return", token_kind::return_},
+      keyword{"sizeof", token_kind::sizeof_},
+      keyword{"type", token_kind::type_},
+      keyword{"valueof", token_kind::valueof_},
+      keyword{"while", token_kind::while_},
+      keyword{"writable", token_kind::writable_},
+   };
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_KEYWORDS_HPP
@@ -0,0 +1,34 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_SCAN_DFA_HPP
+#define LTCPP_LEXER_DETAIL_SCAN_DFA_HPP
+
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <string_view>
+
+namespace ltcpp::detail_lexer {
+   /// \brief Scans the longest token at the front of in, using the DFA that's generated from the
+   ///        terminal rules of antlr-testing/lingua.g4 at build time.
+   ///
+   /// Whitespace and comments aren't terminals, and must be skipped beforehand. Spellings are
+   /// returned as written: string and character literals aren't unescaped. If no terminal matches,
+   /// a one-character unknown_token is produced.
+   ///
+   token scan_dfa(std::string_view& in, source_coordinate cursor) noexcept;
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_SCAN_DFA_HPP
@@ -19,9 +19,11 @@
 #include "ltcpp/lexer/token.hpp"
 #include "ltcpp/source_coordinate.hpp"
 #include <istream>
+#include <string_view>
 
 namespace ltcpp::detail_lexer {
    token scan_identifier(std::istream& in, source_coordinate cursor) noexcept;
+   token scan_identifier(std::string_view& in, source_coordinate cursor) noexcept;
 } // namespace ltcpp::detail_lexer
 
 #endif // LTCPP_LEXER_DETAIL_SCAN_IDENTIFIER_HPP
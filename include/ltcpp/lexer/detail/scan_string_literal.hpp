@@ -19,9 +19,14 @@
 #include "ltcpp/lexer/token.hpp"
 #include "ltcpp/source_coordinate.hpp"
 #include <istream>
+#include <string_view>
 
 namespace ltcpp::detail_lexer {
    token scan_string_literal(std::istream& in, source_coordinate cursor) noexcept;
+   token scan_string_literal(std::string_view& in, source_coordinate cursor) noexcept;
+
+   token scan_character_literal(std::istream& in, source_coordinate cursor) noexcept;
+   token scan_character_literal(std::string_view& in, source_coordinate cursor) noexcept;
 } // namespace ltcpp::detail_lexer
 
 #endif // LTCPP_LEXER_DETAIL_SCAN_STRING_LITERAL_HPP
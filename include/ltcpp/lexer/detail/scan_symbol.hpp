@@ -19,9 +19,11 @@
 #include "ltcpp/lexer/token.hpp"
 #include "ltcpp/source_coordinate.hpp"
 #include <istream>
+#include <string_view>
 
 namespace ltcpp::detail_lexer {
-   token scan_symbol(std::istream& in, char current, source_coordinate cursor) noexcept;
+   token scan_symbol(std::istream& in, source_coordinate cursor) noexcept;
+   token scan_symbol(std::string_view& in, source_coordinate cursor) noexcept;
 } // namespace ltcpp::detail_lexer
 
-#endif // LTCPP_LEXER_DETAIL_SCAN_STRING_SYMBOL_HPP
+#endif // LTCPP_LEXER_DETAIL_SCAN_SYMBOL_HPP
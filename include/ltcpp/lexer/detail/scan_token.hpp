@@ -0,0 +1,53 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_SCAN_TOKEN_HPP
+#define LTCPP_LEXER_DETAIL_SCAN_TOKEN_HPP
+
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <string_view>
+
+/// The pieces of `generate_token` that lexers which find token boundaries some other way share
+/// with it.
+///
+namespace ltcpp::detail_lexer {
+   /// \brief Scans the token that begins at `in.front()`.
+   /// \pre `in` doesn't begin with whitespace or a comment.
+   ///
+   token scan_token(std::string_view& in, source_coordinate cursor) noexcept;
+
+   /// \brief Returns true if tokens of this kind are reported as lexical errors.
+   ///
+   constexpr bool is_malformed(token_kind const kind) noexcept
+   {
+      return kind == token_kind::unknown_token
+          or kind == token_kind::unterminated_string_literal
+          or kind == token_kind::invalid_escape_sequence
+          or kind == token_kind::too_many_radix_points
+          or kind == token_kind::exponent_lacking_digit;
+   }
+
+   /// \brief Reports t if it's malformed, as though it began at where.
+   ///
+   void report_token_error(reporter& report, token const& t, source_coordinate where) noexcept;
+
+   /// \brief Reports a multi-line comment that begins at begin and is never closed.
+   ///
+   void report_unterminated_comment(reporter& report, source_coordinate begin) noexcept;
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_SCAN_TOKEN_HPP
@@ -16,10 +16,14 @@
 #ifndef LTCPP_LEXER_DETAIL_SCAN_WHITESPACE_HPP
 #define LTCPP_LEXER_DETAIL_SCAN_WHITESPACE_HPP
 
+#include "ltcpp/lexer/lexer_state.hpp"
 #include "ltcpp/lexer/token.hpp"
 #include "ltcpp/source_coordinate.hpp"
 #include "ltcpp/source_coordinate_range.hpp"
 #include <istream>
+#include <optional>
+#include <string_view>
+#include <tl/expected.hpp>
 #include <utility>
 
 namespace ltcpp::detail_lexer {
@@ -43,6 +47,28 @@ namespace ltcpp::detail_lexer {
 
    tl::expected<source_coordinate, unterminated_comment_error>
    scan_whitespace_like(std::istream& in, source_coordinate cursor) noexcept;
+
+   tl::expected<source_coordinate, unterminated_comment_error>
+   scan_whitespace_like(std::string_view& in, source_coordinate cursor) noexcept;
+
+   /// \brief Skips whitespace and comments without working out where they end.
+   /// \returns The multi-line comment that in ends inside of, if it isn't closed.
+   ///
+   std::optional<std::string_view> skip_whitespace_like(std::string_view& in) noexcept;
+
+   /// \brief Skips whitespace and comments from where state left off, which may be inside a
+   ///        comment, updating state to match.
+   ///
+   /// When end_of_source is false, in might stop part way through the source, so no character is
+   /// consumed until the one after it (which can turn "*" into "*/", or "\n" into "\n\r") has been
+   /// seen.
+   ///
+   /// \returns true if `in` now begins with a token, or is empty and the source has ended; false
+   ///          if more of the source is needed; or an error if the source ended inside a "/*"
+   ///          comment, in which case it's all been consumed.
+   ///
+   tl::expected<bool, unterminated_comment_error>
+   resume_whitespace_like(std::string_view& in, lexer_state& state, bool end_of_source) noexcept;
 } // namespace ltcpp::detail_lexer
 
 #endif // LTCPP_LEXER_DETAIL_SCAN_WHITESPACE_HPP
@@ -0,0 +1,108 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_SIMD_HPP
+#define LTCPP_LEXER_DETAIL_SIMD_HPP
+
+#include "ltcpp/source_coordinate.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/// Bulk scanning kernels for contiguous input.
+///
+/// Each kernel is implemented for AVX2, SSE2, and portable scalar code. The widest instruction set
+/// that the running processor supports is chosen the first time any kernel is called; all three
+/// produce identical results.
+///
+namespace ltcpp::detail_lexer::simd {
+   /// \brief Identifies an implementation of the kernels.
+   ///
+   enum class instruction_set { scalar, sse2, avx2 };
+
+   /// \brief Returns the instruction set that the kernels dispatch to on this processor.
+   ///
+   instruction_set selected_instruction_set() noexcept;
+
+   /// \brief Returns the length of the longest prefix of text that consists only of ' ' and '\t'.
+   ///
+   std::size_t count_blanks(std::string_view text) noexcept;
+
+   /// \brief Returns the length of the longest prefix of text that consists only of letters, digits,
+   ///        and '_'.
+   ///
+   std::size_t count_identifier_tail(std::string_view text) noexcept;
+
+   /// \brief Returns the offset of the first '\n', '\r', or '\f' in text, or `text.size()` if
+   ///        there is none.
+   ///
+   std::size_t find_line_break(std::string_view text) noexcept;
+
+   /// \brief Appends the offset at which each line of text after the first begins.
+   ///
+   /// '\n', '\r\n', '\n\r', and '\f' each end a line, so a line begins just after one of them; a
+   /// '\r' on its own doesn't.
+   ///
+   void append_line_starts(std::string_view text, std::pmr::vector<std::uint32_t>& starts);
+
+   /// \brief Describes a prefix of a block comment's body that was skipped in bulk.
+   ///
+   struct skipped_text {
+      /// The number of characters skipped.
+      std::size_t size;
+
+      /// How far the skipped characters move a cursor, for use with `source_coordinate::shift`.
+      source_coordinate distance;
+   };
+
+   /// \brief Skips the longest prefix of text that a block comment scanner can step over without
+   ///        examining each character.
+   ///
+   /// The prefix stops before the first '*', '\r', or '\f', and before any '\n' that might be
+   /// followed by '\r', so the character at `size` (if any) is left for the scalar scanner. Every
+   /// '\n' in the prefix ends a line.
+   ///
+   skipped_text skip_block_comment_text(std::string_view text) noexcept;
+
+   /// \brief The characters of a 64-byte block that decide where tokens can begin, as bitmasks
+   ///        with bit i describing the block's ith character.
+   ///
+   struct character_masks {
+      /// ' ', '\t', '\n', '\r', and '\f'.
+      std::uint64_t blank;
+
+      /// '\n', '\r', and '\f'.
+      std::uint64_t line_break;
+
+      std::uint64_t quote;
+      std::uint64_t apostrophe;
+      std::uint64_t backslash;
+      std::uint64_t slash;
+      std::uint64_t star;
+   };
+
+   /// \brief Classifies each 64-byte block of text.
+   ///
+   /// The final block is padded with blanks.
+   ///
+   /// \pre `masks.size() == (text.size() + 63) / 64`
+   ///
+   void classify_blocks(std::string_view text, std::span<character_masks> masks) noexcept;
+} // namespace ltcpp::detail_lexer::simd
+
+#endif // LTCPP_LEXER_DETAIL_SIMD_HPP
@@ -0,0 +1,121 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_SPSC_RING_HPP
+#define LTCPP_LEXER_DETAIL_SPSC_RING_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace ltcpp::detail_lexer {
+   /// \brief The distance that keeps two threads' variables off each other's cache lines.
+   ///
+   /// std::hardware_destructive_interference_size would do, but its value can change with
+   /// compiler flags, which makes it unsafe to use in a header.
+   ///
+   inline constexpr std::size_t cache_line_size = 64;
+
+   /// \brief A fixed-capacity, lock-free queue between exactly one producer thread and one
+   ///        consumer thread.
+   ///
+   /// Slots are filled and read in place and are reused as the queue wraps around, so a T that
+   /// holds on to its storage (such as a std::vector that's cleared rather than destroyed) costs no
+   /// allocations once the queue has gone round once. Each side's index is on a cache line of its
+   /// own, along with that side's last sight of the other's, so the two threads only share a line
+   /// when one of them has caught up with the other. A side that has caught up waits on the other's
+   /// index with std::atomic::wait rather than spinning.
+   ///
+   template<class T>
+   class spsc_ring {
+   public:
+      /// \pre `capacity > 0`
+      ///
+      explicit spsc_ring(std::size_t const capacity)
+         : slots_(capacity)
+      { assert(capacity > 0); }
+
+      /// \brief Returns the slot that the producer fills next, waiting while every slot is full.
+      ///
+      T& claim() noexcept
+      {
+         auto const tail = producer_.index.load(std::memory_order_relaxed);
+         while (tail - producer_.other == slots_.size()) {
+            producer_.other = consumer_.index.load(std::memory_order_acquire);
+            if (tail - producer_.other == slots_.size()) {
+               consumer_.index.wait(producer_.other, std::memory_order_acquire);
+            }
+         }
+         return slots_[tail % slots_.size()];
+      }
+
+      /// \brief Hands the claimed slot to the consumer.
+      ///
+      void publish() noexcept
+      {
+         producer_.index.fetch_add(1, std::memory_order_release);
+         producer_.index.notify_one();
+      }
+
+      /// \brief Returns the slot that the consumer reads next, waiting while every slot is empty.
+      ///
+      T& front() noexcept
+      {
+         auto const head = consumer_.index.load(std::memory_order_relaxed);
+         while (consumer_.other == head) {
+            consumer_.other = producer_.index.load(std::memory_order_acquire);
+            if (consumer_.other == head) {
+               producer_.index.wait(head, std::memory_order_acquire);
+            }
+         }
+         return slots_[head % slots_.size()];
+      }
+
+      /// \brief Returns the slot that the consumer reads next, or nullptr if every slot is empty.
+      ///
+      T* try_front() noexcept
+      {
+         auto const head = consumer_.index.load(std::memory_order_relaxed);
+         if (consumer_.other == head) {
+            consumer_.other = producer_.index.load(std::memory_order_acquire);
+         }
+         return consumer_.other == head ? nullptr : &slots_[head % slots_.size()];
+      }
+
+      /// \brief Hands the front slot back to the producer.
+      /// \pre The consumer has a front slot.
+      ///
+      void pop() noexcept
+      {
+         consumer_.index.fetch_add(1, std::memory_order_release);
+         consumer_.index.notify_one();
+      }
+   private:
+      struct alignas(cache_line_size) side {
+         /// How many slots this side has finished with. Only this side writes it.
+         std::atomic<std::size_t> index = 0;
+
+         /// The other side's index, as of when this side last looked.
+         std::size_t other = 0;
+      };
+
+      std::vector<T> slots_;
+      side producer_;
+      side consumer_;
+   };
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_SPSC_RING_HPP
@@ -0,0 +1,58 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_DETAIL_STRUCTURAL_INDEX_HPP
+#define LTCPP_LEXER_DETAIL_STRUCTURAL_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace ltcpp::detail_lexer {
+   /// \brief Marks every character of a source that a token might begin at, so that a lexer can
+   ///        jump over whitespace and comments rather than scanning them.
+   ///
+   /// The index is built a 64-byte block at a time. Each block is classified with vector compares,
+   /// and where it has no comment, character literal, or stray backslash, which string literals it
+   /// lies in is worked out from its quotes and backslashes with a handful of bitwise operations.
+   /// The remaining blocks are walked one interesting character at a time.
+   ///
+   /// Every non-blank character outside a comment is marked, including the ones inside tokens, so
+   /// `next_token_start` is only meaningful at offsets where a token has just ended.
+   ///
+   class structural_index {
+   public:
+      explicit structural_index(std::string_view source);
+
+      /// \brief Returns the offset of the first marked character at or after offset, or the size
+      ///        of the source if there isn't one.
+      ///
+      std::size_t next_token_start(std::size_t offset) const noexcept;
+
+      /// \brief Returns the offset of the "/*" that opens a comment which is never closed, if
+      ///        there is one.
+      ///
+      std::optional<std::size_t> unterminated_comment() const noexcept
+      { return unterminated_comment_; }
+   private:
+      std::size_t size_;
+      std::vector<std::uint64_t> starts_;
+      std::optional<std::size_t> unterminated_comment_;
+   };
+} // namespace ltcpp::detail_lexer
+
+#endif // LTCPP_LEXER_DETAIL_STRUCTURAL_INDEX_HPP
@@ -0,0 +1,123 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_INTERNER_HPP
+#define LTCPP_LEXER_INTERNER_HPP
+
+#include "ltcpp/lexer/detail/intern_table.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace ltcpp {
+   /// \brief Names a spelling that's been interned. Two symbols from the same interner are equal
+   ///        exactly when their spellings are.
+   ///
+   enum class symbol : std::uint32_t {};
+
+   /// \brief Maps spellings, such as identifiers, to dense symbol ids.
+   ///
+   /// The first spelling interned is `symbol{0}`, the next `symbol{1}`, and so on. Each distinct
+   /// spelling is stored once, in an arena, so the views that `spelling` returns stay valid for as
+   /// long as the interner does.
+   ///
+   class interner {
+   public:
+      /// \param memory Supplies the spellings and the tables that index them.
+      ///
+      explicit interner(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+      /// \brief Returns the symbol for spelling, adding it if it's new.
+      ///
+      symbol intern(std::string_view spelling);
+
+      /// \brief Returns the symbol for spelling, if it's been interned.
+      ///
+      std::optional<symbol> find(std::string_view spelling) const noexcept;
+
+      /// \pre s was returned by this interner.
+      ///
+      std::string_view spelling(symbol const s) const noexcept
+      { return spellings_[static_cast<std::size_t>(s)]; }
+
+      /// \brief Returns the number of distinct spellings that have been interned.
+      ///
+      std::size_t size() const noexcept
+      { return spellings_.size(); }
+   private:
+      detail_lexer::string_arena arena_;
+      detail_lexer::hash_index index_;
+      std::pmr::vector<std::string_view> spellings_;
+   };
+
+   /// \brief An interner that several threads can use at once.
+   ///
+   /// Spellings are spread over independently locked shards by hash, so threads only contend when
+   /// they intern spellings that land in the same shard. Symbols come from one counter, so they're
+   /// dense across the whole table, just like an interner's.
+   ///
+   class concurrent_interner {
+   public:
+      concurrent_interner() = default;
+      concurrent_interner(concurrent_interner const&) = delete;
+      concurrent_interner& operator=(concurrent_interner const&) = delete;
+      ~concurrent_interner();
+
+      /// \brief Returns the symbol for spelling, adding it if it's new. Safe to call concurrently.
+      ///
+      symbol intern(std::string_view spelling);
+
+      /// \brief Returns the symbol for spelling, if it's been interned. Safe to call concurrently.
+      ///
+      std::optional<symbol> find(std::string_view spelling) const;
+
+      /// \pre s was returned by `intern` or `find` on this interner, and that call happens before
+      ///      this one.
+      ///
+      std::string_view spelling(symbol s) const noexcept;
+
+      /// \brief Returns the number of distinct spellings that have been interned so far.
+      ///
+      std::size_t size() const noexcept
+      { return next_.load(std::memory_order_relaxed); }
+   private:
+      static constexpr std::size_t shard_bits = 6;
+
+      struct shard {
+         mutable std::mutex mutex;
+         detail_lexer::string_arena arena;
+         detail_lexer::hash_index index;
+      };
+
+      std::array<shard, std::size_t{1} << shard_bits> shards_;
+      std::atomic<std::uint32_t> next_ = 0;
+
+      // Symbol i's spelling is found in a segment of a directory that grows without moving: each
+      // segment is twice the size of the one before it, so 23 of them cover every 32-bit symbol.
+      static constexpr std::size_t first_segment_size = 1024;
+      static constexpr std::size_t segment_count = 23;
+      mutable std::array<std::atomic<std::string_view*>, segment_count> segments_ = {};
+
+      std::string_view& entry(std::uint32_t id) const;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_INTERNER_HPP
@@ -16,7 +16,12 @@
 #ifndef LTCPP_LEXER_LEXER_HPP
 #define LTCPP_LEXER_LEXER_HPP
 
+#include <concepts>
 #include <istream>
+#include <optional>
+#include <string_view>
+#include "ltcpp/lexer/chunked_source.hpp"
+#include "ltcpp/lexer/lexer_state.hpp"
 #include "ltcpp/lexer/token.hpp"
 #include "ltcpp/reporter.hpp"
 #include "ltcpp/source_coordinate.hpp"
@@ -31,6 +36,51 @@ namespace ltcpp {
    ///
    token
    generate_token(std::istream& in, reporter& report, source_coordinate cursor) noexcept(false);
+
+   /// \brief Scans the next token from a contiguous buffer.
+   /// \param in The unscanned portion of the source. On return, `in` has been advanced past the
+   ///           token and any whitespace or comments that preceded it.
+   /// \param report Receives any lexical diagnostics.
+   /// \param cursor The position of `in.front()` in the source.
+   /// \returns The same token that the std::istream overload produces for the same characters. Its
+   ///          spelling is a view of the buffer rather than a copy, so the buffer must outlive it.
+   ///
+   token generate_token(std::string_view& in, reporter& report, source_coordinate cursor) noexcept;
+
+   /// \brief Scans the next token from part of a source, carrying on from where an earlier call
+   ///        left off.
+   /// \param in The source from `state.offset` on, or as much of it as is available. On return,
+   ///           `in` has been advanced past whatever was consumed.
+   /// \param state Where lexing left off, which may be part way through a comment. On return, it
+   ///              describes where lexing has got to.
+   /// \param report Receives any lexical diagnostics, each exactly once.
+   /// \param end_of_source Whether `in` ends where the source does.
+   /// \returns The same token that the std::string_view overload produces, or std::nullopt if more
+   ///          of the source is needed first. Lexing can then be restarted from a copy of `state`,
+   ///          given the source from `state.offset` on.
+   ///
+   std::optional<token> generate_token(std::string_view& in, lexer_state& state, reporter& report,
+      bool end_of_source = true) noexcept;
+
+   /// \brief Scans the next token from a file descriptor without holding the whole source in
+   ///        memory.
+   /// \param in The source. It is refilled as needed, and on return the token and any whitespace
+   ///           or comments that preceded it have been consumed.
+   /// \param report Receives any lexical diagnostics.
+   /// \param cursor The position of `in.unscanned().front()` in the source.
+   /// \returns The same token that the std::string_view overload produces for the same characters,
+   ///          regardless of where chunk boundaries fall.
+   /// \throws std::system_error if reading from the underlying file descriptor fails.
+   ///
+   token
+   generate_token(chunked_source& in, reporter& report, source_coordinate cursor) noexcept(false);
+
+   /// \brief A source that `generate_token` lexes a token at a time.
+   ///
+   template<class Input>
+   concept token_input = requires(Input& in, reporter& report, source_coordinate const cursor) {
+      { generate_token(in, report, cursor) } -> std::same_as<token>;
+   };
 } // namespace ltcpp
 
 #endif // LTCPP_LEXER_LEXER_HPP
@@ -0,0 +1,67 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_LEXER_POLICY_HPP
+#define LTCPP_LEXER_LEXER_POLICY_HPP
+
+#include <concepts>
+
+namespace ltcpp {
+   /// \brief Chooses, at compile time, which parts of its work `lex` does.
+   ///
+   /// A policy is a type with a `static constexpr bool` member for each part:
+   ///
+   /// * `positions`: whether tokens are given their positions. Without them, whitespace and
+   ///   comments are skipped without counting lines and columns.
+   /// * `trivia`: whether the whitespace and comments between tokens are visited too.
+   /// * `diagnostics`: whether lexical errors are reported. They're reported at their positions,
+   ///   so this needs `positions`.
+   ///
+   /// The easiest way to write one is to derive from `default_lexer_policy` and hide the members
+   /// that differ.
+   ///
+   template<class Policy>
+   concept lexer_policy = requires {
+      { Policy::positions } -> std::convertible_to<bool>;
+      { Policy::trivia } -> std::convertible_to<bool>;
+      { Policy::diagnostics } -> std::convertible_to<bool>;
+      requires Policy::positions or not Policy::diagnostics;
+   };
+
+   /// \brief Does everything that `generate_token` does, and nothing more.
+   ///
+   struct default_lexer_policy {
+      static constexpr bool positions = true;
+      static constexpr bool trivia = false;
+      static constexpr bool diagnostics = true;
+   };
+
+   /// \brief Does everything that `generate_token` does, but leaves lexical errors to the caller
+   ///        rather than reporting them.
+   ///
+   struct unreported_lexer_policy : default_lexer_policy {
+      static constexpr bool diagnostics = false;
+   };
+
+   /// \brief Identifies a visit to the whitespace and comments between two tokens.
+   ///
+   struct trivia_t {
+      explicit trivia_t() = default;
+   };
+
+   inline constexpr auto trivia = trivia_t{};
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_LEXER_POLICY_HPP
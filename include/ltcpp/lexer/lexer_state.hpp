@@ -0,0 +1,66 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_LEXER_STATE_HPP
+#define LTCPP_LEXER_LEXER_STATE_HPP
+
+#include "ltcpp/source_coordinate.hpp"
+#include <cstdint>
+#include <type_traits>
+
+namespace ltcpp {
+   /// \brief What a lexer was doing when it stopped.
+   ///
+   enum class lexer_mode : std::uint8_t {
+      /// Skipping whitespace before the next token, or about to scan it.
+      between_tokens,
+
+      /// Skipping the rest of a "//" comment.
+      in_line_comment,
+
+      /// Skipping the rest of a "/*" comment.
+      in_block_comment,
+   };
+
+   /// \brief Everything that a lexer needs to carry on from part way through a source.
+   ///
+   /// A lexer_state refers to nothing and is trivially copyable, so it can be snapshotted as often
+   /// as is useful, handed to another thread, or written to disk, and lexing restarted from it
+   /// given only the source from `offset` on.
+   ///
+   /// Comments can be arbitrarily long, so a lexer that runs out of input part way through one
+   /// stops inside it. It stops before any other token that it can't finish, since tokens (string
+   /// literals included) never span lines.
+   ///
+   struct lexer_state {
+      /// The number of characters consumed from the beginning of the source.
+      std::uint64_t offset = 0;
+
+      /// The coordinate of the character at `offset`.
+      source_coordinate cursor = source_coordinate{};
+
+      /// Where the comment being skipped began, if `mode` is `lexer_mode::in_block_comment`, so
+      /// that it can be reported if it's never closed.
+      source_coordinate comment_begin = source_coordinate{};
+
+      lexer_mode mode = lexer_mode::between_tokens;
+
+      friend constexpr bool operator==(lexer_state const&, lexer_state const&) noexcept = default;
+   };
+
+   static_assert(std::is_trivially_copyable_v<lexer_state>);
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_LEXER_STATE_HPP
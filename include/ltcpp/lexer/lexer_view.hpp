@@ -0,0 +1,190 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_LEXER_VIEW_HPP
+#define LTCPP_LEXER_LEXER_VIEW_HPP
+
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+
+namespace ltcpp {
+   /// \brief The tokens of a source, lexed lazily, as a single-pass range that ends after the eof
+   ///        token.
+   ///
+   /// The view keeps a ring of `Capacity` tokens that a parser can look ahead into with `peek`
+   /// without lexing anything twice. Tokens are lexed into the ring's slots as they're needed, and
+   /// each slot is reused once its token has been consumed, so iterating allocates nothing per
+   /// token beyond what `generate_token` does: nothing for a std::string_view source, whose tokens
+   /// borrow their spellings, and only spellings too long for a std::string's own buffer for the
+   /// others.
+   ///
+   /// Like `std::ranges::basic_istream_view`, the view's iterators refer to it, so they're
+   /// invalidated if it's moved.
+   ///
+   template<token_input Input, std::size_t Capacity = 4>
+   requires (Capacity > 0)
+   class lexer_view : public std::ranges::view_interface<lexer_view<Input, Capacity>> {
+      /// A std::string_view is advanced in place, so the view keeps its own copy; anything else is
+      /// referred to.
+      ///
+      static constexpr bool owns_input = std::same_as<Input, std::string_view>;
+      using input_type = std::conditional_t<owns_input, std::string_view, Input&>;
+   public:
+      /// \brief The most tokens that `peek` can look ahead by, counting the next one.
+      ///
+      static constexpr std::size_t capacity = Capacity;
+
+      /// \param in The source. If it's a std::string_view, the characters that it refers to must
+      ///           outlive the tokens; otherwise, in must outlive the view.
+      /// \param report Receives any lexical diagnostics, as tokens are lexed.
+      /// \param cursor The position of the first character of in.
+      ///
+      lexer_view(input_type in, reporter& report, source_coordinate const cursor = source_coordinate{})
+         : in_{in}
+         , report_{&report}
+         , cursor_{cursor}
+      {}
+
+      class iterator {
+      public:
+         using value_type = token;
+         using difference_type = std::ptrdiff_t;
+
+         iterator() = default;
+
+         token const& operator*() const noexcept(false)
+         { return view_->peek(); }
+
+         token const* operator->() const noexcept(false)
+         { return &view_->peek(); }
+
+         iterator& operator++() noexcept(false)
+         {
+            view_->consume();
+            return *this;
+         }
+
+         void operator++(int) noexcept(false)
+         { ++*this; }
+
+         friend bool operator==(iterator const& i, std::default_sentinel_t) noexcept
+         { return i.at_end(); }
+      private:
+         lexer_view* view_ = nullptr;
+
+         bool at_end() const noexcept
+         { return view_->done_; }
+
+         explicit iterator(lexer_view& view) noexcept
+            : view_{&view}
+         {}
+
+         friend class lexer_view;
+      };
+
+      iterator begin() noexcept
+      { return iterator{*this}; }
+
+      std::default_sentinel_t end() const noexcept
+      { return std::default_sentinel; }
+
+      /// \brief Returns the token k places after the next one, lexing up to it if need be.
+      ///
+      /// Looking past the eof token returns the eof token.
+      ///
+      /// \pre `k < capacity`
+      ///
+      token const& peek(std::size_t const k = 0) noexcept(false)
+      {
+         assert(k < Capacity);
+         fill(k);
+         return *slots_[slot(std::min(k, size_ - 1))];
+      }
+
+      /// \brief Moves past the next token. Once that's the eof token, the range has ended.
+      ///
+      void consume() noexcept(false)
+      {
+         fill(0);
+         if (slots_[head_]->kind() == token_kind::eof) {
+            done_ = true;
+            return;
+         }
+         head_ = slot(1);
+         --size_;
+      }
+   private:
+      std::conditional_t<owns_input, std::string_view, std::reference_wrapper<Input>> in_;
+      reporter* report_;
+      source_coordinate cursor_;
+
+      std::array<std::optional<token>, Capacity> slots_{};
+      std::size_t head_ = 0;
+      std::size_t size_ = 0;
+      bool eof_lexed_ = false;
+      bool done_ = false;
+
+      std::size_t slot(std::size_t const k) const noexcept
+      { return (head_ + k) % Capacity; }
+
+      Input& input() noexcept
+      {
+         if constexpr (owns_input) {
+            return in_;
+         }
+         else {
+            return in_.get();
+         }
+      }
+
+      /// Lexes tokens until the kth is in the ring, or the eof token is.
+      ///
+      void fill(std::size_t const k) noexcept(false)
+      {
+         for (; size_ <= k and not eof_lexed_; ++size_) {
+            auto& next = slots_[slot(size_)];
+            next = generate_token(input(), *report_, cursor_);
+            cursor_ = next->position().end();
+            eof_lexed_ = next->kind() == token_kind::eof;
+         }
+      }
+   };
+
+   template<class Input>
+   requires token_input<Input>
+   lexer_view(Input&, reporter&) -> lexer_view<Input>;
+
+   template<class Input>
+   requires token_input<Input>
+   lexer_view(Input&, reporter&, source_coordinate) -> lexer_view<Input>;
+
+   lexer_view(std::string_view, reporter&) -> lexer_view<std::string_view>;
+   lexer_view(std::string_view, reporter&, source_coordinate) -> lexer_view<std::string_view>;
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_LEXER_VIEW_HPP
@@ -17,16 +17,25 @@
 #define LTCPP_LEXER_TOKEN_HPP
 
 #include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 
 namespace ltcpp {
-   enum class token_kind {
+   enum class token_kind : std::uint8_t {
       // arithmetic
       plus,
       minus,
+      increment,
+      decrement,
       times,
       divide,
       modulo,
@@ -58,6 +67,7 @@ namespace ltcpp {
       // literals
       integral_literal,
       boolean_literal,
+      character_literal,
       floating_literal,
       string_literal,
       // type specifiers
@@ -70,21 +80,30 @@ namespace ltcpp {
       int16,
       int32,
       int64,
+      string_,
       void_,
       // keywords
+      addressof_,
       assert_,
       break_,
       continue_,
+      copy_,
+      enum_,
+      export_,
       for_,
       fun_,
       if_,
       import_,
+      in_,
       let_,
       module_,
       mutable_,
       readable_,
       ref_,
       return_,
+      sizeof_,
+      type_,
+      valueof_,
       while_,
       writable_,
       // other
@@ -108,6 +127,10 @@ namespace ltcpp {
          return o << "+";
       case token_kind::minus:
          return o << "-";
+      case token_kind::increment:
+         return o << "++";
+      case token_kind::decrement:
+         return o << "--";
       case token_kind::times:
          return o << "*";
       case token_kind::divide:
@@ -160,6 +183,8 @@ namespace ltcpp {
          return o << "integral literal";
       case token_kind::boolean_literal:
          return o << "boolean literal";
+      case token_kind::character_literal:
+         return o << "character literal";
       case token_kind::floating_literal:
          return o << "floating-point literal";
       case token_kind::string_literal:
@@ -182,14 +207,24 @@ namespace ltcpp {
          return o << "int32";
       case token_kind::int64:
          return o << "int64";
+      case token_kind::string_:
+         return o << "string";
       case token_kind::void_:
          return o << "void";
+      case token_kind::addressof_:
+         return o << "addressof";
       case token_kind::assert_:
          return o << "assert";
       case token_kind::break_:
          return o << "break";
       case token_kind::continue_:
          return o << "continue";
+      case token_kind::copy_:
+         return o << "copy";
+      case token_kind::enum_:
+         return o << "enum";
+      case token_kind::export_:
+         return o << "export";
       case token_kind::for_:
          return o << "for";
       case token_kind::fun_:
@@ -198,6 +233,8 @@ namespace ltcpp {
          return o << "if";
       case token_kind::import_:
          return o << "import";
+      case token_kind::in_:
+         return o << "in";
       case token_kind::let_:
          return o << "let";
       case token_kind::module_:
@@ -210,6 +247,12 @@ namespace ltcpp {
          return o << "ref";
       case token_kind::return_:
          return o << "return";
+      case token_kind::sizeof_:
+         return o << "sizeof";
+      case token_kind::type_:
+         return o << "type";
+      case token_kind::valueof_:
+         return o << "valueof";
       case token_kind::while_:
          return o << "while";
       case token_kind::writable_:
@@ -235,43 +278,163 @@ namespace ltcpp {
       }
    }
 
+   /// \brief Selects the token constructor that refers to a spelling in place instead of copying
+   ///        it.
+   ///
+   struct borrowed_spelling_t {
+      explicit borrowed_spelling_t() = default;
+   };
+
+   inline constexpr auto borrowed_spelling = borrowed_spelling_t{};
+
+   /// \brief The spelling of every eof token.
+   ///
+   /// Nothing in the source spells the eof token, so every eof token borrows this one. It views an
+   /// inline array rather than a string literal, since identical literals in different translation
+   /// units needn't share an address.
+   ///
+   inline constexpr char eof_characters[] = "$";
+   inline constexpr auto eof_spelling = std::string_view{eof_characters, 1};
+
    class [[nodiscard]] token {
    public:
-      token(token_kind const kind, std::string spelling, source_coordinate begin,
+      token(token_kind const kind, std::string const& spelling, source_coordinate begin,
          source_coordinate end)
+         : token{borrowed_spelling, kind, spelling, begin, end}
+      { own_spelling(); }
+
+      /// \brief Constructs a token whose spelling is a view of characters that it doesn't own,
+      ///        usually the source buffer that it was scanned from.
+      /// \pre The characters that spelling refers to outlive the token.
+      ///
+      token(borrowed_spelling_t, token_kind const kind, std::string_view const spelling,
+         source_coordinate begin, source_coordinate end) noexcept
          : kind_{kind}
-         , spelling_{std::move(spelling)}
+         , spelling_{spelling}
          , position_{begin, end}
       {}
 
+      /// \brief Copies other, along with its spelling if it owns one.
+      ///
+      token(token const& other)
+         : kind_{other.kind_}
+         , has_value_{other.has_value_}
+         , value_{other.value_}
+         , spelling_{other.spelling_}
+         , position_{other.position_}
+      {
+         if (other.owned_spelling_) {
+            own_spelling();
+         }
+      }
+
+      token(token&&) noexcept = default;
+
+      token& operator=(token const& other)
+      { return *this = token{other}; }
+
+      token& operator=(token&&) noexcept = default;
+
+      ~token() = default;
+
       token_kind kind() const noexcept
       { return kind_; }
 
+      /// \brief Returns the characters that the token was scanned from, exactly as written.
+      ///
       std::string_view spelling() const noexcept
       { return spelling_; }
 
+      /// \brief Returns the spelling with every escape sequence replaced by the character it
+      ///        denotes. Sequences that aren't valid escapes are left as they were written.
+      ///
+      /// Only string and character literals contain escapes, so they're decoded here, on demand,
+      /// rather than while scanning.
+      ///
+      std::string decoded_spelling() const;
+
+      /// \brief Returns the decoded spelling in storage from memory.
+      ///
+      std::pmr::string decoded_spelling(std::pmr::memory_resource* memory) const;
+
       source_coordinate_range position() const noexcept
       { return position_; }
 
+      /// \brief Returns the value of an integral literal, or `std::nullopt` if the token isn't a
+      ///        decoded integral literal or its value doesn't fit in 64 bits.
+      ///
+      std::optional<std::uint64_t> integral_value() const noexcept
+      {
+         return kind_ == token_kind::integral_literal and has_value_
+              ? std::optional{value_}
+              : std::nullopt;
+      }
+
+      /// \brief Returns the double nearest to a floating-point literal, or `std::nullopt` if the
+      ///        token isn't a decoded floating-point literal or a double can't represent it.
+      ///
+      std::optional<double> floating_value() const noexcept
+      {
+         return kind_ == token_kind::floating_literal and has_value_
+              ? std::optional{std::bit_cast<double>(value_)}
+              : std::nullopt;
+      }
+
+      /// \brief Decodes the value that a numeric literal is spelled with and keeps it alongside
+      ///        the token, so that nothing downstream needs to parse the spelling again. Does
+      ///        nothing to other tokens.
+      ///
+      /// The lexer leaves values undecoded, so only the literals whose values are wanted pay for
+      /// decoding them.
+      ///
+      void decode_value() noexcept;
+
+      /// \brief Copies a borrowed spelling into the token, so that it no longer refers to the
+      ///        characters that it was scanned from.
+      ///
+      void own_spelling();
+
       friend bool operator==(token const& a, token const& b) noexcept
       {
-         return std::tie(a.kind_, a.spelling_, a.cursor_range_)
-             == std::tie(b.kind_, b.spelling_, b.cursor_range_);
+         return std::tuple{a.kind_, a.spelling(), a.position_}
+             == std::tuple{b.kind_, b.spelling(), b.position_};
       }
 
       friend std::ostream& operator<<(std::ostream& o, token const& t) noexcept
       {
          return o << '[' << static_cast<int>(t.kind()) << ", \"" << t.spelling() << "\", " <<
-            t.cursor_range().begin() << ".." << t.cursor_range().end() << ']';
+            t.position().begin() << ".." << t.position().end() << ']';
       }
    private:
       token_kind kind_;
-      std::string spelling_;
+      bool has_value_ = false;
+      std::uint64_t value_ = 0;
+
+      // A view of the characters the token was scanned from, or, once `own_spelling` has been
+      // called, of owned_spelling_. The buffer is on the heap, so moving the token doesn't move it.
+      std::string_view spelling_;
+      std::unique_ptr<char[]> owned_spelling_;
       source_coordinate_range position_;
+
+      // token_buffer and cached_token_buffer store decoded values apart from the tokens and
+      // restore them.
+      friend class token_buffer;
+      friend class cached_token_buffer;
    };
 
+   /// \brief Returns the keyword, type-specifier, logical-operator, or boolean-literal kind that
+   ///        spelling names, or `token_kind::identifier` if it names none of them.
+   ///
+   token_kind identifier_kind(std::string_view spelling) noexcept;
+
    token make_token(std::string lexeme, source_coordinate cursor_begin) noexcept;
    token make_token(std::string lexeme, source_coordinate cursor_begin, token_kind kind) noexcept;
+
+   /// \brief Makes a token that refers to lexeme rather than copying it.
+   /// \pre The characters that lexeme refers to outlive the token.
+   ///
+   token make_token(borrowed_spelling_t, std::string_view lexeme, source_coordinate cursor_begin,
+      token_kind kind) noexcept;
 } // namespace ltcpp
 
 #endif // LTCPP_LEXER_TOKEN_HPP
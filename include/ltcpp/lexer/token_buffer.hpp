@@ -0,0 +1,264 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_TOKEN_BUFFER_HPP
+#define LTCPP_LEXER_TOKEN_BUFFER_HPP
+
+#include "ltcpp/lexer/detail/gap_buffer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/line_table.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+#include "ltcpp/source_location.hpp"
+#include "ltcpp/text_edit.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+
+namespace ltcpp {
+   /// \brief Asks for a token_buffer to be lexed by several threads at once.
+   ///
+   struct parallel_lexing {
+      /// The most threads to split the source between.
+      std::size_t threads = std::thread::hardware_concurrency();
+
+      /// The fewest characters that are worth giving a thread of their own.
+      std::size_t minimum_chunk_size = std::size_t{1} << 20;
+   };
+
+   /// \brief Asks for a token_buffer to be lexed in two passes: one that finds where tokens can
+   ///        begin, and one that scans only from there.
+   ///
+   struct two_stage_lexing_t {
+      explicit two_stage_lexing_t() = default;
+   };
+
+   inline constexpr auto two_stage_lexing = two_stage_lexing_t{};
+
+   /// \brief Describes which tokens `token_buffer::edit` replaced: `removed` tokens from the
+   ///        `first` on were replaced by `inserted` new ones.
+   ///
+   struct token_edit {
+      std::size_t first;
+      std::size_t removed;
+      std::size_t inserted;
+
+      friend constexpr bool operator==(token_edit, token_edit) noexcept = default;
+   };
+
+   /// \brief Every token in a source file, stored as parallel arrays.
+   ///
+   /// Each token costs one byte for its kind and four each for its offset and length in the
+   /// source, so a parser can walk the kinds densely and look at spellings and positions only when
+   /// it needs them. Both are rebuilt on demand: spellings are views of the source, and positions
+   /// come from the file's line_table. The values of numeric literals are decoded only once
+   /// `decode_values` asks for them, and are then kept in a separate, sparse array so that tokens
+   /// of other kinds don't pay for them.
+   ///
+   /// The arrays are `detail_lexer::gap_buffer`s, so that an edit doesn't move or shift the tokens
+   /// after it, and edits that follow one another through a file are cheap however long it is.
+   /// An edit leaves a gap in each array, which `compact` closes, so the kinds are only one dense
+   /// array for a buffer that hasn't been edited since it was lexed or compacted.
+   ///
+   /// All of the buffer's storage comes from the memory_resource it's given, so lexing a file into
+   /// a `compilation_arena` costs a few allocations from the arena, and nothing when it's torn
+   /// down.
+   ///
+   class token_buffer {
+   public:
+      /// \brief Lexes all of source, up to and including the eof token.
+      /// \param source The text to lex. It must outlive the token_buffer.
+      /// \param report Receives any lexical diagnostics.
+      /// \param file Identifies source in the tokens' locations.
+      /// \param memory Supplies the buffer's storage.
+      /// \throws std::length_error if source is too large for its offsets to fit in 32 bits.
+      ///
+      token_buffer(std::string_view source, reporter& report, file_id file = file_id{},
+         std::pmr::memory_resource* memory = std::pmr::get_default_resource()) noexcept(false);
+
+      /// \brief Lexes all of source on several threads, producing exactly the tokens and
+      ///        diagnostics that the sequential constructor does.
+      ///
+      /// The source is split into chunks at line starts, and each chunk is lexed on the
+      /// assumption that it doesn't begin inside a comment or string literal. The chunks are then
+      /// stitched together in order: where the previous chunk's last token ran past the boundary,
+      /// the next chunk's tokens are used from the first one that the sequential lexer would also
+      /// have started at, and any stretch that neither chunk lexed correctly is lexed again. The
+      /// chunks' diagnostics are reported as they're stitched in, on the lines that are left once
+      /// the literals before them have had their '\f's joined.
+      ///
+      /// \param how How many threads to use, and how finely to split the source.
+      /// \throws std::length_error if source is too large for its offsets to fit in 32 bits.
+      ///
+      token_buffer(std::string_view source, reporter& report, parallel_lexing how,
+         file_id file = file_id{},
+         std::pmr::memory_resource* memory = std::pmr::get_default_resource()) noexcept(false);
+
+      /// \brief Lexes all of source in two passes, producing exactly the tokens and diagnostics that
+      ///        the sequential constructor does.
+      ///
+      /// The first pass builds a `detail_lexer::structural_index`, which marks the characters that
+      /// aren't whitespace or comments a 64-byte block at a time. The second jumps from the end of
+      /// each token to the next marked character and scans the token there, so whitespace and
+      /// comments are never looked at a character at a time, and coordinates come from the line
+      /// table rather than being tracked.
+      ///
+      /// \throws std::length_error if source is too large for its offsets to fit in 32 bits.
+      ///
+      token_buffer(std::string_view source, reporter& report, two_stage_lexing_t,
+         file_id file = file_id{},
+         std::pmr::memory_resource* memory = std::pmr::get_default_resource()) noexcept(false);
+
+      /// \brief Updates the buffer to hold the tokens of source, which is the text it was lexed
+      ///        from with change applied.
+      ///
+      /// Each scanner looks at most one character past the end of its token, so the tokens that
+      /// end before the change are kept, and lexing resumes at the end of the last of them. It
+      /// stops once a token ends past the change where one of the old tokens did, because from
+      /// there on the lexer would see the same characters as it did before; the old tokens after
+      /// that point are kept, and shifted all at once. The work done is proportional to the size of
+      /// the change and the tokens around it, and to how far the change is from the previous one.
+      ///
+      /// \param source The edited text. It must outlive the token_buffer.
+      /// \param report Receives the diagnostics for the tokens that were lexed again. Those for the
+      ///               tokens that were kept aren't repeated.
+      /// \returns Which tokens were replaced.
+      /// \throws std::length_error if source is too large for its offsets to fit in 32 bits.
+      ///
+      token_edit edit(std::string_view source, text_edit change, reporter& report) noexcept(false);
+
+      /// \brief Decodes the value of every numeric literal, so that `integral_value`,
+      ///        `floating_value`, and `operator[]` return them, and keeps each one decoded through
+      ///        later edits. Until then, none of them has a value.
+      ///
+      /// Each literal is decoded once, however often its value is asked for. Calling this again
+      /// does nothing.
+      ///
+      void decode_values();
+
+      /// \brief Closes the gaps that edits leave in the buffer's arrays, so that `kinds` can be
+      ///        called again. Costs time in proportion to the number of tokens after the most
+      ///        recent edit.
+      ///
+      void compact();
+
+      /// \brief Returns the number of tokens, including the eof token.
+      ///
+      std::size_t size() const noexcept
+      { return kinds_.size(); }
+
+      /// \brief Returns the kind of every token, in order, as one array.
+      /// \pre The buffer hasn't been edited since it was lexed, or since `compact` was last called.
+      ///
+      std::span<token_kind const> kinds() const noexcept
+      { return kinds_.contiguous(); }
+
+      /// \pre `i < size()`
+      ///
+      token_kind kind(std::size_t const i) const noexcept
+      { return kinds_[i]; }
+
+      /// \pre `i < size()`
+      ///
+      std::string_view spelling(std::size_t i) const noexcept;
+
+      /// \brief Returns where the ith token begins.
+      /// \pre `i < size()`
+      ///
+      source_location location(std::size_t const i) const noexcept
+      { return source_location{file_, offsets_[i]}; }
+
+      /// \pre `i < size()`
+      ///
+      source_coordinate_range position(std::size_t i) const noexcept;
+
+      /// \brief Returns the value of the ith token, if it's an integral literal that fits in 64
+      ///        bits.
+      /// \pre `i < size()`
+      ///
+      std::optional<std::uint64_t> integral_value(std::size_t i) const noexcept;
+
+      /// \brief Returns the value of the ith token, if it's a floating-point literal that a double
+      ///        can represent.
+      /// \pre `i < size()`
+      ///
+      std::optional<double> floating_value(std::size_t i) const noexcept;
+
+      /// \brief Reassembles the ith token, which borrows its spelling from the source.
+      /// \pre `i < size()`
+      ///
+      token operator[](std::size_t i) const noexcept;
+
+      std::string_view source() const noexcept
+      { return source_; }
+
+      line_table const& lines() const noexcept
+      { return lines_; }
+   private:
+      std::string_view source_;
+      file_id file_;
+      line_table lines_;
+      detail_lexer::gap_buffer<token_kind> kinds_;
+      detail_lexer::gap_buffer<std::uint32_t> offsets_;
+      detail_lexer::gap_buffer<std::uint32_t> lengths_;
+
+      // The index of each token that has a decoded value, in ascending order, and that value's bits.
+      detail_lexer::gap_buffer<std::uint32_t> valued_tokens_;
+      detail_lexer::gap_buffer<std::uint64_t> values_;
+      bool decodes_values_ = false;
+
+      std::optional<std::uint64_t> value_bits(std::size_t i) const noexcept;
+
+      struct chunk;
+
+      token_buffer(std::string_view source, file_id file, line_table lines,
+         std::pmr::memory_resource* memory);
+
+      void reserve(std::size_t characters);
+
+      /// Appends t, whose spelling is a view of the source, or which is the eof token.
+      ///
+      void push_back(token const& t);
+
+      /// Lexes the token at the front of unscanned and appends it. Returns false once the eof
+      /// token has been appended.
+      ///
+      bool lex_next(std::string_view& unscanned, source_coordinate& cursor, reporter& report);
+
+      /// Appends the tokens that c lexed from its ith onward and reports their diagnostics. Returns
+      /// the coordinate that the next token's whitespace begins at.
+      ///
+      source_coordinate splice(chunk const& c, std::size_t i, reporter& report);
+
+      /// Returns whether the ith token has a '\f' in it, which ends a line everywhere but in a
+      /// literal.
+      ///
+      bool holds_form_feed(std::size_t i) const noexcept;
+
+      /// Joins the lines that the line table split the ith token across, if any.
+      ///
+      void join_lines(std::size_t i) noexcept;
+
+      // token_cache writes the arrays out as they are.
+      friend class token_cache;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_TOKEN_BUFFER_HPP
@@ -0,0 +1,179 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_TOKEN_CACHE_HPP
+#define LTCPP_LEXER_TOKEN_CACHE_HPP
+
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+#include "ltcpp/source_location.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace ltcpp {
+   /// \brief The tokens of a source file, as stored by a token_cache.
+   ///
+   /// The arrays are used in place from a read-only mapping of the cache entry, so getting a
+   /// cached_token_buffer costs an open(2) and an mmap(2) however many tokens there are. It offers
+   /// the same queries as the token_buffer that it was stored from, and gives the same answers.
+   ///
+   class cached_token_buffer {
+   public:
+      cached_token_buffer(cached_token_buffer&& other) noexcept;
+      cached_token_buffer& operator=(cached_token_buffer&& other) noexcept;
+
+      cached_token_buffer(cached_token_buffer const&) = delete;
+      cached_token_buffer& operator=(cached_token_buffer const&) = delete;
+
+      ~cached_token_buffer();
+
+      /// \brief Returns the number of tokens, including the eof token.
+      ///
+      std::size_t size() const noexcept
+      { return kinds_.size(); }
+
+      /// \brief Returns the kind of every token, in order.
+      ///
+      std::span<token_kind const> kinds() const noexcept
+      { return kinds_; }
+
+      /// \pre `i < size()`
+      ///
+      token_kind kind(std::size_t const i) const noexcept
+      { return kinds_[i]; }
+
+      /// \pre `i < size()`
+      ///
+      std::string_view spelling(std::size_t i) const noexcept;
+
+      /// \brief Returns where the ith token begins.
+      /// \pre `i < size()`
+      ///
+      source_location location(std::size_t const i) const noexcept
+      { return source_location{file_, offsets_[i]}; }
+
+      /// \pre `i < size()`
+      ///
+      source_coordinate_range position(std::size_t i) const noexcept;
+
+      /// \pre `i < size()`
+      ///
+      std::optional<std::uint64_t> integral_value(std::size_t i) const noexcept;
+
+      /// \pre `i < size()`
+      ///
+      std::optional<double> floating_value(std::size_t i) const noexcept;
+
+      /// \brief Reassembles the ith token, which borrows its spelling from the source.
+      /// \pre `i < size()`
+      ///
+      token operator[](std::size_t i) const noexcept;
+
+      std::string_view source() const noexcept
+      { return source_; }
+
+      /// \brief Returns the offset at which each line of the source begins.
+      ///
+      std::span<std::uint32_t const> line_starts() const noexcept
+      { return line_starts_; }
+   private:
+      void* mapping_ = nullptr;
+      std::size_t mapping_size_ = 0;
+      std::string_view source_;
+      file_id file_;
+      std::span<token_kind const> kinds_;
+      std::span<std::uint32_t const> offsets_;
+      std::span<std::uint32_t const> lengths_;
+      std::span<std::uint32_t const> line_starts_;
+      std::span<std::uint32_t const> valued_tokens_;
+      std::span<std::uint64_t const> values_;
+
+      cached_token_buffer() = default;
+
+      std::optional<std::uint64_t> value_bits(std::size_t i) const noexcept;
+
+      void release() noexcept;
+
+      friend class token_cache;
+   };
+
+   /// \brief A directory of lexed source files, each stored under a hash of its contents.
+   ///
+   /// Sources that haven't changed since they were last lexed can be looked up rather than lexed
+   /// again:
+   ///
+   ///    if (auto cached = cache.find(source)) {
+   ///       // use *cached
+   ///    }
+   ///    else {
+   ///       auto const tokens = token_buffer{source, report, two_stage_lexing};
+   ///       if (report.errors() == 0 and report.warnings() == 0) {
+   ///          cache.store(tokens);
+   ///       }
+   ///       // use tokens
+   ///    }
+   ///
+   /// A cache hit skips the lexer entirely, so it reports nothing: tokens lexed with diagnostics
+   /// shouldn't be stored. Entries are written to a temporary file that's then renamed, so
+   /// processes can share a cache directory, and a reader never sees half an entry. Entries are
+   /// in the writer's byte order.
+   ///
+   class token_cache {
+   public:
+      /// \brief Identifies the lexer whose tokens are cached. It's part of every entry's key, so
+      ///        entries from an older lexer are never found.
+      ///
+      /// Change it whenever a change to the lexer changes the tokens that it produces for any
+      /// source.
+      ///
+      static constexpr std::uint32_t lexer_version = 1;
+
+      /// \brief Uses directory as the cache, creating it if it doesn't exist.
+      /// \throws std::filesystem::filesystem_error if directory can't be created.
+      ///
+      explicit token_cache(std::filesystem::path directory) noexcept(false);
+
+      std::filesystem::path const& directory() const noexcept
+      { return directory_; }
+
+      /// \brief Returns the path of the entry that source's tokens are stored in.
+      ///
+      std::filesystem::path entry(std::string_view source) const;
+
+      /// \brief Looks up the tokens of source.
+      /// \param source The text to find the tokens of. It must outlive the result.
+      /// \param file Identifies source in the tokens' locations.
+      /// \returns The cached tokens, or std::nullopt if source hasn't been stored, or its entry is
+      ///          from another lexer version or isn't well-formed.
+      /// \throws std::system_error if the entry exists but can't be read.
+      ///
+      std::optional<cached_token_buffer>
+      find(std::string_view source, file_id file = file_id{}) const noexcept(false);
+
+      /// \brief Stores tokens under a hash of `tokens.source()`, replacing any entry that's there.
+      /// \throws std::system_error if the entry can't be written.
+      ///
+      void store(token_buffer const& tokens) const noexcept(false);
+   private:
+      std::filesystem::path directory_;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_TOKEN_CACHE_HPP
@@ -0,0 +1,200 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_TOKEN_GENERATOR_HPP
+#define LTCPP_LEXER_TOKEN_GENERATOR_HPP
+
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <utility>
+
+namespace ltcpp {
+   /// \brief A coroutine that yields tokens one at a time, as a single-pass range of
+   ///        `token const&`.
+   ///
+   /// This is the subset of C++23's `std::generator<token const&>` that the lexer needs. The
+   /// coroutine runs only when the range is advanced, so no more of the source is lexed than has
+   /// been asked for, and no tokens are stored beyond the one being looked at. An exception that
+   /// escapes the coroutine is rethrown from `begin()` or `++`.
+   ///
+   class token_generator : public std::ranges::view_interface<token_generator> {
+   public:
+      struct promise_type {
+         token const* current = nullptr;
+         std::exception_ptr exception;
+
+         token_generator get_return_object() noexcept
+         { return token_generator{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+         std::suspend_always initial_suspend() const noexcept
+         { return {}; }
+
+         std::suspend_always final_suspend() const noexcept
+         { return {}; }
+
+         /// The token outlives the suspension: either it's a local of the coroutine, or it's a
+         /// temporary that lasts until the end of the full-expression that yields it.
+         ///
+         std::suspend_always yield_value(token const& t) noexcept
+         {
+            current = &t;
+            return {};
+         }
+
+         void return_void() const noexcept
+         {}
+
+         void unhandled_exception() noexcept
+         { exception = std::current_exception(); }
+
+         template<class T>
+         void await_transform(T&&) = delete;
+      };
+
+      class iterator {
+      public:
+         using value_type = token;
+         using difference_type = std::ptrdiff_t;
+
+         iterator() = default;
+
+         token const& operator*() const noexcept
+         { return *coroutine_.promise().current; }
+
+         token const* operator->() const noexcept
+         { return coroutine_.promise().current; }
+
+         iterator& operator++() noexcept(false)
+         {
+            resume(coroutine_);
+            return *this;
+         }
+
+         void operator++(int) noexcept(false)
+         { ++*this; }
+
+         friend bool operator==(iterator const& i, std::default_sentinel_t) noexcept
+         { return i.coroutine_.done(); }
+      private:
+         std::coroutine_handle<promise_type> coroutine_;
+
+         explicit iterator(std::coroutine_handle<promise_type> const coroutine) noexcept
+            : coroutine_{coroutine}
+         {}
+
+         friend class token_generator;
+      };
+
+      token_generator(token_generator&& other) noexcept
+         : coroutine_{std::exchange(other.coroutine_, nullptr)}
+      {}
+
+      token_generator& operator=(token_generator&& other) noexcept
+      {
+         if (this != &other) {
+            release();
+            coroutine_ = std::exchange(other.coroutine_, nullptr);
+         }
+         return *this;
+      }
+
+      token_generator(token_generator const&) = delete;
+      token_generator& operator=(token_generator const&) = delete;
+
+      ~token_generator()
+      { release(); }
+
+      /// \brief Runs the coroutine up to its first token.
+      /// \pre `begin()` hasn't been called before.
+      ///
+      iterator begin() noexcept(false)
+      {
+         resume(coroutine_);
+         return iterator{coroutine_};
+      }
+
+      std::default_sentinel_t end() const noexcept
+      { return std::default_sentinel; }
+   private:
+      std::coroutine_handle<promise_type> coroutine_;
+
+      explicit token_generator(std::coroutine_handle<promise_type> const coroutine) noexcept
+         : coroutine_{coroutine}
+      {}
+
+      static void resume(std::coroutine_handle<promise_type> const coroutine) noexcept(false)
+      {
+         coroutine.resume();
+         if (auto& exception = coroutine.promise().exception) {
+            std::rethrow_exception(std::exchange(exception, nullptr));
+         }
+      }
+
+      void release() noexcept
+      {
+         if (coroutine_) {
+            coroutine_.destroy();
+            coroutine_ = nullptr;
+         }
+      }
+   };
+
+   /// \brief Lexes in lazily, yielding each token up to and including the eof token.
+   /// \param in The source, which must outlive the generator.
+   /// \param report Receives any lexical diagnostics, as tokens are lexed.
+   /// \param cursor The position of the first character of in.
+   ///
+   template<token_input Input>
+   token_generator
+   yield_tokens(Input& in, reporter& report, source_coordinate cursor = source_coordinate{})
+   {
+      for (;;) {
+         auto const t = generate_token(in, report, cursor);
+         cursor = t.position().end();
+         co_yield t;
+         if (t.kind() == token_kind::eof) {
+            co_return;
+         }
+      }
+   }
+
+   /// \brief Lexes a buffer lazily, yielding each token up to and including the eof token.
+   ///
+   /// The generator keeps its own copy of in, but the tokens' spellings refer to the characters
+   /// that it views, which must outlive them.
+   ///
+   inline token_generator
+   yield_tokens(std::string_view in, reporter& report, source_coordinate cursor = source_coordinate{})
+   {
+      for (;;) {
+         auto const t = generate_token(in, report, cursor);
+         cursor = t.position().end();
+         co_yield t;
+         if (t.kind() == token_kind::eof) {
+            co_return;
+         }
+      }
+   }
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_TOKEN_GENERATOR_HPP
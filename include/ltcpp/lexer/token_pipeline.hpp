@@ -0,0 +1,111 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_TOKEN_PIPELINE_HPP
+#define LTCPP_LEXER_TOKEN_PIPELINE_HPP
+
+#include "ltcpp/lexer/detail/spsc_ring.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ltcpp {
+   /// \brief How a token_pipeline hands tokens from the lexer's thread to the consumer's.
+   ///
+   struct pipelined_lexing {
+      /// The number of tokens that the lexer hands over at a time. Larger batches synchronise the
+      /// threads less often; smaller ones get the first tokens to the consumer sooner.
+      std::size_t batch_size = 512;
+
+      /// The most batches that the lexer can get ahead of the consumer by before it waits.
+      std::size_t batches_in_flight = 8;
+   };
+
+   /// \brief Lexes a source on a thread of its own while the caller consumes the tokens, so that
+   ///        lexing and whatever consumes the tokens (usually parsing) overlap.
+   ///
+   /// The lexer thread fills batches of tokens in a `detail_lexer::spsc_ring` and waits when it's
+   /// `batches_in_flight` batches ahead. Batches are reused, and the tokens borrow their spellings
+   /// from the source, so nothing is allocated per token once the ring has gone round once.
+   ///
+   /// The lexer's diagnostics are held back with the token they were reported for, and relayed to
+   /// the consumer's reporter, on the consumer's thread, just before `next()` returns that token.
+   /// A consumer that reports about each token after `next()` returns it therefore produces the
+   /// same diagnostics, in the same order, as lexing and consuming in turn on one thread would.
+   ///
+   class token_pipeline {
+   public:
+      /// \brief Starts lexing source on a new thread.
+      /// \param source The text to lex. It must outlive the tokens.
+      /// \param report Receives every diagnostic, always on the thread that calls `next()`.
+      ///
+      token_pipeline(std::string_view source, reporter& report, pipelined_lexing how = {});
+
+      token_pipeline(token_pipeline const&) = delete;
+      token_pipeline& operator=(token_pipeline const&) = delete;
+
+      /// \brief Stops the lexer, if it hasn't already finished, and waits for its thread.
+      ///
+      ~token_pipeline();
+
+      /// \brief Returns the next token, waiting for the lexer if it hasn't got that far.
+      ///
+      /// Once the eof token has been returned, every later call returns it again. The token stays
+      /// valid until the next call.
+      ///
+      /// \throws Whatever the lexer thread threw, in place of the token that it was lexing.
+      ///
+      token const& next() noexcept(false);
+   private:
+      /// A diagnostic that was reported while lexing one of a batch's tokens.
+      ///
+      struct diagnostic {
+         std::size_t token;
+         std::string text;
+         std::intmax_t errors;
+         std::intmax_t warnings;
+      };
+
+      struct batch {
+         std::vector<token> tokens;
+         std::vector<diagnostic> diagnostics;
+         std::exception_ptr exception;
+      };
+
+      reporter* report_;
+      detail_lexer::spsc_ring<batch> ring_;
+      batch* current_ = nullptr;
+      std::size_t position_ = 0;
+      std::size_t next_diagnostic_ = 0;
+      bool finished_ = false;
+
+      /// Set by the lexer thread as it returns, so that the destructor knows when it can stop
+      /// handing batches back.
+      std::atomic<bool> lexer_returned_ = false;
+      std::jthread lexer_;
+
+      static void lex(std::stop_token stop, std::string_view source, std::size_t batch_size,
+         detail_lexer::spsc_ring<batch>& ring, std::atomic<bool>& returned) noexcept;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_TOKEN_PIPELINE_HPP
@@ -0,0 +1,67 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_TOKEN_STREAM_HPP
+#define LTCPP_LEXER_TOKEN_STREAM_HPP
+
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/lexer/token_buffer.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// A token stream is a self-contained binary record of a lexed file, for caching, sending to
+/// another process, or inspecting files too large to dump as text. It doesn't need the source to
+/// be read back, and reading it does no lexing.
+///
+/// Numbers are unsigned LEB128 varints: seven bits a byte, least significant first, with the top
+/// bit set on every byte but the last. A stream is laid out as follows.
+///
+///    magic        the eight bytes "ltcppts\0"
+///    version      varint; currently `token_stream_version`
+///    counts       varints: the number of strings, lines, and tokens
+///    strings      for each string, its length as a varint, then its characters
+///    line starts  for each line after the first, the number of characters since the previous
+///                 line began, as a varint; the first line begins at 0
+///    tokens       for each token, a kind byte, then a varint, then possibly another varint
+///
+/// A token's kind byte holds its `token_kind` in the low seven bits. The first varint is the number
+/// of characters between the end of the previous token (or the beginning of the source) and the
+/// beginning of this one. If the kind byte's top bit is set, the token is spelled the same way as
+/// the last token of the same kind; otherwise the second varint indexes the string table with its
+/// spelling. Keywords and punctuation therefore cost two bytes each, and so do identifiers that
+/// repeat the one before. The eof token has no index, is spelled "$", and is empty.
+///
+namespace ltcpp {
+   /// \brief The version of the format that write_token_stream writes, and the only one that
+   ///        read_token_stream reads. It changes whenever the layout does.
+   ///
+   inline constexpr std::uint32_t token_stream_version = 1;
+
+   /// \brief Serialises tokens as a token stream.
+   ///
+   std::string write_token_stream(token_buffer const& tokens);
+
+   /// \brief Reads back the tokens in a token stream.
+   /// \returns Tokens with the same kinds, spellings, and positions as those that were written, and
+   ///          with numeric literals' values undecoded, as the lexer leaves them. Their spellings
+   ///          are views of bytes, which must outlive them.
+   /// \throws std::runtime_error if bytes isn't a well-formed token stream of this version.
+   ///
+   std::vector<token> read_token_stream(std::string_view bytes) noexcept(false);
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_TOKEN_STREAM_HPP
@@ -0,0 +1,220 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LEXER_TOKEN_VISITOR_HPP
+#define LTCPP_LEXER_TOKEN_VISITOR_HPP
+
+#include "ltcpp/lexer/detail/scan_token.hpp"
+#include "ltcpp/lexer/detail/scan_whitespace.hpp"
+#include "ltcpp/lexer/lexer_policy.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ltcpp::detail_lexer {
+   /// \brief Holds when Visitor can be called with a Kind, a spelling, and a position, returning
+   ///        either nothing or whether to carry on.
+   ///
+   template<class Visitor, class Kind>
+   concept visitor_of = std::invocable<Visitor&, Kind, std::string_view, source_coordinate_range>
+                    and (std::is_void_v<std::invoke_result_t<Visitor&, Kind, std::string_view, source_coordinate_range>>
+                      or std::same_as<std::invoke_result_t<Visitor&, Kind, std::string_view, source_coordinate_range>, bool>);
+} // namespace ltcpp::detail_lexer
+
+namespace ltcpp {
+   /// \brief A callable that `lex` hands each token of a source to, as its kind, its spelling, and
+   ///        its position, and, if Policy asks for trivia, the whitespace and comments between them
+   ///        too, as `trivia` in place of a kind. It may return `bool`, in which case returning
+   ///        `false` stops lexing.
+   ///
+   template<class Visitor, class Policy = default_lexer_policy>
+   concept token_visitor = lexer_policy<Policy>
+                       and detail_lexer::visitor_of<Visitor, token_kind>
+                       and (not Policy::trivia or detail_lexer::visitor_of<Visitor, trivia_t>);
+} // namespace ltcpp
+
+namespace ltcpp::detail_lexer {
+   /// \brief Returns the offset in text of the character at coordinate to, given that text begins
+   ///        at coordinate from.
+   /// \pre to is the coordinate of a character in text.
+   ///
+   inline std::size_t offset_of(std::string_view const text, source_coordinate const from,
+      source_coordinate const to) noexcept
+   {
+      auto line_start = std::size_t{0};
+      auto first_column = static_cast<std::intmax_t>(from.column());
+      for (auto lines = static_cast<std::intmax_t>(to.line() - from.line()); lines != 0; --lines) {
+         line_start = text.find_first_of("\n\f", line_start);
+         auto const c = text[line_start++];
+         if (c == '\n' and line_start != text.size() and text[line_start] == '\r') {
+            ++line_start;
+         }
+         first_column = 1;
+      }
+      return line_start + static_cast<std::size_t>(static_cast<std::intmax_t>(to.column()) - first_column);
+   }
+
+   /// \brief Calls visit with whatever Policy keeps of a token or some trivia.
+   /// \returns false if visit asked to stop.
+   ///
+   template<class Policy, class Visitor, class Kind>
+   bool visit_lexeme(Visitor& visit, Kind const kind, std::string_view const spelling,
+      source_coordinate_range position)
+   {
+      if constexpr (not Policy::positions) {
+         position = source_coordinate_range{source_coordinate{}, source_coordinate{}};
+      }
+
+      if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, Kind, std::string_view, source_coordinate_range>>) {
+         std::invoke(visit, kind, spelling, position);
+         return true;
+      }
+      else {
+         return std::invoke(visit, kind, spelling, position);
+      }
+   }
+
+   /// \brief Holds when no call that `lex` makes to a Visitor can throw.
+   ///
+   template<class Visitor, class Policy>
+   inline constexpr bool is_nothrow_visitor =
+      std::is_nothrow_invocable_v<Visitor&, token_kind, std::string_view, source_coordinate_range>
+      and (not Policy::trivia or std::is_nothrow_invocable_v<Visitor&, trivia_t, std::string_view, source_coordinate_range>);
+
+   /// \brief Implements both overloads of `ltcpp::lex`.
+   /// \pre `report != nullptr` if `Policy::diagnostics`.
+   ///
+   template<class Policy, class Visitor>
+   void lex(std::string_view const source, reporter* const report, Visitor& visit,
+      source_coordinate cursor)
+   {
+      auto in = source;
+      for (;;) {
+         auto const skipped = in;
+         auto const trivia_begin = cursor;
+         auto unterminated_comment = std::optional<std::string_view>{};
+         auto comment_position = source_coordinate_range{cursor, cursor};
+         if constexpr (Policy::positions) {
+            if (auto const whitespace = scan_whitespace_like(in, cursor)) {
+               cursor = *whitespace;
+            }
+            else {
+               auto const& comment = whitespace.error();
+               unterminated_comment = skipped.substr(offset_of(skipped, cursor, comment.begin()));
+               comment_position = comment;
+               cursor = comment.end();
+            }
+         }
+         else {
+            unterminated_comment = skip_whitespace_like(in);
+         }
+
+         // A comment that's never closed is trivia if it's reported, and a token otherwise.
+         if constexpr (Policy::trivia) {
+            auto const comment_is_token = unterminated_comment and not Policy::diagnostics;
+            auto const end = comment_is_token ? unterminated_comment->data() : in.data();
+            auto const end_position = comment_is_token ? comment_position.begin() : cursor;
+            if (end != skipped.data()
+            and not visit_lexeme<Policy>(visit, trivia,
+                                         skipped.substr(0, static_cast<std::size_t>(end - skipped.data())),
+                                         source_coordinate_range{trivia_begin, end_position})) {
+               return;
+            }
+         }
+
+         if (unterminated_comment) {
+            if constexpr (Policy::diagnostics) {
+               report_unterminated_comment(*report, comment_position.begin());
+            }
+            else if (not visit_lexeme<Policy>(visit, token_kind::unterminated_comment,
+                                                *unterminated_comment, comment_position)) {
+               return;
+            }
+         }
+
+         if (in.empty()) {
+            visit_lexeme<Policy>(visit, token_kind::eof, in, source_coordinate_range{cursor, cursor});
+            return;
+         }
+
+         auto const t = scan_token(in, cursor);
+         if constexpr (Policy::diagnostics) {
+            report_token_error(*report, t, t.position().begin());
+         }
+         if constexpr (Policy::positions) {
+            cursor = t.position().end();
+         }
+         if (not visit_lexeme<Policy>(visit, t.kind(), t.spelling(), t.position())) {
+            return;
+         }
+      }
+   }
+} // namespace ltcpp::detail_lexer
+
+namespace ltcpp {
+   /// \brief Lexes source, calling visit with each token in turn rather than constructing tokens
+   ///        for the caller to keep.
+   ///
+   /// The scanners are the ones that `generate_token` uses, so the kinds, spellings, positions,
+   /// and diagnostics are exactly those it produces for a std::string_view. Since visit is called
+   /// inline and each spelling is a view of source, whole-file passes that only count tokens or
+   /// look for a few kinds allocate nothing.
+   ///
+   /// Policy compiles out the trivia and diagnostics that visit doesn't need. Without positions,
+   /// no coordinates are worked out while skipping whitespace and comments, though tokens are
+   /// scanned in full either way, and every position is the default one. Spellings are always
+   /// visited, since they're views of source that cost nothing to form. Malformed tokens are
+   /// visited with their error kinds, as well as being reported. The values of numeric literals
+   /// are never decoded, since nothing visited could hold them.
+   ///
+   /// \param source The characters to lex. Each spelling is a view of them, at offset
+   ///               `spelling.data() - source.data()`.
+   /// \param report Receives any lexical diagnostics, just before the token that they concern is
+   ///               visited, if Policy asks for them.
+   /// \param visit Called with each token, ending with an eof token whose spelling is empty and
+   ///              begins at `source.end()`, unless it returns `false` first.
+   /// \param cursor The position of the first character of source.
+   ///
+   template<lexer_policy Policy = default_lexer_policy, token_visitor<Policy> Visitor>
+   void lex(std::string_view const source, reporter& report, Visitor&& visit,
+      source_coordinate const cursor = source_coordinate{})
+      noexcept(detail_lexer::is_nothrow_visitor<Visitor, Policy>)
+   { detail_lexer::lex<Policy>(source, std::addressof(report), visit, cursor); }
+
+   /// \brief Lexes source as the overload that takes a reporter does, for a Policy that doesn't
+   ///        report anything.
+   ///
+   /// A multi-line comment that's never closed is visited instead, as a
+   /// `token_kind::unterminated_comment` spelled from its "/*" to the end of source, just before
+   /// eof.
+   ///
+   template<lexer_policy Policy = unreported_lexer_policy, token_visitor<Policy> Visitor>
+   requires (not Policy::diagnostics)
+   void lex(std::string_view const source, Visitor&& visit, source_coordinate const cursor = source_coordinate{})
+      noexcept(detail_lexer::is_nothrow_visitor<Visitor, Policy>)
+   { detail_lexer::lex<Policy>(source, nullptr, visit, cursor); }
+} // namespace ltcpp
+
+#endif // LTCPP_LEXER_TOKEN_VISITOR_HPP
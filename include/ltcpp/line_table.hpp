@@ -0,0 +1,97 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_LINE_TABLE_HPP
+#define LTCPP_LINE_TABLE_HPP
+
+#include "ltcpp/lexer/detail/gap_buffer.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/text_edit.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+
+namespace ltcpp {
+   /// \brief Maps byte offsets in a source file to the `{line:column}` coordinates that the lexer
+   ///        reports.
+   ///
+   /// The table holds the offset at which each line begins, found in a single vectorised pass over
+   /// the file, so a coordinate is a binary search away and nothing needs to be tracked while
+   /// lexing. Lines end where the lexer ends them between tokens: at '\n', "\r\n", "\n\r", and
+   /// '\f'. A '\f' in a string or character literal is part of the literal, and doesn't end a line,
+   /// but the table can't tell that without lexing, so whoever lexes the source removes those line
+   /// starts with `join_lines`.
+   ///
+   /// The line starts are kept in a `detail_lexer::gap_buffer`, so editing the table costs time
+   /// proportional to the lines that change and to how far they are from the previous edit, but not
+   /// to the number of lines after them.
+   ///
+   class line_table {
+   public:
+      /// \brief Finds where each line of source begins.
+      /// \param memory Supplies the table's storage.
+      /// \throws std::length_error if source is too large for its offsets to fit in 32 bits.
+      ///
+      explicit line_table(std::string_view source,
+         std::pmr::memory_resource* memory = std::pmr::get_default_resource()) noexcept(false);
+
+      /// \brief Updates the table to describe source, which is the text it was built from with
+      ///        change applied.
+      ///
+      /// Only the lines from the one that change begins in up to the first line break after it
+      /// that was already known are looked at again; the line starts after that are shifted all at
+      /// once.
+      ///
+      /// \returns The offset in source that line breaks were looked for up to. Lines that
+      ///          `join_lines` joined before that offset, from the start of the line that change
+      ///          begins in, are split again.
+      /// \throws std::length_error if source is too large for its offsets to fit in 32 bits.
+      ///
+      std::uint32_t edit(std::string_view source, text_edit change) noexcept(false);
+
+      /// \brief Makes the characters from begin up to end part of the line that begin is on, by
+      ///        removing the line starts in `(begin, end]`.
+      ///
+      void join_lines(std::uint32_t begin, std::uint32_t end) noexcept;
+
+      /// \brief Returns the number of lines, counting the one after the last line break.
+      ///
+      std::size_t line_count() const noexcept
+      { return line_starts_.size(); }
+
+      /// \brief Returns the offset at which each line begins, in ascending order.
+      ///
+      detail_lexer::gap_buffer<std::uint32_t> const& line_starts() const noexcept
+      { return line_starts_; }
+
+      /// \brief Returns the coordinate of the character at offset.
+      /// \pre offset doesn't fall between the two characters of a "\r\n" or "\n\r" pair.
+      ///
+      source_coordinate coordinate(std::uint32_t offset) const noexcept;
+
+      /// \brief Returns the coordinate of the character at offset in a source whose lines begin at
+      ///        line_starts, which needn't be held by a line_table.
+      /// \pre line_starts is ascending and begins with 0.
+      ///
+      static source_coordinate
+      coordinate(std::span<std::uint32_t const> line_starts, std::uint32_t offset) noexcept;
+   private:
+      detail_lexer::gap_buffer<std::uint32_t> line_starts_;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_LINE_TABLE_HPP
@@ -18,8 +18,12 @@
 
 #include "ltcpp/source_coordinate.hpp"
 #include "ltcpp/source_coordinate_range.hpp"
-#include <ostream>
+#include <cstdint>
 #include <memory>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace ltcpp {
    enum class pass { lexical, syntax, semantic, optimisation, code_generation };
@@ -67,6 +71,17 @@ namespace ltcpp {
       void warning(pass const tag, source_coordinate_range const range, Args&&... args) noexcept
       { report_impl(tag, "warning", warnings_, range, std::forward<Args>(args)...); }
 
+      /// \brief Passes on diagnostics that another reporter has already formatted, counting them as
+      ///        though they'd been reported here.
+      ///
+      void relay(std::string_view const formatted, std::intmax_t const errors,
+         std::intmax_t const warnings) noexcept
+      {
+         *out_ << formatted;
+         errors_ += errors;
+         warnings_ += warnings;
+      }
+
       std::intmax_t errors() const noexcept
       { return errors_; }
 
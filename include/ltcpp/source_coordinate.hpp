@@ -34,10 +34,10 @@ namespace ltcpp {
       ///
       constexpr source_coordinate() = default;
 
-      /// \brief Initialises the column value with the column parameter and initialises the line
-      ///        value with the line parameter.
+      /// \brief Initialises the line value with the line parameter and initialises the column
+      ///        value with the column parameter.
       ///
-      constexpr explicit source_coordinate(column_type const column, line_type const line) noexcept
+      constexpr explicit source_coordinate(line_type const line, column_type const column) noexcept
          : column_{column}
          , line_{line}
       {}
@@ -98,11 +98,10 @@ namespace ltcpp {
       source_coordinate shift(source_coordinate const x, source_coordinate const y) noexcept
       {
          return source_coordinate{
-            column_type{
-                 line_type{0}   == y.line()   ? x.column() + y.column()
-               : column_type{0} <  y.column() ? y.column()
-                                              : column_type{1}
-            }
+            x.line() + y.line(),
+              line_type{0}   == y.line()   ? x.column() + y.column()
+            : column_type{0} <  y.column() ? y.column()
+                                           : column_type{1}
          };
       }
    private:
@@ -35,7 +35,7 @@ namespace ltcpp {
       { return end_; }
 
       template<class CharT, class Traits>
-      friend std::basic_ostream<CharT, Traits>
+      friend std::basic_ostream<CharT, Traits>&
       operator<<(std::basic_ostream<CharT, Traits>& o, source_coordinate_range const& r)
       {
          return o << "from " << r.begin() << " to " << r.end();
@@ -0,0 +1,73 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_SOURCE_FILE_HPP
+#define LTCPP_SOURCE_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace ltcpp {
+   /// \brief Owns the text of a source file for as long as anything needs to refer to it.
+   ///
+   /// Regular files of at least `minimum_mapping_size` bytes are memory-mapped read-only, so
+   /// `text()` refers directly to the page cache and the file is never copied. Pipes, character
+   /// devices and small files are read with read(2) into an owned buffer instead.
+   ///
+   class source_file {
+   public:
+      /// \brief Files smaller than this are read rather than mapped: a mapping costs a page-table
+      ///        update and at least one page fault, which is more than a read(2) of a few pages.
+      ///
+      static constexpr std::size_t minimum_mapping_size = 64 * 1024;
+
+      /// \brief Opens the file at path and makes its contents available through `text()`.
+      /// \throws std::system_error if the file cannot be opened, mapped, or read.
+      ///
+      explicit source_file(std::filesystem::path const& path) noexcept(false);
+
+      source_file(source_file&& other) noexcept;
+      source_file& operator=(source_file&& other) noexcept;
+
+      source_file(source_file const&) = delete;
+      source_file& operator=(source_file const&) = delete;
+
+      ~source_file();
+
+      /// \brief Returns the contents of the file.
+      ///
+      /// The view remains valid until the source_file is destroyed or assigned to; moving a
+      /// source_file does not invalidate it.
+      ///
+      std::string_view text() const noexcept
+      { return text_; }
+
+      /// \brief Returns true if `text()` refers to a memory mapping, and false if it refers to a
+      ///        buffer that was filled with read(2).
+      ///
+      bool is_mapped() const noexcept
+      { return mapping_ != nullptr; }
+   private:
+      void* mapping_ = nullptr;
+      std::vector<char> buffer_;
+      std::string_view text_;
+
+      void release() noexcept;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_SOURCE_FILE_HPP
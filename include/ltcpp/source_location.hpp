@@ -0,0 +1,40 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_SOURCE_LOCATION_HPP
+#define LTCPP_SOURCE_LOCATION_HPP
+
+#include <cstdint>
+
+namespace ltcpp {
+   /// \brief Identifies one of the source files that are being compiled.
+   ///
+   enum class file_id : std::uint32_t {};
+
+   /// \brief A position in a source file, as a byte offset from its beginning.
+   ///
+   /// A source_location is a quarter of the size of a source_coordinate and costs nothing to
+   /// advance. A `line_table` for the file turns it into a source_coordinate when a diagnostic
+   /// needs one.
+   ///
+   struct source_location {
+      file_id file;
+      std::uint32_t offset;
+
+      friend constexpr bool operator==(source_location, source_location) noexcept = default;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_SOURCE_LOCATION_HPP
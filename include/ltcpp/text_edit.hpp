@@ -0,0 +1,39 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef LTCPP_TEXT_EDIT_HPP
+#define LTCPP_TEXT_EDIT_HPP
+
+#include <cstddef>
+
+namespace ltcpp {
+   /// \brief Describes a change to a source file's text: `removed` characters from `offset` on were
+   ///        replaced by `inserted` new ones.
+   ///
+   /// Whatever holds the text applies the edit itself; a text_edit only tells the structures that
+   /// index the text which part of it to look at again.
+   ///
+   struct text_edit {
+      /// Where the change begins, which is the same before and after it.
+      std::size_t offset;
+
+      std::size_t removed;
+      std::size_t inserted;
+
+      friend constexpr bool operator==(text_edit, text_edit) noexcept = default;
+   };
+} // namespace ltcpp
+
+#endif // LTCPP_TEXT_EDIT_HPP
@@ -0,0 +1,185 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/batch_lexing.hpp"
+
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_file.hpp"
+#include "ltcpp/source_location.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ltcpp {
+   namespace {
+      /// The files that one thread was dealt and hasn't started on, largest first. Files are never
+      /// added once lexing begins, so a queue that's been found empty stays empty.
+      ///
+      class work_queue {
+      public:
+         void push_back(std::size_t const file)
+         { files_.push_back(file); }
+
+         std::optional<std::size_t> take()
+         {
+            auto const lock = std::scoped_lock{mutex_};
+            if (files_.empty()) {
+               return std::nullopt;
+            }
+
+            auto const file = files_.front();
+            files_.pop_front();
+            return file;
+         }
+      private:
+         std::mutex mutex_;
+         std::deque<std::size_t> files_;
+      };
+
+      /// Calls `lex(i)` once for each of the files, whose sizes are given, on up to `threads`
+      /// threads. Each thread works through its own queue, then through every other thread's in
+      /// turn. Both owners and thieves take from the front, since a thief does most for the
+      /// balance by taking the largest file that's left.
+      ///
+      /// Every file is attempted even if some throw; the exception from the first file that
+      /// threw, in input order, is rethrown once all the threads have finished.
+      ///
+      template<class Lex>
+      void lex_balanced(std::span<std::uintmax_t const> const sizes, std::size_t const threads, Lex lex)
+      {
+         if (sizes.empty()) {
+            return;
+         }
+
+         auto order = std::vector<std::size_t>(sizes.size());
+         std::iota(order.begin(), order.end(), std::size_t{0});
+         std::stable_sort(order.begin(), order.end(), [sizes](std::size_t const a, std::size_t const b) {
+            return sizes[a] > sizes[b];
+         });
+
+         auto const workers = std::clamp(threads, std::size_t{1}, sizes.size());
+         auto queues = std::vector<work_queue>(workers);
+         for (auto k = std::size_t{0}; k != order.size(); ++k) {
+            queues[k % workers].push_back(order[k]);
+         }
+
+         auto failures = std::vector<std::exception_ptr>(sizes.size());
+         auto const work = [&](std::size_t const self) {
+            for (auto victim = std::size_t{0}; victim != workers;) {
+               auto const file = queues[(self + victim) % workers].take();
+               if (not file) {
+                  ++victim;
+                  continue;
+               }
+
+               try {
+                  lex(*file);
+               }
+               catch (...) {
+                  failures[*file] = std::current_exception();
+               }
+            }
+         };
+
+         {
+            auto pool = std::vector<std::jthread>{};
+            for (auto self = std::size_t{1}; self != workers; ++self) {
+               pool.emplace_back(work, self);
+            }
+            work(0);
+         }
+
+         for (auto const& failure : failures) {
+            if (failure) {
+               std::rethrow_exception(failure);
+            }
+         }
+      }
+
+      lexed_file lex_file(std::string_view const source, std::size_t const index)
+      {
+         auto text = std::ostringstream{};
+         auto report = reporter{text};
+         auto tokens = token_buffer{source, report, two_stage_lexing,
+            file_id{static_cast<std::uint32_t>(index)}};
+         return lexed_file{std::move(tokens), std::move(text).str(), report.errors(), report.warnings()};
+      }
+
+      /// The results are filled in out of order, and none of them can be default constructed.
+      ///
+      template<class T>
+      std::vector<T> unwrap(std::vector<std::optional<T>>& results)
+      {
+         auto unwrapped = std::vector<T>{};
+         unwrapped.reserve(results.size());
+         for (auto& result : results) {
+            unwrapped.push_back(std::move(*result));
+         }
+         return unwrapped;
+      }
+   } // namespace
+
+   std::vector<lexed_file>
+   lex_files(std::span<std::string_view const> const sources, batch_lexing const how) noexcept(false)
+   {
+      auto sizes = std::vector<std::uintmax_t>{};
+      sizes.reserve(sources.size());
+      for (auto const source : sources) {
+         sizes.push_back(source.size());
+      }
+
+      auto results = std::vector<std::optional<lexed_file>>(sources.size());
+      lex_balanced(sizes, how.threads, [&](std::size_t const i) {
+         results[i].emplace(lex_file(sources[i], i));
+      });
+      return unwrap(results);
+   }
+
+   std::vector<lexed_source_file>
+   lex_files(std::span<std::filesystem::path const> const paths, batch_lexing const how) noexcept(false)
+   {
+      // A file that can't be sized is still read, and reports why it couldn't be then.
+      auto sizes = std::vector<std::uintmax_t>{};
+      sizes.reserve(paths.size());
+      for (auto const& path : paths) {
+         auto error = std::error_code{};
+         auto const size = std::filesystem::file_size(path, error);
+         sizes.push_back(error ? 0 : size);
+      }
+
+      auto results = std::vector<std::optional<lexed_source_file>>(paths.size());
+      lex_balanced(sizes, how.threads, [&](std::size_t const i) {
+         auto file = source_file{paths[i]};
+         auto lexed = lex_file(file.text(), i);
+         // Moving a source_file leaves its text where it was, so the tokens still refer to it.
+         results[i].emplace(lexed_source_file{std::move(file), std::move(lexed)});
+      });
+      return unwrap(results);
+   }
+} // namespace ltcpp
@@ -0,0 +1,66 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/chunked_source.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <unistd.h>
+
+namespace ltcpp {
+   chunked_source::chunked_source(int const fd, std::size_t const chunk_size)
+      : fd_{fd}
+      , chunk_size_{std::max(chunk_size, std::size_t{1})}
+      , buffer_(2 * chunk_size_)
+   {}
+
+   bool chunked_source::refill() noexcept(false)
+   {
+      if (exhausted_) {
+         return false;
+      }
+
+      auto const unscanned_size = last_ - first_;
+      std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(first_),
+                buffer_.begin() + static_cast<std::ptrdiff_t>(last_),
+                buffer_.begin());
+      first_ = 0;
+      last_ = unscanned_size;
+
+      // A token that doesn't fit in half of the buffer is long enough that re-scanning it after
+      // every chunk would be quadratic, so the window doubles instead.
+      if (buffer_.size() - last_ < std::max(chunk_size_, last_)) {
+         buffer_.resize(std::max(2 * buffer_.size(), last_ + chunk_size_));
+      }
+
+      auto const request = buffer_.size() - last_;
+      for (;;) {
+         auto const result = ::read(fd_, buffer_.data() + last_, request);
+         if (result > 0) {
+            last_ += static_cast<std::size_t>(result);
+            return true;
+         }
+         if (result == 0) {
+            exhausted_ = true;
+            return false;
+         }
+         if (errno != EINTR) {
+            throw std::system_error{errno, std::generic_category(), "unable to read source"};
+         }
+      }
+   }
+} // namespace ltcpp
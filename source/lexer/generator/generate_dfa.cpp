@@ -0,0 +1,1039 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+// generate_dfa <grammar.g4> <output.hpp>
+//
+// Compiles the terminal rules of an ANTLR 4 grammar into a minimised, table-driven DFA and writes
+// it out as a C++ header. Parser-rule literals become terminals of their own, ahead of every lexer
+// rule, just as ANTLR makes implicit tokens of them. Rules with a `-> skip` action are left out:
+// the lexer skips whitespace and comments before it consults the DFA.
+//
+// Only the subset of ANTLR's lexer notation that a lexer for a small language needs is understood:
+// literals, character sets, `~`, `.`, grouping, alternation, `*`, `+`, `?`, their non-greedy
+// forms, and references to other lexer rules and fragments.
+//
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+   using byte_set = std::bitset<256>;
+
+   [[noreturn]] void fail(std::size_t const line, std::string_view const message)
+   {
+      throw std::runtime_error{"line " + std::to_string(line) + ": " + std::string{message}};
+   }
+
+   // ---------------------------------------------------------------------------------------------
+   // Reading the grammar
+   // ---------------------------------------------------------------------------------------------
+   enum class g4_kind { name, literal, character_set, punctuation, end };
+
+   struct g4_token {
+      g4_kind kind;
+      std::string text;
+      byte_set set;
+      std::size_t line;
+   };
+
+   class g4_reader {
+   public:
+      explicit g4_reader(std::string_view const source)
+         : source_{source}
+      {}
+
+      std::vector<g4_token> read()
+      {
+         auto result = std::vector<g4_token>{};
+         for (skip_blanks_and_comments(); i_ < source_.size(); skip_blanks_and_comments()) {
+            auto const c = source_[i_];
+            if (is_name_head(c)) {
+               auto const first = i_;
+               while (i_ < source_.size() and is_name_tail(source_[i_])) {
+                  ++i_;
+               }
+               result.push_back({g4_kind::name, std::string{source_.substr(first, i_ - first)}, {}, line_});
+            }
+            else if (c == '\'') {
+               result.push_back({g4_kind::literal, read_literal(), {}, line_});
+            }
+            else if (c == '[') {
+               result.push_back({g4_kind::character_set, {}, read_character_set(), line_});
+            }
+            else if (source_.substr(i_, 2) == "->") {
+               result.push_back({g4_kind::punctuation, "->", {}, line_});
+               i_ += 2;
+            }
+            else if (std::string_view{":;|()*+?~.,"}.find(c) != std::string_view::npos) {
+               result.push_back({g4_kind::punctuation, std::string(1, c), {}, line_});
+               ++i_;
+            }
+            else {
+               fail(line_, "unexpected character '" + std::string(1, c) + "'");
+            }
+         }
+         result.push_back({g4_kind::end, {}, {}, line_});
+         return result;
+      }
+   private:
+      std::string_view source_;
+      std::size_t i_ = 0;
+      std::size_t line_ = 1;
+
+      static bool is_name_head(char const c) noexcept
+      { return ('a' <= c and c <= 'z') or ('A' <= c and c <= 'Z'); }
+
+      static bool is_name_tail(char const c) noexcept
+      { return is_name_head(c) or ('0' <= c and c <= '9') or c == '_'; }
+
+      void skip_blanks_and_comments()
+      {
+         while (i_ < source_.size()) {
+            if (source_[i_] == '\n') {
+               ++line_;
+               ++i_;
+            }
+            else if (source_[i_] == ' ' or source_[i_] == '\t' or source_[i_] == '\r') {
+               ++i_;
+            }
+            else if (source_.substr(i_, 2) == "//") {
+               i_ = std::min(source_.find('\n', i_), source_.size());
+            }
+            else if (source_.substr(i_, 2) == "/*") {
+               auto const end = source_.find("*/", i_ + 2);
+               if (end == std::string_view::npos) {
+                  fail(line_, "unterminated comment");
+               }
+               line_ += static_cast<std::size_t>(std::count(source_.begin() + static_cast<std::ptrdiff_t>(i_),
+                  source_.begin() + static_cast<std::ptrdiff_t>(end), '\n'));
+               i_ = end + 2;
+            }
+            else {
+               return;
+            }
+         }
+      }
+
+      /// Reads the character after a backslash, which `i_` is positioned on.
+      ///
+      char read_escape()
+      {
+         if (i_ == source_.size()) {
+            fail(line_, "unterminated escape sequence");
+         }
+         switch (auto const c = source_[i_++]; c) {
+         case 'n':
+            return '\n';
+         case 'r':
+            return '\r';
+         case 't':
+            return '\t';
+         case 'f':
+            return '\f';
+         case 'b':
+            return '\b';
+         case '\\':
+         case '\'':
+         case '"':
+         case ']':
+         case '-':
+            return c;
+         default:
+            fail(line_, "unsupported escape sequence '\\" + std::string(1, c) + "'");
+         }
+      }
+
+      std::string read_literal()
+      {
+         auto result = std::string{};
+         for (++i_; i_ < source_.size() and source_[i_] != '\''; ) {
+            if (source_[i_] == '\n') {
+               break;
+            }
+            result += source_[i_] == '\\' ? (++i_, read_escape()) : source_[i_++];
+         }
+         if (i_ == source_.size() or source_[i_] != '\'') {
+            fail(line_, "unterminated literal");
+         }
+         ++i_;
+         if (result.empty()) {
+            fail(line_, "empty literal");
+         }
+         return result;
+      }
+
+      byte_set read_character_set()
+      {
+         auto result = byte_set{};
+         auto const next = [this] {
+            return source_[i_] == '\\' ? (++i_, read_escape()) : source_[i_++];
+         };
+
+         for (++i_; i_ < source_.size() and source_[i_] != ']'; ) {
+            auto const first = static_cast<unsigned char>(next());
+            auto last = first;
+            if (i_ + 1 < source_.size() and source_[i_] == '-' and source_[i_ + 1] != ']') {
+               ++i_;
+               last = static_cast<unsigned char>(next());
+            }
+            for (auto c = std::size_t{first}; c <= last; ++c) {
+               result.set(c);
+            }
+         }
+         if (i_ == source_.size()) {
+            fail(line_, "unterminated character set");
+         }
+         ++i_;
+         return result;
+      }
+   };
+
+   // ---------------------------------------------------------------------------------------------
+   // Lexer rules as regular expressions
+   // ---------------------------------------------------------------------------------------------
+   struct regex {
+      enum class kind { bytes, sequence, alternation, star, plus, optional, reference };
+
+      kind what;
+      byte_set set = {};
+      std::vector<regex> children = {};
+      bool greedy = true;
+      std::string name = {};
+   };
+
+   regex literal_regex(std::string_view const spelling)
+   {
+      auto result = regex{regex::kind::sequence};
+      for (auto const c : spelling) {
+         auto set = byte_set{};
+         set.set(static_cast<unsigned char>(c));
+         result.children.push_back(regex{regex::kind::bytes, set});
+      }
+      return result;
+   }
+
+   struct lexer_rule {
+      std::string name;
+      regex body;
+      bool is_fragment;
+      bool is_skipped;
+      std::size_t line;
+   };
+
+   struct grammar {
+      std::vector<std::string> parser_literals;
+      std::vector<lexer_rule> rules;
+   };
+
+   class grammar_parser {
+   public:
+      explicit grammar_parser(std::vector<g4_token> tokens)
+         : tokens_{std::move(tokens)}
+      {}
+
+      grammar parse()
+      {
+         auto result = grammar{};
+         if (peek().kind == g4_kind::name and (peek().text == "grammar" or peek().text == "lexer")) {
+            while (not is_punctuation(";")) {
+               advance();
+            }
+            advance();
+         }
+
+         while (peek().kind != g4_kind::end) {
+            auto const is_fragment = peek().kind == g4_kind::name and peek().text == "fragment";
+            if (is_fragment) {
+               advance();
+            }
+
+            auto const& name = expect(g4_kind::name, "a rule name");
+            auto const line = name.line;
+            auto const rule_name = name.text;
+            expect_punctuation(":");
+
+            if ('a' <= rule_name.front() and rule_name.front() <= 'z') {
+               collect_parser_literals(result.parser_literals);
+               continue;
+            }
+
+            auto body = parse_alternation();
+            auto is_skipped = false;
+            if (is_punctuation("->")) {
+               advance();
+               while (not is_punctuation(";")) {
+                  is_skipped = is_skipped or (peek().kind == g4_kind::name and peek().text == "skip");
+                  advance();
+               }
+            }
+            expect_punctuation(";");
+            result.rules.push_back({rule_name, std::move(body), is_fragment, is_skipped, line});
+         }
+         return result;
+      }
+   private:
+      std::vector<g4_token> tokens_;
+      std::size_t i_ = 0;
+
+      g4_token const& peek() const noexcept
+      { return tokens_[i_]; }
+
+      g4_token const& advance() noexcept
+      {
+         auto const& result = tokens_[i_];
+         if (result.kind != g4_kind::end) {
+            ++i_;
+         }
+         return result;
+      }
+
+      bool is_punctuation(std::string_view const p) const noexcept
+      { return peek().kind == g4_kind::punctuation and peek().text == p; }
+
+      g4_token const& expect(g4_kind const kind, std::string_view const what)
+      {
+         if (peek().kind != kind) {
+            fail(peek().line, "expected " + std::string{what});
+         }
+         return advance();
+      }
+
+      void expect_punctuation(std::string_view const p)
+      {
+         if (not is_punctuation(p)) {
+            fail(peek().line, "expected '" + std::string{p} + "'");
+         }
+         advance();
+      }
+
+      void collect_parser_literals(std::vector<std::string>& literals)
+      {
+         for (; not is_punctuation(";"); advance()) {
+            if (peek().kind == g4_kind::end) {
+               fail(peek().line, "unterminated parser rule");
+            }
+            if (peek().kind == g4_kind::literal
+                and std::find(literals.begin(), literals.end(), peek().text) == literals.end()) {
+               literals.push_back(peek().text);
+            }
+         }
+         advance();
+      }
+
+      bool ends_sequence() const noexcept
+      {
+         return peek().kind == g4_kind::end or is_punctuation("|") or is_punctuation(")")
+             or is_punctuation(";") or is_punctuation("->");
+      }
+
+      regex parse_alternation()
+      {
+         auto result = regex{regex::kind::alternation};
+         result.children.push_back(parse_sequence());
+         while (is_punctuation("|")) {
+            advance();
+            result.children.push_back(parse_sequence());
+         }
+         return result.children.size() == 1 ? std::move(result.children.front()) : result;
+      }
+
+      regex parse_sequence()
+      {
+         auto result = regex{regex::kind::sequence};
+         while (not ends_sequence()) {
+            result.children.push_back(parse_postfix());
+         }
+         return result;
+      }
+
+      regex parse_postfix()
+      {
+         auto result = parse_atom();
+         for (;;) {
+            auto kind = regex::kind{};
+            if (is_punctuation("*")) {
+               kind = regex::kind::star;
+            }
+            else if (is_punctuation("+")) {
+               kind = regex::kind::plus;
+            }
+            else if (is_punctuation("?")) {
+               kind = regex::kind::optional;
+            }
+            else {
+               return result;
+            }
+            advance();
+
+            auto repeated = regex{kind};
+            repeated.children.push_back(std::move(result));
+            if (is_punctuation("?")) {
+               advance();
+               repeated.greedy = false;
+            }
+            result = std::move(repeated);
+         }
+      }
+
+      regex parse_atom()
+      {
+         auto const& token = advance();
+         switch (token.kind) {
+         case g4_kind::literal:
+            return literal_regex(token.text);
+         case g4_kind::character_set:
+            return regex{regex::kind::bytes, token.set};
+         case g4_kind::name:
+            return regex{regex::kind::reference, {}, {}, true, token.text};
+         case g4_kind::punctuation:
+            if (token.text == "(") {
+               auto result = parse_alternation();
+               expect_punctuation(")");
+               return result;
+            }
+            if (token.text == ".") {
+               return regex{regex::kind::bytes, byte_set{}.set()};
+            }
+            if (token.text == "~") {
+               auto const negated = parse_atom();
+               auto set = byte_set{};
+               if (not as_byte_set(negated, set)) {
+                  fail(token.line, "'~' can only be applied to single characters and sets");
+               }
+               return regex{regex::kind::bytes, ~set};
+            }
+            break;
+         case g4_kind::end:
+            break;
+         }
+         fail(token.line, "unexpected '" + token.text + "'");
+      }
+
+      /// Computes the union of an alternation of single characters and character sets.
+      ///
+      static bool as_byte_set(regex const& r, byte_set& result)
+      {
+         switch (r.what) {
+         case regex::kind::bytes:
+            result |= r.set;
+            return true;
+         case regex::kind::sequence:
+            return r.children.size() == 1 and as_byte_set(r.children.front(), result);
+         case regex::kind::alternation:
+            return std::all_of(r.children.begin(), r.children.end(),
+               [&result](regex const& child) { return as_byte_set(child, result); });
+         default:
+            return false;
+         }
+      }
+   };
+
+   /// Replaces every reference to another lexer rule with that rule's body.
+   ///
+   regex inline_references(regex r, std::vector<lexer_rule> const& rules, std::vector<std::string>& active)
+   {
+      if (r.what == regex::kind::reference) {
+         auto const rule = std::find_if(rules.begin(), rules.end(),
+            [&r](lexer_rule const& x) { return x.name == r.name; });
+         if (rule == rules.end()) {
+            throw std::runtime_error{"reference to undefined lexer rule " + r.name};
+         }
+         if (std::find(active.begin(), active.end(), r.name) != active.end()) {
+            throw std::runtime_error{"lexer rule " + r.name + " refers to itself"};
+         }
+         active.push_back(r.name);
+         auto result = inline_references(rule->body, rules, active);
+         active.pop_back();
+         return result;
+      }
+
+      for (auto& child : r.children) {
+         child = inline_references(std::move(child), rules, active);
+      }
+      return r;
+   }
+
+   /// Lists every string that r matches, provided that there are no more than `limit` of them.
+   ///
+   std::optional<std::vector<std::string>> enumerate(regex const& r, std::size_t const limit)
+   {
+      auto result = std::vector<std::string>{};
+      switch (r.what) {
+      case regex::kind::bytes:
+         if (r.set.count() > limit) {
+            return std::nullopt;
+         }
+         for (auto c = std::size_t{0}; c != r.set.size(); ++c) {
+            if (r.set.test(c)) {
+               result.emplace_back(1, static_cast<char>(c));
+            }
+         }
+         return result;
+      case regex::kind::sequence:
+         result.emplace_back();
+         for (auto const& child : r.children) {
+            auto const suffixes = enumerate(child, limit);
+            if (not suffixes or result.size() * suffixes->size() > limit) {
+               return std::nullopt;
+            }
+            auto product = std::vector<std::string>{};
+            for (auto const& prefix : result) {
+               for (auto const& suffix : *suffixes) {
+                  product.push_back(prefix + suffix);
+               }
+            }
+            result = std::move(product);
+         }
+         return result;
+      case regex::kind::alternation:
+      case regex::kind::optional:
+         if (r.what == regex::kind::optional) {
+            result.emplace_back();
+         }
+         for (auto const& child : r.children) {
+            auto const strings = enumerate(child, limit);
+            if (not strings or result.size() + strings->size() > limit) {
+               return std::nullopt;
+            }
+            result.insert(result.end(), strings->begin(), strings->end());
+         }
+         return result;
+      default:
+         return std::nullopt;
+      }
+   }
+
+   bool has_non_greedy_repetition(regex const& r)
+   {
+      return not r.greedy
+          or std::any_of(r.children.begin(), r.children.end(), has_non_greedy_repetition);
+   }
+
+   // ---------------------------------------------------------------------------------------------
+   // Terminals
+   // ---------------------------------------------------------------------------------------------
+   struct terminal {
+      std::string rule;
+      std::string spelling;
+      regex pattern;
+      bool is_non_greedy;
+   };
+
+   /// Orders the terminals by priority: parser-rule literals first, then the lexer rules in the
+   /// order they're written. A rule that matches a small, finite set of strings contributes one
+   /// terminal per string, so that each can be mapped to a token kind at compile time.
+   ///
+   std::vector<terminal> collect_terminals(grammar const& g)
+   {
+      constexpr auto enumeration_limit = std::size_t{64};
+      auto result = std::vector<terminal>{};
+      auto const add_literal = [&result](std::string const& rule, std::string const& spelling) {
+         auto const duplicate = std::find_if(result.begin(), result.end(),
+            [&spelling](terminal const& t) { return t.spelling == spelling; });
+         if (duplicate == result.end()) {
+            result.push_back({rule, spelling, literal_regex(spelling), false});
+         }
+      };
+
+      for (auto const& literal : g.parser_literals) {
+         add_literal("", literal);
+      }
+
+      for (auto const& rule : g.rules) {
+         if (rule.is_fragment or rule.is_skipped) {
+            continue;
+         }
+
+         auto active = std::vector<std::string>{rule.name};
+         auto pattern = inline_references(rule.body, g.rules, active);
+         if (auto const strings = enumerate(pattern, enumeration_limit)) {
+            for (auto const& spelling : *strings) {
+               if (spelling.empty()) {
+                  fail(rule.line, "lexer rule " + rule.name + " matches the empty string");
+               }
+               add_literal(rule.name, spelling);
+            }
+         }
+         else {
+            auto const is_non_greedy = has_non_greedy_repetition(pattern);
+            result.push_back({rule.name, "", std::move(pattern), is_non_greedy});
+         }
+      }
+      return result;
+   }
+
+   // ---------------------------------------------------------------------------------------------
+   // Thompson NFA
+   // ---------------------------------------------------------------------------------------------
+   constexpr auto no_terminal = -1;
+
+   struct nfa_state {
+      byte_set on = {};
+      std::size_t target = 0;
+      std::vector<std::size_t> epsilon = {}; // in priority order
+      int accepts = no_terminal;
+      int terminal = no_terminal;
+   };
+
+   class nfa {
+   public:
+      explicit nfa(std::vector<terminal> const& terminals)
+         : terminals_{terminals}
+      {
+         auto const start = add_state(no_terminal);
+         for (auto t = std::size_t{0}; t != terminals.size(); ++t) {
+            auto const terminal = static_cast<int>(t);
+            auto const [first, last] = build(terminals[t].pattern, terminal);
+            auto const accept = add_state(terminal);
+            states_[accept].accepts = terminal;
+            states_[last].epsilon.push_back(accept);
+            states_[start].epsilon.push_back(first);
+         }
+      }
+
+      std::vector<nfa_state> const& states() const noexcept
+      { return states_; }
+
+      std::vector<terminal> const& terminals() const noexcept
+      { return terminals_; }
+
+      /// Follows epsilon transitions from seeds, in priority order, keeping only the states that
+      /// either consume a byte or accept. Once a non-greedy terminal accepts, the rest of its
+      /// states are lower-priority continuations, and are dropped, just as ANTLR stops a
+      /// non-greedy loop as soon as what follows it matches.
+      ///
+      std::vector<std::size_t> closure(std::vector<std::size_t> const& seeds) const
+      {
+         auto visited = std::vector<bool>(states_.size());
+         auto result = std::vector<std::size_t>{};
+         auto stack = std::vector<std::size_t>(seeds.rbegin(), seeds.rend());
+         while (not stack.empty()) {
+            auto const s = stack.back();
+            stack.pop_back();
+            if (visited[s]) {
+               continue;
+            }
+            visited[s] = true;
+
+            auto const& state = states_[s];
+            if (state.epsilon.empty()) {
+               result.push_back(s);
+            }
+            stack.insert(stack.end(), state.epsilon.rbegin(), state.epsilon.rend());
+         }
+
+         auto finished = std::vector<bool>(terminals_.size());
+         auto const is_cut = [&](std::size_t const s) {
+            auto const& state = states_[s];
+            if (state.terminal == no_terminal) {
+               return false;
+            }
+            auto const t = static_cast<std::size_t>(state.terminal);
+            if (finished[t]) {
+               return true;
+            }
+            finished[t] = state.accepts != no_terminal and terminals_[t].is_non_greedy;
+            return false;
+         };
+         result.erase(std::remove_if(result.begin(), result.end(), is_cut), result.end());
+         return result;
+      }
+   private:
+      std::vector<terminal> const& terminals_;
+      std::vector<nfa_state> states_;
+
+      std::size_t add_state(int const terminal)
+      {
+         states_.push_back(nfa_state{});
+         states_.back().terminal = terminal;
+         return states_.size() - 1;
+      }
+
+      void link(std::size_t const from, std::size_t const to)
+      { states_[from].epsilon.push_back(to); }
+
+      /// Returns the first and last states of a fragment that matches r. The last state has no
+      /// transitions until the caller links it onwards.
+      ///
+      std::pair<std::size_t, std::size_t> build(regex const& r, int const terminal)
+      {
+         auto const first = add_state(terminal);
+         auto const last = add_state(terminal);
+         switch (r.what) {
+         case regex::kind::bytes: {
+            // An epsilon-free state consumes a byte, so it needs an epsilon to get to `first`.
+            auto const consume = add_state(terminal);
+            states_[consume].on = r.set;
+            states_[consume].target = last;
+            link(first, consume);
+            break;
+         }
+         case regex::kind::sequence: {
+            auto previous = first;
+            for (auto const& child : r.children) {
+               auto const [child_first, child_last] = build(child, terminal);
+               link(previous, child_first);
+               previous = child_last;
+            }
+            link(previous, last);
+            break;
+         }
+         case regex::kind::alternation:
+            for (auto const& child : r.children) {
+               auto const [child_first, child_last] = build(child, terminal);
+               link(first, child_first);
+               link(child_last, last);
+            }
+            break;
+         case regex::kind::star:
+         case regex::kind::plus:
+         case regex::kind::optional: {
+            auto const [body_first, body_last] = build(r.children.front(), terminal);
+            auto const loop = add_state(terminal);
+            if (r.what == regex::kind::plus) {
+               link(first, body_first);
+            }
+            else {
+               link(first, loop);
+            }
+
+            if (r.greedy) {
+               link(loop, body_first);
+               link(loop, last);
+            }
+            else {
+               link(loop, last);
+               link(loop, body_first);
+            }
+            link(body_last, r.what == regex::kind::optional ? last : loop);
+            break;
+         }
+         case regex::kind::reference:
+            throw std::logic_error{"references should have been inlined"};
+         }
+         return {first, last};
+      }
+   };
+
+   // ---------------------------------------------------------------------------------------------
+   // Subset construction and minimisation
+   // ---------------------------------------------------------------------------------------------
+   struct dfa {
+      std::vector<std::uint8_t> byte_class;   // 256 entries
+      std::size_t class_count = 0;
+      std::vector<std::size_t> transitions;   // state * class_count + class
+      std::vector<int> accepts;               // terminal, or no_terminal
+   };
+
+   /// Bytes that every NFA transition treats the same way share a class, which keeps the
+   /// transition table narrow.
+   ///
+   std::vector<std::uint8_t> partition_bytes(nfa const& n, std::size_t& class_count)
+   {
+      auto signatures = std::map<std::vector<bool>, std::uint8_t>{};
+      auto result = std::vector<std::uint8_t>(256);
+      auto sets = std::vector<byte_set>{};
+      for (auto const& s : n.states()) {
+         if (s.epsilon.empty() and s.on.any()
+             and std::find(sets.begin(), sets.end(), s.on) == sets.end()) {
+            sets.push_back(s.on);
+         }
+      }
+
+      for (auto b = std::size_t{0}; b != 256; ++b) {
+         auto signature = std::vector<bool>{};
+         for (auto const& set : sets) {
+            signature.push_back(set.test(b));
+         }
+         auto const [where, inserted] = signatures.try_emplace(signature,
+            static_cast<std::uint8_t>(signatures.size()));
+         result[b] = where->second;
+      }
+      class_count = signatures.size();
+      return result;
+   }
+
+   dfa determinise(nfa const& n)
+   {
+      auto result = dfa{};
+      result.byte_class = partition_bytes(n, result.class_count);
+
+      auto representative = std::vector<std::size_t>(result.class_count);
+      for (auto b = std::size_t{256}; b-- != 0; ) {
+         representative[result.byte_class[b]] = b;
+      }
+
+      auto const& states = n.states();
+      auto ids = std::map<std::vector<std::size_t>, std::size_t>{};
+      auto pending = std::vector<std::vector<std::size_t>>{};
+      auto const id_of = [&](std::vector<std::size_t> const& subset) {
+         auto const [where, inserted] = ids.try_emplace(subset, ids.size());
+         if (inserted) {
+            pending.push_back(subset);
+            result.transitions.resize(ids.size() * result.class_count);
+            auto accept = no_terminal;
+            for (auto const s : subset) {
+               if (states[s].accepts != no_terminal and (accept == no_terminal or states[s].accepts < accept)) {
+                  accept = states[s].accepts;
+               }
+            }
+            result.accepts.push_back(accept);
+         }
+         return where->second;
+      };
+
+      id_of({});                 // the dead state
+      id_of(n.closure({0}));     // the start state
+      for (auto i = std::size_t{1}; i < pending.size(); ++i) {
+         auto const subset = pending[i];
+         auto const from = ids.at(subset);
+         for (auto c = std::size_t{0}; c != result.class_count; ++c) {
+            auto seeds = std::vector<std::size_t>{};
+            for (auto const s : subset) {
+               if (states[s].epsilon.empty() and states[s].on.test(representative[c])) {
+                  seeds.push_back(states[s].target);
+               }
+            }
+            auto const to = id_of(n.closure(seeds));
+            result.transitions[from * result.class_count + c] = to;
+         }
+      }
+      return result;
+   }
+
+   /// Merges states that accept the same terminal and whose transitions lead to equivalent states,
+   /// refining the partition until it stops changing. The dead state stays 0 and the start state
+   /// becomes 1.
+   ///
+   dfa minimise(dfa const& d)
+   {
+      auto const state_count = d.accepts.size();
+      auto block = std::vector<std::size_t>(state_count);
+      auto block_count = std::size_t{0};
+      {
+         auto initial = std::map<std::pair<bool, int>, std::size_t>{};
+         for (auto s = std::size_t{0}; s != state_count; ++s) {
+            auto const key = std::pair{s == 0, d.accepts[s]};
+            block[s] = initial.try_emplace(key, initial.size()).first->second;
+         }
+         block_count = initial.size();
+      }
+
+      for (;;) {
+         auto refined = std::map<std::vector<std::size_t>, std::size_t>{};
+         auto next = std::vector<std::size_t>(state_count);
+         for (auto s = std::size_t{0}; s != state_count; ++s) {
+            auto key = std::vector<std::size_t>{block[s]};
+            for (auto c = std::size_t{0}; c != d.class_count; ++c) {
+               key.push_back(block[d.transitions[s * d.class_count + c]]);
+            }
+            next[s] = refined.try_emplace(key, refined.size()).first->second;
+         }
+         block = std::move(next);
+         if (refined.size() == block_count) {
+            break;
+         }
+         block_count = refined.size();
+      }
+
+      // Number the blocks breadth-first from the start state, after the dead state.
+      auto number = std::vector<std::size_t>(block_count, state_count);
+      auto order = std::vector<std::size_t>{0, 1};
+      number[block[0]] = 0;
+      number[block[1]] = 1;
+      for (auto i = std::size_t{1}; i < order.size(); ++i) {
+         for (auto c = std::size_t{0}; c != d.class_count; ++c) {
+            auto const to = d.transitions[order[i] * d.class_count + c];
+            if (number[block[to]] == state_count) {
+               number[block[to]] = order.size();
+               order.push_back(to);
+            }
+         }
+      }
+
+      auto result = dfa{d.byte_class, d.class_count, {}, {}};
+      result.transitions.resize(order.size() * d.class_count);
+      for (auto i = std::size_t{0}; i != order.size(); ++i) {
+         result.accepts.push_back(d.accepts[order[i]]);
+         for (auto c = std::size_t{0}; c != d.class_count; ++c) {
+            result.transitions[i * d.class_count + c] = number[block[d.transitions[order[i] * d.class_count + c]]];
+         }
+      }
+      return result;
+   }
+
+   // ---------------------------------------------------------------------------------------------
+   // Output
+   // ---------------------------------------------------------------------------------------------
+   std::string quote(std::string_view const s)
+   {
+      auto result = std::string{"\""};
+      for (auto const c : s) {
+         switch (c) {
+         case '"':
+         case '\\':
+            result += '\\';
+            result += c;
+            break;
+         case '\n':
+            result += "\\n";
+            break;
+         case '\r':
+            result += "\\r";
+            break;
+         case '\t':
+            result += "\\t";
+            break;
+         default:
+            result += c;
+         }
+      }
+      return result + '"';
+   }
+
+   template<class Range>
+   void write_array(std::ostream& out, Range const& values, std::size_t const per_line)
+   {
+      auto i = std::size_t{0};
+      for (auto const& v : values) {
+         out << (i % per_line == 0 ? "\n      " : " ") << static_cast<long long>(v) << ',';
+         ++i;
+      }
+      out << "\n   ";
+   }
+
+   std::string generate_header(std::vector<terminal> const& terminals, dfa const& d,
+      std::string_view const grammar_name)
+   {
+      auto const state_count = d.accepts.size();
+      auto const state_type = state_count <= 256 ? "std::uint8_t" : "std::uint16_t";
+
+      auto out = std::ostringstream{};
+      out << "// Generated by generate_dfa from " << grammar_name << ". Do not edit: change the grammar\n"
+          << "// and rebuild instead.\n"
+          << "//\n"
+          << "#ifndef LTCPP_LEXER_DETAIL_LINGUA_DFA_HPP\n"
+          << "#define LTCPP_LEXER_DETAIL_LINGUA_DFA_HPP\n"
+          << "\n"
+          << "#include <array>\n"
+          << "#include <cstddef>\n"
+          << "#include <cstdint>\n"
+          << "#include <string_view>\n"
+          << "\n"
+          << "namespace ltcpp::detail_lexer::lingua_dfa {\n"
+          << "   /// \\brief A token that the DFA can accept.\n"
+          << "   ///\n"
+          << "   struct terminal {\n"
+          << "      /// The lexer rule that defines the terminal, or empty for a literal that only\n"
+          << "      /// appears in parser rules.\n"
+          << "      std::string_view rule;\n"
+          << "\n"
+          << "      /// The only string the terminal matches, or empty if it matches many.\n"
+          << "      std::string_view spelling;\n"
+          << "   };\n"
+          << "\n"
+          << "   using state_type = " << state_type << ";\n"
+          << "\n"
+          << "   inline constexpr auto state_count = std::size_t{" << state_count << "};\n"
+          << "   inline constexpr auto class_count = std::size_t{" << d.class_count << "};\n"
+          << "   inline constexpr auto dead_state = state_type{0};\n"
+          << "   inline constexpr auto start_state = state_type{1};\n"
+          << "   inline constexpr auto no_terminal = std::int16_t{-1};\n"
+          << "\n"
+          << "   /// \\brief Maps each byte to the column of `transitions` that it selects.\n"
+          << "   ///\n"
+          << "   inline constexpr auto byte_class = std::array<std::uint8_t, 256>{";
+      write_array(out, d.byte_class, 16);
+      out << "};\n"
+          << "\n"
+          << "   /// \\brief `transitions[state * class_count + byte_class[c]]` is the state after reading c.\n"
+          << "   ///\n"
+          << "   inline constexpr auto transitions = std::array<state_type, state_count * class_count>{";
+      write_array(out, d.transitions, d.class_count);
+      out << "};\n"
+          << "\n"
+          << "   /// \\brief The index into `terminals` that each state accepts, or `no_terminal`.\n"
+          << "   ///\n"
+          << "   inline constexpr auto accepting_terminal = std::array<std::int16_t, state_count>{";
+      write_array(out, d.accepts, 16);
+      out << "};\n"
+          << "\n"
+          << "   /// \\brief Every terminal, highest priority first.\n"
+          << "   ///\n"
+          << "   inline constexpr auto terminals = std::array<terminal, " << terminals.size() << ">{{\n";
+      for (auto const& t : terminals) {
+         out << "      {" << quote(t.rule) << ", " << quote(t.spelling) << "},\n";
+      }
+      out << "   }};\n"
+          << "} // namespace ltcpp::detail_lexer::lingua_dfa\n"
+          << "\n"
+          << "#endif // LTCPP_LEXER_DETAIL_LINGUA_DFA_HPP\n";
+      return out.str();
+   }
+
+   std::string read_file(std::string const& path)
+   {
+      auto in = std::ifstream{path, std::ios::binary};
+      if (not in) {
+         throw std::runtime_error{"unable to open " + path};
+      }
+      auto contents = std::ostringstream{};
+      contents << in.rdbuf();
+      return std::move(contents).str();
+   }
+} // namespace
+
+int main(int const argc, char const* const argv[])
+{
+   if (argc != 3) {
+      std::cerr << "usage: generate_dfa <grammar.g4> <output.hpp>\n";
+      return 2;
+   }
+
+   try {
+      auto const grammar_path = std::string{argv[1]};
+      auto const output_path = std::string{argv[2]};
+
+      auto const terminals = collect_terminals(grammar_parser{g4_reader{read_file(grammar_path)}.read()}.parse());
+      auto const automaton = nfa{terminals};
+      auto const machine = minimise(determinise(automaton));
+
+      auto const grammar_name = grammar_path.substr(grammar_path.find_last_of('/') + 1);
+      auto const header = generate_header(terminals, machine, grammar_name);
+
+      auto out = std::ofstream{output_path, std::ios::binary | std::ios::trunc};
+      out << header;
+      if (not out) {
+         throw std::runtime_error{"unable to write " + output_path};
+      }
+   }
+   catch (std::exception const& e) {
+      std::cerr << "generate_dfa: " << argv[1] << ": " << e.what() << '\n';
+      return 1;
+   }
+}
@@ -0,0 +1,193 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/interner.hpp"
+
+#include "ltcpp/lexer/detail/intern_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ltcpp::detail_lexer {
+   std::uint64_t hash_spelling(std::string_view const spelling) noexcept
+   {
+      auto const mix = [](std::uint64_t h, std::uint64_t const word, std::uint64_t const multiplier) {
+         h = (h ^ word) * multiplier;
+         return h ^ (h >> 32);
+      };
+
+      auto h = std::uint64_t{0x9E37'79B9'7F4A'7C15} ^ spelling.size();
+      auto i = std::size_t{0};
+      for (; i + 8 <= spelling.size(); i += 8) {
+         auto word = std::uint64_t{0};
+         std::memcpy(&word, spelling.data() + i, 8);
+         h = mix(h, word, 0xFF51'AFD7'ED55'8CCD);
+      }
+
+      auto tail = std::uint64_t{0};
+      std::memcpy(&tail, spelling.data() + i, spelling.size() - i);
+      return mix(h, tail, 0xC4CE'B9FE'1A85'EC53);
+   }
+
+   std::string_view string_arena::copy(std::string_view const s)
+   {
+      if (s.empty()) {
+         return std::string_view{};
+      }
+
+      auto const result = static_cast<char*>(blocks_.allocate(s.size(), 1));
+      std::memcpy(result, s.data(), s.size());
+      return std::string_view{result, s.size()};
+   }
+
+   std::optional<std::uint32_t>
+   hash_index::find(std::uint64_t const hash, std::string_view const spelling) const noexcept
+   {
+      if (slots_.empty()) {
+         return std::nullopt;
+      }
+
+      auto const mask = slots_.size() - 1;
+      auto const short_hash = static_cast<std::uint32_t>(hash >> 32);
+      for (auto i = static_cast<std::size_t>(hash) & mask;; i = (i + 1) & mask) {
+         auto const& s = slots_[i];
+         if (s.id == empty) {
+            return std::nullopt;
+         }
+         if (s.hash == short_hash and s.spelling == spelling) {
+            return s.id;
+         }
+      }
+   }
+
+   void hash_index::insert(std::uint64_t const hash, std::string_view const spelling,
+      std::uint32_t const id)
+   {
+      if (2 * (size_ + 1) > slots_.size()) {
+         grow();
+      }
+
+      auto const mask = slots_.size() - 1;
+      auto i = static_cast<std::size_t>(hash) & mask;
+      while (slots_[i].id != empty) {
+         i = (i + 1) & mask;
+      }
+      slots_[i] = slot{spelling, static_cast<std::uint32_t>(hash >> 32), id};
+      ++size_;
+   }
+
+   void hash_index::grow()
+   {
+      auto const size = std::max(slots_.size() * 2, std::size_t{64});
+      auto old = std::exchange(slots_, std::pmr::vector<slot>(size, slots_.get_allocator()));
+      size_ = 0;
+      for (auto const& s : old) {
+         if (s.id != empty) {
+            // The low half of the hash isn't kept, so it's recomputed.
+            insert(hash_spelling(s.spelling), s.spelling, s.id);
+         }
+      }
+   }
+} // namespace ltcpp::detail_lexer
+
+namespace ltcpp {
+   interner::interner(std::pmr::memory_resource* const memory)
+      : arena_{memory}
+      , index_{memory}
+      , spellings_{memory}
+   {}
+
+   symbol interner::intern(std::string_view const spelling)
+   {
+      auto const hash = detail_lexer::hash_spelling(spelling);
+      if (auto const existing = index_.find(hash, spelling)) {
+         return symbol{*existing};
+      }
+
+      auto const id = static_cast<std::uint32_t>(spellings_.size());
+      auto const stored = arena_.copy(spelling);
+      index_.insert(hash, stored, id);
+      spellings_.push_back(stored);
+      return symbol{id};
+   }
+
+   std::optional<symbol> interner::find(std::string_view const spelling) const noexcept
+   {
+      auto const id = index_.find(detail_lexer::hash_spelling(spelling), spelling);
+      return id ? std::optional{symbol{*id}} : std::nullopt;
+   }
+
+   concurrent_interner::~concurrent_interner()
+   {
+      for (auto& segment : segments_) {
+         delete[] segment.load(std::memory_order_relaxed);
+      }
+   }
+
+   symbol concurrent_interner::intern(std::string_view const spelling)
+   {
+      auto const hash = detail_lexer::hash_spelling(spelling);
+      auto& s = shards_[hash >> (64 - shard_bits)];
+      auto const lock = std::scoped_lock{s.mutex};
+      if (auto const existing = s.index.find(hash, spelling)) {
+         return symbol{*existing};
+      }
+
+      auto const id = next_.fetch_add(1, std::memory_order_relaxed);
+      auto const stored = s.arena.copy(spelling);
+      entry(id) = stored;
+      s.index.insert(hash, stored, id);
+      return symbol{id};
+   }
+
+   std::optional<symbol> concurrent_interner::find(std::string_view const spelling) const
+   {
+      auto const hash = detail_lexer::hash_spelling(spelling);
+      auto const& s = shards_[hash >> (64 - shard_bits)];
+      auto const lock = std::scoped_lock{s.mutex};
+      auto const id = s.index.find(hash, spelling);
+      return id ? std::optional{symbol{*id}} : std::nullopt;
+   }
+
+   std::string_view concurrent_interner::spelling(symbol const s) const noexcept
+   { return entry(static_cast<std::uint32_t>(s)); }
+
+   std::string_view& concurrent_interner::entry(std::uint32_t const id) const
+   {
+      auto const index = std::size_t{id} / first_segment_size + 1;
+      auto const k = static_cast<std::size_t>(std::bit_width(index)) - 1;
+      auto const offset = std::size_t{id} - first_segment_size * ((std::size_t{1} << k) - 1);
+
+      auto* segment = segments_[k].load(std::memory_order_acquire);
+      if (segment == nullptr) {
+         // Whichever thread publishes a segment first wins; the others discard theirs.
+         auto fresh = std::make_unique<std::string_view[]>(first_segment_size << k);
+         if (segments_[k].compare_exchange_strong(segment, fresh.get(), std::memory_order_acq_rel)) {
+            segment = fresh.release();
+         }
+      }
+      return segment[offset];
+   }
+} // namespace ltcpp
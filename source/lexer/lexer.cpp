@@ -0,0 +1,209 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer.hpp"
+
+#include "ltcpp/lexer/chunked_source.hpp"
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/detail/scan_identifier.hpp"
+#include "ltcpp/lexer/detail/scan_number.hpp"
+#include "ltcpp/lexer/detail/scan_string_literal.hpp"
+#include "ltcpp/lexer/detail/scan_symbol.hpp"
+#include "ltcpp/lexer/detail/scan_token.hpp"
+#include "ltcpp/lexer/detail/scan_whitespace.hpp"
+#include "ltcpp/lexer/lexer_state.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <istream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace ltcpp {
+   namespace {
+      using detail_lexer::char_traits;
+      using detail_lexer::int_type;
+
+      int_type peek(std::istream& in) noexcept
+      { return in.peek(); }
+
+      int_type peek(std::string_view const in) noexcept
+      { return in.empty() ? char_traits::eof() : char_traits::to_int_type(in.front()); }
+
+      /// The result of scanning one token, before anything has been reported.
+      ///
+      struct lexed_token {
+         std::optional<detail_lexer::unterminated_comment_error> comment_error;
+         token result;
+      };
+
+      void report_lexical_errors(reporter& report, lexed_token const& lexed) noexcept
+      {
+         if (lexed.comment_error) {
+            detail_lexer::report_unterminated_comment(report, lexed.comment_error->begin());
+         }
+         detail_lexer::report_token_error(report, lexed.result, lexed.result.position().begin());
+      }
+
+      /// `Input` is either a std::istream or a std::string_view, and each scanner is overloaded
+      /// for both.
+      ///
+      template<class Input>
+      token scan_token_impl(Input& in, int_type const c, source_coordinate const cursor) noexcept
+      {
+         return detail_lexer::is_digit(c)           ? detail_lexer::scan_number(in, cursor)
+              : detail_lexer::is_identifier_head(c) ? detail_lexer::scan_identifier(in, cursor)
+              : c == '"'                            ? detail_lexer::scan_string_literal(in, cursor)
+              : c == '\''                           ? detail_lexer::scan_character_literal(in, cursor)
+                                                    : detail_lexer::scan_symbol(in, cursor);
+      }
+
+      template<class Input>
+      lexed_token lex_token(Input& in, source_coordinate cursor) noexcept
+      {
+         auto comment_error = std::optional<detail_lexer::unterminated_comment_error>{};
+         if (auto const whitespace = detail_lexer::scan_whitespace_like(in, cursor)) {
+            cursor = *whitespace;
+         }
+         else {
+            comment_error = whitespace.error();
+            cursor = whitespace.error().end();
+         }
+
+         auto const c = peek(in);
+         if (c == char_traits::eof()) {
+            return {comment_error, token{borrowed_spelling, token_kind::eof, eof_spelling, cursor, cursor}};
+         }
+
+         return {comment_error, scan_token_impl(in, c, cursor)};
+      }
+
+      /// The chunked source reuses its window once it's been consumed, so tokens scanned from it
+      /// can't refer to their spellings in place.
+      ///
+      token with_owned_spelling(token t)
+      {
+         t.own_spelling();
+         return t;
+      }
+
+      template<class Input>
+      token generate_token_impl(Input& in, reporter& report, source_coordinate const cursor) noexcept
+      {
+         auto lexed = lex_token(in, cursor);
+         report_lexical_errors(report, lexed);
+         return std::move(lexed.result);
+      }
+   } // namespace
+
+   namespace detail_lexer {
+      token scan_token(std::string_view& in, source_coordinate const cursor) noexcept
+      { return scan_token_impl(in, peek(in), cursor); }
+
+      void report_token_error(reporter& report, token const& t, source_coordinate const where) noexcept
+      {
+         auto const error = [&](std::string_view const message) {
+            report.error(pass::lexical, where, message, ": \"", t.spelling(), "\".");
+         };
+
+         switch (t.kind()) {
+         case token_kind::unknown_token:
+            error("unknown token");
+            break;
+         case token_kind::unterminated_string_literal:
+            error("unterminated string literal");
+            break;
+         case token_kind::invalid_escape_sequence:
+            error("invalid escape sequence in string literal");
+            break;
+         case token_kind::too_many_radix_points:
+            error("too many radix points in floating-point literal");
+            break;
+         case token_kind::exponent_lacking_digit:
+            error("floating-point exponent lacking digits");
+            break;
+         default:
+            break;
+         }
+      }
+
+      void report_unterminated_comment(reporter& report, source_coordinate const begin) noexcept
+      { report.error(pass::lexical, begin, "unterminated multi-line comment."); }
+   } // namespace detail_lexer
+
+   token generate_token(std::istream& in, reporter& report, source_coordinate const cursor) noexcept(false)
+   {
+      auto result = generate_token_impl(in, report, cursor);
+      if (in.fail() and not in.eof()) {
+         throw std::runtime_error{"unable to read from the source stream"};
+      }
+      return result;
+   }
+
+   token generate_token(std::string_view& in, reporter& report, source_coordinate const cursor) noexcept
+   { return generate_token_impl(in, report, cursor); }
+
+   std::optional<token> generate_token(std::string_view& in, lexer_state& state, reporter& report,
+      bool const end_of_source) noexcept
+   {
+      if (auto const whitespace = detail_lexer::resume_whitespace_like(in, state, end_of_source)) {
+         if (not *whitespace) {
+            return std::nullopt;
+         }
+      }
+      else {
+         detail_lexer::report_unterminated_comment(report, whitespace.error().begin());
+      }
+
+      if (in.empty()) {
+         return token{borrowed_spelling, token_kind::eof, eof_spelling, state.cursor, state.cursor};
+      }
+
+      // Every scanner stops at the first character that can't belong to its token, and needs no
+      // more than one character of lookahead, so a token can only continue past the end of `in`
+      // if it consumed all of it. In that case nothing is consumed, and the token is scanned again
+      // once more of the source is available.
+      auto unscanned = in;
+      auto result = detail_lexer::scan_token(unscanned, state.cursor);
+      if (unscanned.empty() and not end_of_source) {
+         return std::nullopt;
+      }
+
+      detail_lexer::report_token_error(report, result, state.cursor);
+      state.offset += in.size() - unscanned.size();
+      state.cursor = result.position().end();
+      in = unscanned;
+      return result;
+   }
+
+   token generate_token(chunked_source& in, reporter& report, source_coordinate const cursor) noexcept(false)
+   {
+      // Whitespace and comments are consumed as they're skipped, so a comment that spans many
+      // windows is only scanned once.
+      auto state = lexer_state{.cursor = cursor};
+      for (;;) {
+         auto unscanned = in.unscanned();
+         auto result = generate_token(unscanned, state, report, in.exhausted());
+         in.consume(in.unscanned().size() - unscanned.size());
+         if (result) {
+            return with_owned_spelling(std::move(*result));
+         }
+         in.refill();
+      }
+   }
+} // namespace ltcpp
@@ -0,0 +1,129 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_dfa.hpp"
+
+#include "ltcpp/lexer/detail/keywords.hpp"
+#include "ltcpp/lexer/detail/lingua_dfa.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace ltcpp::detail_lexer {
+   namespace {
+      namespace dfa = lingua_dfa;
+
+      /// The punctuation terminals, which aren't spelt like identifiers.
+      ///
+      constexpr auto symbols = std::array{
+         keyword{"+", token_kind::plus},
+         keyword{"-", token_kind::minus},
+         keyword{"++", token_kind::increment},
+         keyword{"--", token_kind::decrement},
+         keyword{"*", token_kind::times},
+         keyword{"/", token_kind::divide},
+         keyword{"%", token_kind::modulo},
+         keyword{"<-", token_kind::assign},
+         keyword{".", token_kind::dot},
+         keyword{",", token_kind::comma},
+         keyword{":", token_kind::colon},
+         keyword{";", token_kind::semicolon},
+         keyword{"{", token_kind::brace_open},
+         keyword{"}", token_kind::brace_close},
+         keyword{"(", token_kind::paren_open},
+         keyword{")", token_kind::paren_close},
+         keyword{"[", token_kind::square_open},
+         keyword{"]", token_kind::square_close},
+         keyword{"->", token_kind::arrow},
+         keyword{"=", token_kind::equal_to},
+         keyword{"!=", token_kind::not_equal_to},
+         keyword{"<", token_kind::less},
+         keyword{"<=", token_kind::less_equal},
+         keyword{">", token_kind::greater},
+         keyword{">=", token_kind::greater_equal},
+      };
+
+      /// The lexer rules whose terminals match more than one spelling.
+      ///
+      constexpr auto patterns = std::array{
+         keyword{"IDENTIFIER", token_kind::identifier},
+         keyword{"CHARACTER_LITERAL", token_kind::character_literal},
+         keyword{"FLOATING_LITERAL", token_kind::floating_literal},
+         keyword{"INTEGRAL_LITERAL", token_kind::integral_literal},
+         keyword{"STRING_LITERAL", token_kind::string_literal},
+      };
+
+      template<std::size_t N>
+      constexpr token_kind find_kind(std::array<keyword, N> const& table, std::string_view const key) noexcept
+      {
+         auto const match = std::find_if(table.begin(), table.end(),
+            [key](keyword const& k) { return k.spelling == key; });
+         return match == table.end() ? token_kind::unknown_token : match->kind;
+      }
+
+      constexpr token_kind terminal_kind(dfa::terminal const& t) noexcept
+      {
+         if (t.spelling.empty()) {
+            return find_kind(patterns, t.rule);
+         }
+
+         auto const kind = find_kind(keywords, t.spelling);
+         return kind != token_kind::unknown_token ? kind : find_kind(symbols, t.spelling);
+      }
+
+      constexpr auto terminal_kinds = [] {
+         auto result = std::array<token_kind, dfa::terminals.size()>{};
+         std::transform(dfa::terminals.begin(), dfa::terminals.end(), result.begin(), terminal_kind);
+         return result;
+      }();
+
+      static_assert(std::find(terminal_kinds.begin(), terminal_kinds.end(), token_kind::unknown_token)
+                    == terminal_kinds.end(),
+         "lingua.g4 has a terminal that doesn't map onto a token_kind.");
+   } // namespace
+
+   token scan_dfa(std::string_view& in, source_coordinate const cursor) noexcept
+   {
+      auto state = dfa::start_state;
+      auto accepted = dfa::no_terminal;
+      auto accepted_size = std::size_t{0};
+      for (auto i = std::size_t{0}; i != in.size();) {
+         auto const column = dfa::byte_class[static_cast<unsigned char>(in[i])];
+         state = dfa::transitions[state * dfa::class_count + column];
+         if (state == dfa::dead_state) {
+            break;
+         }
+
+         ++i;
+         if (auto const terminal = dfa::accepting_terminal[state]; terminal != dfa::no_terminal) {
+            accepted = terminal;
+            accepted_size = i;
+         }
+      }
+
+      if (accepted == dfa::no_terminal) {
+         auto const spelling = in.substr(0, 1);
+         in.remove_prefix(spelling.size());
+         return make_token(borrowed_spelling, spelling, cursor, token_kind::unknown_token);
+      }
+
+      auto const spelling = in.substr(0, accepted_size);
+      in.remove_prefix(accepted_size);
+      return make_token(borrowed_spelling, spelling, cursor, terminal_kinds[static_cast<std::size_t>(accepted)]);
+   }
+} // namespace ltcpp::detail_lexer
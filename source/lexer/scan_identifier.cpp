@@ -0,0 +1,58 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_identifier.hpp"
+
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/detail/simd.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace ltcpp::detail_lexer {
+   namespace {
+      template<CharacterSource Source>
+      token scan_identifier_impl(Source& in, source_coordinate const cursor) noexcept
+      {
+         if constexpr (ContiguousSource<Source>) {
+            auto const size = simd::count_identifier_tail(in.unscanned());
+            auto const spelling = in.unscanned().substr(0, size);
+            in.consume(size);
+            return make_token(borrowed_spelling, spelling, cursor, identifier_kind(spelling));
+         }
+         else {
+            auto spelling = lexeme{in};
+            while (is_identifier_tail(spelling.peek())) {
+               spelling.get();
+            }
+            return std::move(spelling).make_token(cursor, identifier_kind(spelling.view()));
+         }
+      }
+   } // namespace
+
+   token scan_identifier(std::istream& in, source_coordinate const cursor) noexcept
+   {
+      auto source = istream_source{in};
+      return scan_identifier_impl(source, cursor);
+   }
+
+   token scan_identifier(std::string_view& in, source_coordinate const cursor) noexcept
+   {
+      auto source = buffer_source{in};
+      return scan_identifier_impl(source, cursor);
+   }
+} // namespace ltcpp::detail_lexer
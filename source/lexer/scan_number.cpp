@@ -0,0 +1,73 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_number.hpp"
+
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <istream>
+#include <string_view>
+#include <utility>
+
+namespace ltcpp::detail_lexer {
+   namespace {
+      /// The value is left undecoded, for `token::decode_value` to decode if it's wanted.
+      ///
+      template<CharacterSource Source>
+      token scan_number_impl(Source& in, source_coordinate const cursor) noexcept
+      {
+         auto spelling = lexeme{in};
+         auto radix_points = 0;
+         for (auto c = spelling.peek(); is_digit(c) or c == '.'; c = spelling.peek()) {
+            radix_points += c == '.';
+            spelling.get();
+         }
+
+         auto has_exponent = false;
+         auto exponent_has_digits = false;
+         if (auto const e = spelling.peek(); e == 'e' or e == 'E') {
+            has_exponent = true;
+            spelling.get();
+            if (auto const sign = spelling.peek(); sign == '+' or sign == '-') {
+               spelling.get();
+            }
+
+            while (is_digit(spelling.peek())) {
+               exponent_has_digits = true;
+               spelling.get();
+            }
+         }
+
+         auto const kind = radix_points > 1                     ? token_kind::too_many_radix_points
+                         : has_exponent and not exponent_has_digits ? token_kind::exponent_lacking_digit
+                         : radix_points == 1 or has_exponent        ? token_kind::floating_literal
+                                                                    : token_kind::integral_literal;
+         return std::move(spelling).make_token(cursor, kind);
+      }
+   } // namespace
+
+   token scan_number(std::istream& in, source_coordinate const cursor) noexcept
+   {
+      auto source = istream_source{in};
+      return scan_number_impl(source, cursor);
+   }
+
+   token scan_number(std::string_view& in, source_coordinate const cursor) noexcept
+   {
+      auto source = buffer_source{in};
+      return scan_number_impl(source, cursor);
+   }
+} // namespace ltcpp::detail_lexer
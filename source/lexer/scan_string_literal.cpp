@@ -0,0 +1,115 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_string_literal.hpp"
+
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <istream>
+#include <string_view>
+#include <utility>
+
+namespace ltcpp::detail_lexer {
+   namespace {
+      constexpr bool ends_string_literal(int_type const c) noexcept
+      { return c == char_traits::eof() or c == '\n' or c == '\r'; }
+
+      /// The literal is spelled as written: escapes are only checked here, and are decoded by
+      /// `token::decoded_spelling` if they're ever needed.
+      ///
+      template<CharacterSource Source>
+      token scan_string_literal_impl(Source& in, source_coordinate const cursor) noexcept
+      {
+         auto spelling = lexeme{in};
+         spelling.get();
+         auto valid_escapes = true;
+
+         for (auto c = spelling.peek(); not ends_string_literal(c); c = spelling.peek()) {
+            spelling.get();
+            if (c == '"') {
+               auto const kind = valid_escapes ? token_kind::string_literal
+                                               : token_kind::invalid_escape_sequence;
+               return std::move(spelling).make_token(cursor, kind);
+            }
+
+            if (c != '\\') {
+               continue;
+            }
+
+            auto const escaped = spelling.peek();
+            if (ends_string_literal(escaped)) {
+               break;
+            }
+
+            spelling.get();
+            valid_escapes = valid_escapes and decode_escape(escaped).has_value();
+         }
+
+         return std::move(spelling).make_token(cursor, token_kind::unterminated_string_literal);
+      }
+
+      /// A character literal is a quote, then either `\"` or any one character that doesn't end a
+      /// line, then a quote. Anything else is an unknown token spelled by the characters that did
+      /// match, leaving the first one that didn't to be scanned next.
+      ///
+      template<CharacterSource Source>
+      token scan_character_literal_impl(Source& in, source_coordinate const cursor) noexcept
+      {
+         auto spelling = lexeme{in};
+         spelling.get();
+         auto const c = spelling.peek();
+         if (ends_string_literal(c)) {
+            return std::move(spelling).make_token(cursor, token_kind::unknown_token);
+         }
+
+         spelling.get();
+         if (c == '\\' and spelling.peek() == '"') {
+            spelling.get();
+         }
+
+         if (spelling.peek() != '\'') {
+            return std::move(spelling).make_token(cursor, token_kind::unknown_token);
+         }
+
+         spelling.get();
+         return std::move(spelling).make_token(cursor, token_kind::character_literal);
+      }
+   } // namespace
+
+   token scan_string_literal(std::istream& in, source_coordinate const cursor) noexcept
+   {
+      auto source = istream_source{in};
+      return scan_string_literal_impl(source, cursor);
+   }
+
+   token scan_string_literal(std::string_view& in, source_coordinate const cursor) noexcept
+   {
+      auto source = buffer_source{in};
+      return scan_string_literal_impl(source, cursor);
+   }
+
+   token scan_character_literal(std::istream& in, source_coordinate const cursor) noexcept
+   {
+      auto source = istream_source{in};
+      return scan_character_literal_impl(source, cursor);
+   }
+
+   token scan_character_literal(std::string_view& in, source_coordinate const cursor) noexcept
+   {
+      auto source = buffer_source{in};
+      return scan_character_literal_impl(source, cursor);
+   }
+} // namespace ltcpp::detail_lexer
@@ -0,0 +1,118 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_symbol.hpp"
+
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <istream>
+#include <string_view>
+#include <utility>
+
+namespace ltcpp::detail_lexer {
+   namespace {
+      /// Extracts `second` if it is the next character, producing a two-character token of kind
+      /// `matched`; otherwise produces a one-character token of kind `unmatched`.
+      ///
+      template<CharacterSource Source>
+      token scan_digraph(lexeme<Source>& spelling, char const second, token_kind const matched,
+         token_kind const unmatched, source_coordinate const cursor) noexcept
+      {
+         if (spelling.peek() == second) {
+            spelling.get();
+            return std::move(spelling).make_token(cursor, matched);
+         }
+         return std::move(spelling).make_token(cursor, unmatched);
+      }
+
+      template<CharacterSource Source>
+      token scan_symbol_impl(Source& in, source_coordinate const cursor) noexcept
+      {
+         auto spelling = lexeme{in};
+         auto const c = spelling.get();
+         if (c == char_traits::eof()) {
+            return std::move(spelling).make_token(cursor, token_kind::unknown_token);
+         }
+
+         auto const current = char_traits::to_char_type(c);
+         auto const single = [&](token_kind const kind) {
+            return std::move(spelling).make_token(cursor, kind);
+         };
+
+         switch (current) {
+         case '+':
+            return scan_digraph(spelling, '+', token_kind::increment, token_kind::plus, cursor);
+         case '-':
+            if (spelling.peek() == '-') {
+               return scan_digraph(spelling, '-', token_kind::decrement, token_kind::minus, cursor);
+            }
+            return scan_digraph(spelling, '>', token_kind::arrow, token_kind::minus, cursor);
+         case '*':
+            return single(token_kind::times);
+         case '/':
+            return single(token_kind::divide);
+         case '%':
+            return single(token_kind::modulo);
+         case '.':
+            return single(token_kind::dot);
+         case ',':
+            return single(token_kind::comma);
+         case ':':
+            return single(token_kind::colon);
+         case ';':
+            return single(token_kind::semicolon);
+         case '{':
+            return single(token_kind::brace_open);
+         case '}':
+            return single(token_kind::brace_close);
+         case '(':
+            return single(token_kind::paren_open);
+         case ')':
+            return single(token_kind::paren_close);
+         case '[':
+            return single(token_kind::square_open);
+         case ']':
+            return single(token_kind::square_close);
+         case '=':
+            return single(token_kind::equal_to);
+         case '!':
+            return scan_digraph(spelling, '=', token_kind::not_equal_to, token_kind::unknown_token,
+               cursor);
+         case '<':
+            if (spelling.peek() == '-') {
+               return scan_digraph(spelling, '-', token_kind::assign, token_kind::less, cursor);
+            }
+            return scan_digraph(spelling, '=', token_kind::less_equal, token_kind::less, cursor);
+         case '>':
+            return scan_digraph(spelling, '=', token_kind::greater_equal, token_kind::greater, cursor);
+         default:
+            return single(token_kind::unknown_token);
+         }
+      }
+   } // namespace
+
+   token scan_symbol(std::istream& in, source_coordinate const cursor) noexcept
+   {
+      auto source = istream_source{in};
+      return scan_symbol_impl(source, cursor);
+   }
+
+   token scan_symbol(std::string_view& in, source_coordinate const cursor) noexcept
+   {
+      auto source = buffer_source{in};
+      return scan_symbol_impl(source, cursor);
+   }
+} // namespace ltcpp::detail_lexer
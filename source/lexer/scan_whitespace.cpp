@@ -0,0 +1,329 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_whitespace.hpp"
+
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/detail/simd.hpp"
+#include "ltcpp/lexer/lexer_state.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string_view>
+#include <tl/expected.hpp>
+
+namespace ltcpp::detail_lexer {
+   namespace {
+      using scan_result = tl::expected<source_coordinate, unterminated_comment_error>;
+
+      /// A buffer_source over a window onto the source, which may stop part way through it.
+      ///
+      class window_source : public buffer_source {
+      public:
+         window_source(std::string_view& in, bool const end_of_source) noexcept
+            : buffer_source{in}
+            , end_of_source_{end_of_source}
+         {}
+
+         /// Returns whether the window ends within the next n characters but the source doesn't.
+         ///
+         bool ends_within(std::size_t const n) const noexcept
+         { return not end_of_source_ and unscanned().size() < n; }
+      private:
+         bool end_of_source_;
+      };
+
+      /// Returns whether in is a window that ends within the next n characters, so that the
+      /// scanners must stop rather than guess at what comes after it.
+      ///
+      template<CharacterSource Source>
+      bool ends_within(Source const& in, std::size_t const n) noexcept
+      {
+         if constexpr (std::same_as<Source, window_source>) {
+            return in.ends_within(n);
+         }
+         else {
+            return false;
+         }
+      }
+
+      /// A cursor that keeps no coordinates, for skipping whitespace without working out where it
+      /// ends. Moving it does nothing.
+      ///
+      struct no_coordinate {};
+
+      using detail_lexer::advance_column;
+      using detail_lexer::advance_line;
+
+      constexpr no_coordinate advance_column(no_coordinate, std::intmax_t = 1) noexcept
+      { return {}; }
+
+      constexpr no_coordinate advance_line(no_coordinate) noexcept
+      { return {}; }
+
+      constexpr source_coordinate shift(source_coordinate const cursor,
+         source_coordinate const distance) noexcept
+      { return source_coordinate::shift(cursor, distance); }
+
+      constexpr no_coordinate shift(no_coordinate, source_coordinate) noexcept
+      { return {}; }
+
+      /// Where a scan of whitespace and comments has got to, as a Cursor.
+      ///
+      template<class Cursor>
+      struct whitespace_scan {
+         Cursor cursor = Cursor{};
+         Cursor comment_begin = Cursor{};
+         lexer_mode mode = lexer_mode::between_tokens;
+
+         // The "/*" comment being skipped, through to the end of the source, if the source is
+         // contiguous and the comment began during this scan.
+         std::string_view comment = {};
+      };
+
+      /// Moves the cursor past a character that has already been consumed.
+      ///
+      /// "\n", "\r\n", "\n\r" and "\f" each end a line; a lone "\r" occupies a column.
+      ///
+      /// \pre If in is a window, it doesn't end right after c.
+      ///
+      template<CharacterSource Source, class Cursor>
+      Cursor advance(Source& in, int_type const c, Cursor const cursor) noexcept
+      {
+         switch (c) {
+         case '\n':
+            if (in.peek() == '\r') {
+               in.get();
+            }
+            return advance_line(cursor);
+         case '\r':
+            if (in.peek() == '\n') {
+               in.get();
+               return advance_line(cursor);
+            }
+            return advance_column(cursor);
+         case '\f':
+            return advance_line(cursor);
+         default:
+            return advance_column(cursor);
+         }
+      }
+
+      /// Consumes the body of a "//" comment, leaving the line break for the caller. Stops before
+      /// a '\r' that a window ends after, since it might begin "\r\n".
+      ///
+      template<CharacterSource Source, class Cursor>
+      Cursor scan_line_comment(Source& in, Cursor cursor) noexcept
+      {
+         for (;;) {
+            if constexpr (ContiguousSource<Source>) {
+               auto const n = simd::find_line_break(in.unscanned());
+               in.consume(n);
+               cursor = advance_column(cursor, static_cast<std::intmax_t>(n));
+            }
+
+            auto const c = in.peek();
+            if (c == char_traits::eof() or c == '\n' or c == '\f' or ends_within(in, 2)) {
+               break;
+            }
+
+            in.get();
+            if (c == '\r' and in.peek() == '\n') {
+               in.unget();
+               break;
+            }
+            cursor = advance_column(cursor);
+         }
+         return cursor;
+      }
+
+      /// Consumes the rest of a "/*" comment's body and its terminating "*/", given the cursor of
+      /// the first character that's left.
+      ///
+      /// \returns The cursor just past the "*/", or the cursor that the comment stopped at, if in
+      ///          ran out first.
+      ///
+      template<CharacterSource Source, class Cursor>
+      tl::expected<Cursor, Cursor> scan_block_comment(Source& in, Cursor cursor) noexcept
+      {
+         for (;;) {
+            if constexpr (ContiguousSource<Source>) {
+               auto const skipped = simd::skip_block_comment_text(in.unscanned());
+               in.consume(skipped.size);
+               cursor = shift(cursor, skipped.distance);
+            }
+
+            auto const c = in.peek();
+            if (c == char_traits::eof() or ends_within(in, 2)) {
+               return tl::make_unexpected(cursor);
+            }
+
+            in.get();
+            if (c == '*' and in.peek() == '/') {
+               in.get();
+               return advance_column(cursor, 2);
+            }
+            cursor = advance(in, c, cursor);
+         }
+      }
+
+      /// Skips whitespace and comments from where scan left off.
+      ///
+      /// \returns false if in is a window that ended first, and true otherwise, in which case
+      ///          `scan.mode` is `lexer_mode::in_block_comment` only if the source ended inside
+      ///          a "/*" comment.
+      ///
+      template<CharacterSource Source, class Cursor>
+      bool resume_whitespace_like_impl(Source& in, whitespace_scan<Cursor>& scan) noexcept
+      {
+         for (;;) {
+            switch (scan.mode) {
+            case lexer_mode::between_tokens:
+               switch (auto const c = in.peek(); c) {
+               case ' ':
+               case '\t':
+                  if constexpr (ContiguousSource<Source>) {
+                     auto const n = simd::count_blanks(in.unscanned());
+                     in.consume(n);
+                     scan.cursor = advance_column(scan.cursor, static_cast<std::intmax_t>(n));
+                     break;
+                  }
+                  [[fallthrough]];
+               case '\n':
+               case '\r':
+               case '\f':
+                  if (ends_within(in, 2)) {
+                     return false;
+                  }
+                  in.get();
+                  scan.cursor = advance(in, c, scan.cursor);
+                  break;
+               case '/':
+                  if (ends_within(in, 2)) {
+                     return false;
+                  }
+
+                  in.get();
+                  if (auto const next = in.peek(); next == '/') {
+                     in.get();
+                     scan.cursor = advance_column(scan.cursor, 2);
+                     scan.mode = lexer_mode::in_line_comment;
+                  }
+                  else if (next == '*') {
+                     in.get();
+                     if constexpr (ContiguousSource<Source>) {
+                        auto const rest = in.unscanned();
+                        scan.comment = std::string_view{rest.data() - 2, rest.size() + 2};
+                     }
+                     scan.comment_begin = scan.cursor;
+                     scan.cursor = advance_column(scan.cursor, 2);
+                     scan.mode = lexer_mode::in_block_comment;
+                  }
+                  else {
+                     in.unget();
+                     return true;
+                  }
+                  break;
+               default:
+                  return c != char_traits::eof() or not ends_within(in, 1);
+               }
+               break;
+            case lexer_mode::in_line_comment:
+               scan.cursor = scan_line_comment(in, scan.cursor);
+               if (ends_within(in, 2)) {
+                  return false;
+               }
+               scan.mode = lexer_mode::between_tokens;
+               break;
+            case lexer_mode::in_block_comment: {
+               auto const comment = scan_block_comment(in, scan.cursor);
+               if (not comment) {
+                  scan.cursor = comment.error();
+                  return not ends_within(in, 2);
+               }
+               scan.cursor = *comment;
+               scan.mode = lexer_mode::between_tokens;
+               break;
+            }
+            }
+         }
+      }
+
+      template<CharacterSource Source>
+      scan_result scan_whitespace_like_impl(Source& in, source_coordinate const cursor) noexcept
+      {
+         auto scan = whitespace_scan<source_coordinate>{.cursor = cursor};
+         resume_whitespace_like_impl(in, scan);
+         if (scan.mode == lexer_mode::in_block_comment) {
+            return tl::make_unexpected(unterminated_comment_error{scan.comment_begin, scan.cursor});
+         }
+         return scan.cursor;
+      }
+   } // namespace
+
+   tl::expected<source_coordinate, unterminated_comment_error>
+   scan_whitespace_like(std::istream& in, source_coordinate const cursor) noexcept
+   {
+      auto source = istream_source{in};
+      return scan_whitespace_like_impl(source, cursor);
+   }
+
+   tl::expected<source_coordinate, unterminated_comment_error>
+   scan_whitespace_like(std::string_view& in, source_coordinate const cursor) noexcept
+   {
+      auto source = buffer_source{in};
+      return scan_whitespace_like_impl(source, cursor);
+   }
+
+   std::optional<std::string_view> skip_whitespace_like(std::string_view& in) noexcept
+   {
+      auto source = buffer_source{in};
+      auto scan = whitespace_scan<no_coordinate>{};
+      resume_whitespace_like_impl(source, scan);
+      if (scan.mode == lexer_mode::in_block_comment) {
+         return scan.comment;
+      }
+      return std::nullopt;
+   }
+
+   tl::expected<bool, unterminated_comment_error>
+   resume_whitespace_like(std::string_view& in, lexer_state& state, bool const end_of_source) noexcept
+   {
+      auto const size = in.size();
+      auto source = window_source{in, end_of_source};
+      auto scan = whitespace_scan<source_coordinate>{
+         .cursor = state.cursor,
+         .comment_begin = state.comment_begin,
+         .mode = state.mode,
+      };
+      auto const finished = resume_whitespace_like_impl(source, scan);
+      state.offset += size - in.size();
+      state.cursor = scan.cursor;
+      state.comment_begin = scan.comment_begin;
+      state.mode = scan.mode;
+      if (not finished) {
+         return false;
+      }
+
+      if (scan.mode == lexer_mode::in_block_comment) {
+         state.mode = lexer_mode::between_tokens;
+         return tl::make_unexpected(unterminated_comment_error{scan.comment_begin, scan.cursor});
+      }
+      return true;
+   }
+} // namespace ltcpp::detail_lexer
@@ -0,0 +1,525 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/simd.hpp"
+
+#include "ltcpp/source_coordinate.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// SSE2 is part of the x86-64 baseline, so only AVX2 needs to be checked for at run time.
+#ifdef __x86_64__
+   #define LTCPP_SIMD_X86 1
+   #include <immintrin.h>
+#endif // __x86_64__
+
+namespace ltcpp::detail_lexer::simd {
+   namespace {
+      /// Scalar implementations. The vector kernels use these for the bytes that don't fill a
+      /// whole register, so they must never read past the end of the text.
+      ///
+      constexpr bool is_blank(char const c) noexcept
+      { return c == ' ' or c == '\t'; }
+
+      constexpr bool is_identifier_tail(char const c) noexcept
+      {
+         return ('a' <= c and c <= 'z') or ('A' <= c and c <= 'Z') or ('0' <= c and c <= '9')
+             or c == '_';
+      }
+
+      constexpr bool is_line_break(char const c) noexcept
+      { return c == '\n' or c == '\r' or c == '\f'; }
+
+      std::size_t count_blanks_scalar(std::string_view const text, std::size_t i) noexcept
+      {
+         while (i < text.size() and is_blank(text[i])) {
+            ++i;
+         }
+         return i;
+      }
+
+      std::size_t count_identifier_tail_scalar(std::string_view const text, std::size_t i) noexcept
+      {
+         while (i < text.size() and is_identifier_tail(text[i])) {
+            ++i;
+         }
+         return i;
+      }
+
+      std::size_t find_line_break_scalar(std::string_view const text, std::size_t i) noexcept
+      {
+         while (i < text.size() and not is_line_break(text[i])) {
+            ++i;
+         }
+         return i;
+      }
+
+      /// Records the line that the break at `text[i]` ends, if it ends one, pairing it with the
+      /// character after it where that makes "\r\n" or "\n\r". Returns the offset of the first
+      /// character that hasn't been accounted for.
+      ///
+      std::size_t add_line_start(std::string_view const text, std::size_t const i,
+         std::pmr::vector<std::uint32_t>& starts)
+      {
+         auto const c = text[i];
+         auto const next = i + 1 < text.size() ? text[i + 1] : '\0';
+         if ((c == '\n' and next == '\r') or (c == '\r' and next == '\n')) {
+            starts.push_back(static_cast<std::uint32_t>(i + 2));
+            return i + 2;
+         }
+
+         if (c != '\r') {
+            starts.push_back(static_cast<std::uint32_t>(i + 1));
+         }
+         return i + 1;
+      }
+
+      void append_line_starts_scalar(std::string_view const text, std::size_t i,
+         std::pmr::vector<std::uint32_t>& starts)
+      {
+         while (i < text.size()) {
+            i = is_line_break(text[i]) ? add_line_start(text, i, starts) : i + 1;
+         }
+      }
+
+      /// Classifies `text[first, first + 64)`, of which only the characters before the end of text
+      /// exist.
+      ///
+      character_masks classify_block_scalar(std::string_view const text, std::size_t const first) noexcept
+      {
+         auto result = character_masks{};
+         auto const last = std::min(first + 64, text.size());
+         for (auto i = first; i != last; ++i) {
+            auto const bit = std::uint64_t{1} << (i - first);
+            switch (text[i]) {
+            case '\n':
+            case '\r':
+            case '\f':
+               result.line_break |= bit;
+               [[fallthrough]];
+            case ' ':
+            case '\t':
+               result.blank |= bit;
+               break;
+            case '"':
+               result.quote |= bit;
+               break;
+            case '\'':
+               result.apostrophe |= bit;
+               break;
+            case '\\':
+               result.backslash |= bit;
+               break;
+            case '/':
+               result.slash |= bit;
+               break;
+            case '*':
+               result.star |= bit;
+               break;
+            default:
+               break;
+            }
+         }
+         result.blank |= last - first == 64 ? 0 : ~std::uint64_t{0} << (last - first);
+         return result;
+      }
+
+      void classify_blocks_scalar(std::string_view const text, std::span<character_masks> const masks,
+         std::size_t b) noexcept
+      {
+         for (; b != masks.size(); ++b) {
+            masks[b] = classify_block_scalar(text, b * 64);
+         }
+      }
+
+      /// Tracks a block comment prefix as it's skipped: `columns` counts the characters since the
+      /// last '\n', or since the beginning if there hasn't been one.
+      ///
+      struct block_progress {
+         std::size_t size = 0;
+         std::intmax_t lines = 0;
+         std::intmax_t columns = 0;
+      };
+
+      skipped_text to_skipped_text(block_progress const progress) noexcept
+      {
+         using line_type = source_coordinate::line_type;
+         using column_type = source_coordinate::column_type;
+         return {
+            progress.size,
+            progress.lines == 0
+               ? source_coordinate{line_type{0}, column_type{progress.columns}}
+               : source_coordinate{line_type{progress.lines}, column_type{progress.columns + 1}}
+         };
+      }
+
+      skipped_text skip_block_comment_text_scalar(std::string_view const text,
+         block_progress progress) noexcept
+      {
+         for (; progress.size < text.size(); ++progress.size) {
+            auto const c = text[progress.size];
+            if (c == '*' or c == '\r' or c == '\f') {
+               break;
+            }
+
+            if (c == '\n') {
+               // "\n\r" is a single line break, so it's left for the scalar scanner to pair up.
+               if (progress.size + 1 == text.size() or text[progress.size + 1] == '\r') {
+                  break;
+               }
+               ++progress.lines;
+               progress.columns = 0;
+            }
+            else {
+               ++progress.columns;
+            }
+         }
+         return to_skipped_text(progress);
+      }
+
+      /// Vector implementations, written once over an instruction set `ISA` that provides:
+      ///   * `width`, the number of bytes in a register;
+      ///   * `all`, the bitmask with one bit set for each of those bytes;
+      ///   * `match(p, c)`, a bitmask with bit i set when p[i] equals c, for i < `width`; and
+      ///   * `match_identifier_tail(p)`, a bitmask with bit i set when p[i] is a letter, digit, or
+      ///     '_', for i < `width`.
+      ///
+      /// `match` loads from memory rather than taking a register so that no vector type crosses a
+      /// function boundary; the repeated loads are merged once the kernel is inlined.
+      ///
+      template<class ISA>
+      inline std::size_t count_blanks_kernel(std::string_view const text) noexcept
+      {
+         auto i = std::size_t{0};
+         for (; i + ISA::width <= text.size(); i += ISA::width) {
+            auto const block = text.data() + i;
+            auto const blanks = ISA::match(block, ' ') | ISA::match(block, '\t');
+            if (blanks != ISA::all) {
+               return i + static_cast<std::size_t>(std::countr_one(blanks));
+            }
+         }
+         return count_blanks_scalar(text, i);
+      }
+
+      template<class ISA>
+      inline std::size_t count_identifier_tail_kernel(std::string_view const text) noexcept
+      {
+         auto i = std::size_t{0};
+         for (; i + ISA::width <= text.size(); i += ISA::width) {
+            auto const tail = ISA::match_identifier_tail(text.data() + i);
+            if (tail != ISA::all) {
+               return i + static_cast<std::size_t>(std::countr_one(tail));
+            }
+         }
+         return count_identifier_tail_scalar(text, i);
+      }
+
+      template<class ISA>
+      inline std::size_t find_line_break_kernel(std::string_view const text) noexcept
+      {
+         auto i = std::size_t{0};
+         for (; i + ISA::width <= text.size(); i += ISA::width) {
+            auto const block = text.data() + i;
+            auto const breaks = ISA::match(block, '\n') | ISA::match(block, '\r') | ISA::match(block, '\f');
+            if (breaks != 0) {
+               return i + static_cast<std::size_t>(std::countr_zero(breaks));
+            }
+         }
+         return find_line_break_scalar(text, i);
+      }
+
+      template<class ISA>
+      inline void append_line_starts_kernel(std::string_view const text, std::pmr::vector<std::uint32_t>& starts)
+      {
+         // A break that pairs with the first character of the following block accounts for that
+         // character too, so the next block starts wherever the last break left off.
+         auto resume = std::size_t{0};
+         for (auto i = std::size_t{0}; i + ISA::width <= text.size(); i += ISA::width) {
+            auto const block = text.data() + i;
+            auto breaks = ISA::match(block, '\n') | ISA::match(block, '\r') | ISA::match(block, '\f');
+            for (; breaks != 0; breaks &= breaks - 1) {
+               auto const at = i + static_cast<std::size_t>(std::countr_zero(breaks));
+               if (at >= resume) {
+                  resume = add_line_start(text, at, starts);
+               }
+            }
+            resume = std::max(resume, i + ISA::width);
+         }
+         append_line_starts_scalar(text, resume, starts);
+      }
+
+      template<class ISA>
+      inline skipped_text skip_block_comment_text_kernel(std::string_view const text) noexcept
+      {
+         auto progress = block_progress{};
+         while (progress.size + ISA::width <= text.size()) {
+            auto const block = text.data() + progress.size;
+            auto const stops = ISA::match(block, '*') | ISA::match(block, '\r') | ISA::match(block, '\f');
+            auto const newlines = ISA::match(block, '\n');
+
+            auto skip = stops == 0 ? ISA::width : static_cast<std::size_t>(std::countr_zero(stops));
+            // A '\n' that's immediately followed by '\r', or by a character in the next block, is
+            // left for the next step so that "\n\r" is never split.
+            if (skip > 0 and ((newlines >> (skip - 1)) & 1u) != 0
+                and (skip == ISA::width or text[progress.size + skip] == '\r')) {
+               --skip;
+            }
+
+            auto const skipped_newlines = static_cast<std::uint32_t>(
+               newlines & ((std::uint64_t{1} << skip) - 1));
+            if (skipped_newlines != 0) {
+               progress.lines += std::popcount(skipped_newlines);
+               progress.columns = static_cast<std::intmax_t>(skip)
+                                - static_cast<std::intmax_t>(std::bit_width(skipped_newlines));
+            }
+            else {
+               progress.columns += static_cast<std::intmax_t>(skip);
+            }
+            progress.size += skip;
+
+            if (stops != 0) {
+               return to_skipped_text(progress);
+            }
+         }
+         return skip_block_comment_text_scalar(text, progress);
+      }
+
+      template<class ISA>
+      inline character_masks classify_block_kernel(char const* const block) noexcept
+      {
+         auto result = character_masks{};
+         for (auto i = std::size_t{0}; i != 64; i += ISA::width) {
+            auto const p = block + i;
+            auto const line_break = ISA::match(p, '\n') | ISA::match(p, '\r') | ISA::match(p, '\f');
+            result.line_break |= std::uint64_t{line_break} << i;
+            result.blank |= std::uint64_t{line_break | ISA::match(p, ' ') | ISA::match(p, '\t')} << i;
+            result.quote |= std::uint64_t{ISA::match(p, '"')} << i;
+            result.apostrophe |= std::uint64_t{ISA::match(p, '\'')} << i;
+            result.backslash |= std::uint64_t{ISA::match(p, '\\')} << i;
+            result.slash |= std::uint64_t{ISA::match(p, '/')} << i;
+            result.star |= std::uint64_t{ISA::match(p, '*')} << i;
+         }
+         return result;
+      }
+
+      template<class ISA>
+      inline void classify_blocks_kernel(std::string_view const text, std::span<character_masks> const masks) noexcept
+      {
+         auto const whole = text.size() / 64;
+         for (auto b = std::size_t{0}; b != whole; ++b) {
+            masks[b] = classify_block_kernel<ISA>(text.data() + b * 64);
+         }
+         classify_blocks_scalar(text, masks, whole);
+      }
+
+      /// The kernels, bound to one instruction set.
+      ///
+      struct kernel_table {
+         instruction_set isa;
+         std::size_t (*count_blanks)(std::string_view) noexcept;
+         std::size_t (*count_identifier_tail)(std::string_view) noexcept;
+         std::size_t (*find_line_break)(std::string_view) noexcept;
+         skipped_text (*skip_block_comment_text)(std::string_view) noexcept;
+         void (*append_line_starts)(std::string_view, std::pmr::vector<std::uint32_t>&);
+         void (*classify_blocks)(std::string_view, std::span<character_masks>) noexcept;
+      };
+
+#ifndef LTCPP_SIMD_X86
+      constexpr auto scalar_kernels = kernel_table{
+         instruction_set::scalar,
+         [](std::string_view const text) noexcept { return count_blanks_scalar(text, 0); },
+         [](std::string_view const text) noexcept { return count_identifier_tail_scalar(text, 0); },
+         [](std::string_view const text) noexcept { return find_line_break_scalar(text, 0); },
+         [](std::string_view const text) noexcept { return skip_block_comment_text_scalar(text, {}); },
+         [](std::string_view const text, std::pmr::vector<std::uint32_t>& starts) {
+            append_line_starts_scalar(text, 0, starts);
+         },
+         [](std::string_view const text, std::span<character_masks> const masks) noexcept {
+            classify_blocks_scalar(text, masks, 0);
+         },
+      };
+#else
+      // GCC won't inline a function into one that targets a different instruction set, so the
+      // AVX2 operations are marked with the same target as the entry points that use them, and
+      // the entry points are flattened so that the kernel templates are inlined into them.
+      struct sse2 {
+         static constexpr std::size_t width = 16;
+         static constexpr std::uint32_t all = 0xFFFF;
+
+         static std::uint32_t match(char const* const p, char const c) noexcept
+         {
+            auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+         }
+
+         static std::uint32_t match_identifier_tail(char const* const p) noexcept
+         {
+            auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+            // Setting bit 5 folds upper case onto lower case without moving anything else into
+            // 'a'-'z'. Bytes of 0x80 and up compare as negative, so they're never in range.
+            auto const letter = in_range(_mm_or_si128(block, _mm_set1_epi8(0x20)), 'a', 'z');
+            auto const digit = in_range(block, '0', '9');
+            auto const underscore = _mm_cmpeq_epi8(block, _mm_set1_epi8('_'));
+            return static_cast<std::uint32_t>(
+               _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), underscore)));
+         }
+
+         static __m128i in_range(__m128i const block, char const first, char const last) noexcept
+         {
+            return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(first - 1))),
+                                 _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(last + 1)), block));
+         }
+      };
+
+      struct avx2 {
+         static constexpr std::size_t width = 32;
+         static constexpr std::uint32_t all = 0xFFFF'FFFF;
+
+         [[gnu::target("avx2,popcnt")]] static inline std::uint32_t match(char const* const p, char const c) noexcept
+         {
+            auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+         }
+
+         [[gnu::target("avx2,popcnt")]] static inline std::uint32_t match_identifier_tail(char const* const p) noexcept
+         {
+            auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+            auto const letter = in_range(_mm256_or_si256(block, _mm256_set1_epi8(0x20)), 'a', 'z');
+            auto const digit = in_range(block, '0', '9');
+            auto const underscore = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_'));
+            return static_cast<std::uint32_t>(
+               _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letter, digit), underscore)));
+         }
+
+         [[gnu::target("avx2,popcnt")]] static inline
+         __m256i in_range(__m256i const block, char const first, char const last) noexcept
+         {
+            return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(static_cast<char>(first - 1))),
+                                    _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(last + 1)), block));
+         }
+      };
+
+      [[gnu::flatten]] std::size_t count_blanks_sse2(std::string_view const text) noexcept
+      { return count_blanks_kernel<sse2>(text); }
+
+      [[gnu::flatten]] std::size_t count_identifier_tail_sse2(std::string_view const text) noexcept
+      { return count_identifier_tail_kernel<sse2>(text); }
+
+      [[gnu::flatten]] std::size_t find_line_break_sse2(std::string_view const text) noexcept
+      { return find_line_break_kernel<sse2>(text); }
+
+      [[gnu::flatten]] skipped_text skip_block_comment_text_sse2(std::string_view const text) noexcept
+      { return skip_block_comment_text_kernel<sse2>(text); }
+
+      [[gnu::flatten]]
+      void append_line_starts_sse2(std::string_view const text, std::pmr::vector<std::uint32_t>& starts)
+      { append_line_starts_kernel<sse2>(text, starts); }
+
+      [[gnu::flatten]]
+      void classify_blocks_sse2(std::string_view const text, std::span<character_masks> const masks) noexcept
+      { classify_blocks_kernel<sse2>(text, masks); }
+
+      [[gnu::target("avx2,popcnt"), gnu::flatten]]
+      std::size_t count_blanks_avx2(std::string_view const text) noexcept
+      { return count_blanks_kernel<avx2>(text); }
+
+      [[gnu::target("avx2,popcnt"), gnu::flatten]]
+      std::size_t count_identifier_tail_avx2(std::string_view const text) noexcept
+      { return count_identifier_tail_kernel<avx2>(text); }
+
+      [[gnu::target("avx2,popcnt"), gnu::flatten]]
+      std::size_t find_line_break_avx2(std::string_view const text) noexcept
+      { return find_line_break_kernel<avx2>(text); }
+
+      [[gnu::target("avx2,popcnt"), gnu::flatten]]
+      skipped_text skip_block_comment_text_avx2(std::string_view const text) noexcept
+      { return skip_block_comment_text_kernel<avx2>(text); }
+
+      [[gnu::target("avx2,popcnt"), gnu::flatten]]
+      void append_line_starts_avx2(std::string_view const text, std::pmr::vector<std::uint32_t>& starts)
+      { append_line_starts_kernel<avx2>(text, starts); }
+
+      [[gnu::target("avx2,popcnt"), gnu::flatten]]
+      void classify_blocks_avx2(std::string_view const text, std::span<character_masks> const masks) noexcept
+      { classify_blocks_kernel<avx2>(text, masks); }
+
+      constexpr auto sse2_kernels = kernel_table{
+         instruction_set::sse2,
+         count_blanks_sse2,
+         count_identifier_tail_sse2,
+         find_line_break_sse2,
+         skip_block_comment_text_sse2,
+         append_line_starts_sse2,
+         classify_blocks_sse2,
+      };
+
+      constexpr auto avx2_kernels = kernel_table{
+         instruction_set::avx2,
+         count_blanks_avx2,
+         count_identifier_tail_avx2,
+         find_line_break_avx2,
+         skip_block_comment_text_avx2,
+         append_line_starts_avx2,
+         classify_blocks_avx2,
+      };
+#endif // LTCPP_SIMD_X86
+
+      kernel_table const& select_kernels() noexcept
+      {
+#ifdef LTCPP_SIMD_X86
+         __builtin_cpu_init();
+         if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("popcnt")) {
+            return avx2_kernels;
+         }
+         return sse2_kernels;
+#else
+         return scalar_kernels;
+#endif // LTCPP_SIMD_X86
+      }
+
+      kernel_table const& kernels() noexcept
+      {
+         static auto const& selected = select_kernels();
+         return selected;
+      }
+   } // namespace
+
+   instruction_set selected_instruction_set() noexcept
+   { return kernels().isa; }
+
+   std::size_t count_blanks(std::string_view const text) noexcept
+   { return kernels().count_blanks(text); }
+
+   std::size_t count_identifier_tail(std::string_view const text) noexcept
+   { return kernels().count_identifier_tail(text); }
+
+   std::size_t find_line_break(std::string_view const text) noexcept
+   { return kernels().find_line_break(text); }
+
+   skipped_text skip_block_comment_text(std::string_view const text) noexcept
+   { return kernels().skip_block_comment_text(text); }
+
+   void append_line_starts(std::string_view const text, std::pmr::vector<std::uint32_t>& starts)
+   { kernels().append_line_starts(text, starts); }
+
+   void classify_blocks(std::string_view const text, std::span<character_masks> const masks) noexcept
+   { kernels().classify_blocks(text, masks); }
+} // namespace ltcpp::detail_lexer::simd
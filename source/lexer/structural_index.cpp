@@ -0,0 +1,285 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/structural_index.hpp"
+
+#include "ltcpp/lexer/detail/simd.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace ltcpp::detail_lexer {
+   namespace {
+      constexpr auto block_size = std::size_t{64};
+      constexpr auto all_bits = ~std::uint64_t{0};
+
+      /// What a block inherits from the blocks before it.
+      ///
+      struct carry {
+         bool in_string = false;
+
+         // Whether the previous block ended with a backslash that escapes this block's first
+         // character.
+         bool escaped = false;
+      };
+
+      /// Sets bit i when an odd number of the bits at or below i are set in x, which turns the
+      /// quotes that open and close string literals into the stretches between them.
+      ///
+      constexpr std::uint64_t prefix_xor(std::uint64_t x) noexcept
+      {
+         x ^= x << 1;
+         x ^= x << 2;
+         x ^= x << 4;
+         x ^= x << 8;
+         x ^= x << 16;
+         x ^= x << 32;
+         return x;
+      }
+
+      /// Returns the characters that follow an odd-length run of backslashes. A run that starts on
+      /// an even bit ends its escapes on odd bits and vice versa, and adding a run's first bit to
+      /// it carries out past its end, which is how the parity of every run is found at once.
+      /// `escaped` is both the carry in and the carry out.
+      ///
+      constexpr std::uint64_t find_escaped(std::uint64_t backslash, bool& escaped) noexcept
+      {
+         constexpr auto even_bits = std::uint64_t{0x5555'5555'5555'5555};
+         auto const escaped_in = std::uint64_t{escaped};
+         backslash &= ~escaped_in;
+         auto const follows_escape = backslash << 1 | escaped_in;
+         auto const odd_starts = backslash & ~even_bits & ~follows_escape;
+         auto const even_run_ends = odd_starts + backslash;
+         escaped = even_run_ends < backslash;
+         return (even_bits ^ (even_run_ends << 1)) & follows_escape;
+      }
+
+      /// '\f' ends a line, but not a literal.
+      ///
+      constexpr bool ends_literal(char const c) noexcept
+      { return c == '\n' or c == '\r'; }
+
+      /// Works out which of a block's characters are in string literals without looking at them
+      /// one at a time. That only works when the block's quotes and backslashes are all there is
+      /// to it, so there's no answer when the block also has a line break inside a string (which
+      /// ends the literal early), or a comment, character literal, or backslash outside one.
+      ///
+      std::optional<carry> resolve_block(std::span<simd::character_masks const> const masks,
+         std::size_t const b, carry const in) noexcept
+      {
+         auto const& m = masks[b];
+         auto escaped_out = in.escaped;
+         auto const escaped = find_escaped(m.backslash, escaped_out);
+         auto const in_string = prefix_xor(m.quote & ~escaped) ^ (in.in_string ? all_bits : 0);
+
+         auto const next = b + 1 == masks.size() ? 0 : masks[b + 1].slash | masks[b + 1].star;
+         auto const opens_comment = m.slash & ((m.slash | m.star) >> 1 | next << 63);
+         if ((in_string & m.line_break) != 0
+         or (~in_string & (m.backslash | m.apostrophe | opens_comment)) != 0) {
+            return std::nullopt;
+         }
+         return carry{(in_string >> 63) != 0, escaped_out};
+      }
+
+      /// Walks the blocks that `resolve_block` can't, a character of interest at a time, skipping
+      /// string literals, character literals, and comments exactly as the scanners do.
+      ///
+      class block_walker {
+      public:
+         block_walker(std::string_view const text, std::span<simd::character_masks const> const masks,
+            std::vector<std::uint64_t>& starts, std::optional<std::size_t>& unterminated_comment) noexcept
+            : text_{text}
+            , masks_{masks}
+            , starts_{starts}
+            , unterminated_comment_{unterminated_comment}
+         {}
+
+         /// Walks from the beginning of block b until a block ends outside any comment or
+         /// character literal, and returns the index of the block after it.
+         ///
+         std::size_t walk(std::size_t const b, carry& state) noexcept
+         {
+            auto in_string = state.in_string;
+            auto p = b * block_size;
+            if (in_string and state.escaped and not ends_literal(text_[p])) {
+               ++p;
+            }
+
+            while (p < text_.size()) {
+               auto const block = p / block_size;
+               auto const& m = masks_[block];
+               auto const events = (in_string ? m.quote | m.backslash | m.line_break
+                                              : m.quote | m.apostrophe | m.slash)
+                                 & (all_bits << (p % block_size));
+               if (events == 0) {
+                  state = carry{in_string, false};
+                  return block + 1;
+               }
+
+               auto const e = block * block_size + static_cast<std::size_t>(std::countr_zero(events));
+               p = in_string ? string_event(e, in_string) : normal_event(e, in_string);
+            }
+            return masks_.size();
+         }
+      private:
+         std::string_view text_;
+         std::span<simd::character_masks const> masks_;
+         std::vector<std::uint64_t>& starts_;
+         std::optional<std::size_t>& unterminated_comment_;
+
+         /// Returns where the string literal continues after a quote, backslash, or line break.
+         ///
+         std::size_t string_event(std::size_t const e, bool& in_string) const noexcept
+         {
+            switch (text_[e]) {
+            case '"':
+               in_string = false;
+               return e + 1;
+            case '\\':
+               return e + 1 == text_.size() or ends_literal(text_[e + 1]) ? e + 1 : e + 2;
+            case '\f':
+               return e + 1;
+            default:
+               // The line break isn't part of the literal.
+               in_string = false;
+               return e;
+            }
+         }
+
+         /// Returns where scanning continues after a quote, apostrophe, or slash between tokens.
+         ///
+         std::size_t normal_event(std::size_t const e, bool& in_string) noexcept
+         {
+            switch (text_[e]) {
+            case '"':
+               in_string = true;
+               return e + 1;
+            case '\'':
+               return skip_character_literal(e);
+            default:
+               break;
+            }
+
+            auto const next = e + 1 == text_.size() ? '\0' : text_[e + 1];
+            if (next == '/') {
+               auto const end = line_comment_end(e + 2);
+               clear(e, end);
+               return end;
+            }
+
+            if (next == '*') {
+               auto const close = text_.find("*/", e + 2);
+               if (close == std::string_view::npos) {
+                  unterminated_comment_ = e;
+                  clear(e, text_.size());
+                  return text_.size();
+               }
+               clear(e, close + 2);
+               return close + 2;
+            }
+            return e + 1;
+         }
+
+         /// Consumes what `scan_character_literal` does, whether or not it's well-formed.
+         ///
+         std::size_t skip_character_literal(std::size_t p) const noexcept
+         {
+            ++p;
+            if (p == text_.size() or ends_literal(text_[p])) {
+               return p;
+            }
+
+            auto const c = text_[p++];
+            if (c == '\\' and p < text_.size() and text_[p] == '"') {
+               ++p;
+            }
+            if (p < text_.size() and text_[p] == '\'') {
+               ++p;
+            }
+            return p;
+         }
+
+         /// A lone '\r' doesn't end a line comment.
+         ///
+         std::size_t line_comment_end(std::size_t p) const noexcept
+         {
+            for (;;) {
+               p += simd::find_line_break(text_.substr(p));
+               if (p == text_.size() or text_[p] != '\r') {
+                  return p;
+               }
+               ++p;
+            }
+         }
+
+         void clear(std::size_t const first, std::size_t const last) noexcept
+         {
+            for (auto i = first; i < last;) {
+               auto const word = i / block_size;
+               auto const shift = i % block_size;
+               auto const count = std::min(block_size - shift, last - i);
+               auto const bits = count == block_size ? all_bits : ((std::uint64_t{1} << count) - 1) << shift;
+               starts_[word] &= ~bits;
+               i += count;
+            }
+         }
+      };
+   } // namespace
+
+   structural_index::structural_index(std::string_view const source)
+      : size_{source.size()}
+      , starts_((source.size() + block_size - 1) / block_size)
+   {
+      auto masks = std::vector<simd::character_masks>(starts_.size());
+      simd::classify_blocks(source, masks);
+      for (auto b = std::size_t{0}; b != masks.size(); ++b) {
+         starts_[b] = ~masks[b].blank;
+      }
+
+      auto walker = block_walker{source, masks, starts_, unterminated_comment_};
+      auto state = carry{};
+      for (auto b = std::size_t{0}; b < masks.size();) {
+         if (auto const resolved = resolve_block(masks, b, state)) {
+            state = *resolved;
+            ++b;
+         }
+         else {
+            b = walker.walk(b, state);
+         }
+      }
+   }
+
+   std::size_t structural_index::next_token_start(std::size_t const offset) const noexcept
+   {
+      if (offset >= size_) {
+         return size_;
+      }
+
+      auto b = offset / block_size;
+      auto word = starts_[b] & (all_bits << (offset % block_size));
+      while (word == 0) {
+         if (++b == starts_.size()) {
+            return size_;
+         }
+         word = starts_[b];
+      }
+      return b * block_size + static_cast<std::size_t>(std::countr_zero(word));
+   }
+} // namespace ltcpp::detail_lexer
@@ -0,0 +1,206 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token.hpp"
+
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/detail/decode_number.hpp"
+#include "ltcpp/lexer/detail/keywords.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace ltcpp {
+   namespace {
+      using detail_lexer::keyword;
+      using detail_lexer::keywords;
+
+      /// A perfect hash over `keywords`: every keyword lands in its own slot, so recognising one
+      /// costs a hash of three characters and the length, a load, and one comparison. The table
+      /// is rebuilt from the list whenever it changes, and fails to compile if a new spelling
+      /// can't be given a slot of its own.
+      ///
+      class keyword_table {
+      public:
+         static constexpr auto slot_bits = 7;
+
+         constexpr std::uint32_t slot(std::string_view const spelling) const noexcept
+         {
+            auto const at = [spelling](std::size_t const i) noexcept {
+               return static_cast<std::uint32_t>(static_cast<unsigned char>(spelling[i]));
+            };
+            auto const key = at(0)
+                           | at(spelling.size() / 2) << 8
+                           | at(spelling.size() - 1) << 16
+                           | static_cast<std::uint32_t>(spelling.size()) << 24;
+            auto const mixed = key * multiplier_;
+            return ((mixed ^ mixed >> 16) * 0x045D'9F3Bu) >> (32 - slot_bits);
+         }
+
+         /// \pre `not spelling.empty()`
+         ///
+         constexpr token_kind find(std::string_view const spelling) const noexcept
+         {
+            auto const& candidate = slots_[slot(spelling)];
+            return candidate.spelling == spelling ? candidate.kind : token_kind::identifier;
+         }
+
+         /// Tries odd multipliers until one sends every keyword to a different slot. Returns an
+         /// empty table, whose multiplier is zero, if none does.
+         ///
+         static constexpr keyword_table search() noexcept
+         {
+            for (auto multiplier = std::uint32_t{1}; multiplier < 1'024; multiplier += 2) {
+               auto table = keyword_table{multiplier};
+               if (table.insert_all()) {
+                  return table;
+               }
+            }
+            return keyword_table{0};
+         }
+
+         constexpr bool has_multiplier() const noexcept
+         { return multiplier_ != 0; }
+      private:
+         std::uint32_t multiplier_;
+         std::array<keyword, std::size_t{1} << slot_bits> slots_{};
+
+         constexpr explicit keyword_table(std::uint32_t const multiplier) noexcept
+            : multiplier_{multiplier}
+         {}
+
+         constexpr bool insert_all() noexcept
+         {
+            for (auto const& k : keywords) {
+               auto& s = slots_[slot(k.spelling)];
+               if (not s.spelling.empty()) {
+                  return false;
+               }
+               s = k;
+            }
+            return true;
+         }
+      };
+
+      constexpr bool has_distinct_spellings() noexcept
+      {
+         for (auto i = begin(keywords); i != end(keywords); ++i) {
+            for (auto j = begin(keywords); j != i; ++j) {
+               if (i->spelling == j->spelling) {
+                  return false;
+               }
+            }
+         }
+         return true;
+      }
+      static_assert(has_distinct_spellings(), "A keyword is listed more than once.");
+
+      constexpr auto keyword_lookup = keyword_table::search();
+      static_assert(keyword_lookup.has_multiplier(),
+         "Two keywords share a slot under every multiplier that was tried: "
+         "keyword_table::slot_bits needs to grow.");
+   } // namespace
+
+   token_kind identifier_kind(std::string_view const spelling) noexcept
+   { return spelling.empty() ? token_kind::identifier : keyword_lookup.find(spelling); }
+
+   token make_token(std::string lexeme, source_coordinate const cursor_begin) noexcept
+   {
+      auto const kind = identifier_kind(lexeme);
+      return make_token(std::move(lexeme), cursor_begin, kind);
+   }
+
+   token make_token(std::string lexeme, source_coordinate const cursor_begin,
+      token_kind const kind) noexcept
+   {
+      auto const cursor_end = detail_lexer::advance_column(cursor_begin,
+         static_cast<std::intmax_t>(lexeme.size()));
+      return token{kind, std::move(lexeme), cursor_begin, cursor_end};
+   }
+
+   token make_token(borrowed_spelling_t, std::string_view const lexeme,
+      source_coordinate const cursor_begin, token_kind const kind) noexcept
+   {
+      auto const cursor_end = detail_lexer::advance_column(cursor_begin,
+         static_cast<std::intmax_t>(lexeme.size()));
+      return token{borrowed_spelling, kind, lexeme, cursor_begin, cursor_end};
+   }
+
+   namespace {
+      template<class String>
+      void decode_into(std::string_view const raw, String& result)
+      {
+         result.reserve(raw.size());
+         for (auto i = std::size_t{0}; i != raw.size(); ++i) {
+            auto const escaped = i + 1 != raw.size() and raw[i] == '\\'
+                               ? detail_lexer::decode_escape(detail_lexer::char_traits::to_int_type(raw[i + 1]))
+                               : std::nullopt;
+            if (escaped) {
+               result += *escaped;
+               ++i;
+            }
+            else {
+               result += raw[i];
+            }
+         }
+      }
+   } // namespace
+
+   std::string token::decoded_spelling() const
+   {
+      auto result = std::string{};
+      decode_into(spelling(), result);
+      return result;
+   }
+
+   std::pmr::string token::decoded_spelling(std::pmr::memory_resource* const memory) const
+   {
+      auto result = std::pmr::string{memory};
+      decode_into(spelling(), result);
+      return result;
+   }
+
+   void token::decode_value() noexcept
+   {
+      if (kind_ == token_kind::integral_literal) {
+         auto const value = detail_lexer::decode_integer(spelling());
+         has_value_ = value.has_value();
+         value_ = value.value_or(0);
+      }
+      else if (kind_ == token_kind::floating_literal) {
+         auto const value = detail_lexer::decode_floating(spelling());
+         has_value_ = value.has_value();
+         value_ = std::bit_cast<std::uint64_t>(value.value_or(0.0));
+      }
+   }
+
+   void token::own_spelling()
+   {
+      if (not owned_spelling_) {
+         owned_spelling_ = std::make_unique_for_overwrite<char[]>(spelling_.size());
+         std::ranges::copy(spelling_, owned_spelling_.get());
+         spelling_ = std::string_view{owned_spelling_.get(), spelling_.size()};
+      }
+   }
+} // namespace ltcpp
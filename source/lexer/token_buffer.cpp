@@ -0,0 +1,503 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+
+#include "ltcpp/lexer/detail/scan_token.hpp"
+#include "ltcpp/lexer/detail/scan_whitespace.hpp"
+#include "ltcpp/lexer/detail/structural_index.hpp"
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/line_table.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+#include "ltcpp/source_location.hpp"
+#include "ltcpp/text_edit.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ltcpp {
+   namespace {
+      /// The line table ends a line at every '\f', but the scanners take a '\f' in a string or
+      /// character literal, or in what was scanned of a malformed one, as part of the token.
+      ///
+      constexpr bool can_hold_form_feed(token_kind const kind) noexcept
+      {
+         return kind == token_kind::string_literal
+             or kind == token_kind::unterminated_string_literal
+             or kind == token_kind::invalid_escape_sequence
+             or kind == token_kind::character_literal
+             or kind == token_kind::unknown_token;
+      }
+   } // namespace
+
+   token_buffer::token_buffer(std::string_view const source, file_id const file, line_table lines,
+      std::pmr::memory_resource* const memory)
+      : source_{source}
+      , file_{file}
+      , lines_{std::move(lines)}
+      , kinds_{memory}
+      , offsets_{memory}
+      , lengths_{memory}
+      , valued_tokens_{memory}
+      , values_{memory}
+   {}
+
+   token_buffer::token_buffer(std::string_view const source, reporter& report, file_id const file,
+      std::pmr::memory_resource* const memory) noexcept(false)
+      : token_buffer{source, file, line_table{source, memory}, memory}
+   {
+      reserve(source.size());
+      auto unscanned = source;
+      auto cursor = source_coordinate{};
+      while (lex_next(unscanned, cursor, report)) {}
+   }
+
+   /// The tokens that one thread lexed from a stretch of the source, starting from the assumption
+   /// that the stretch begins between tokens.
+   ///
+   struct token_buffer::chunk {
+      chunk(std::string_view const source, file_id const file)
+         : tokens{source, file, line_table{std::string_view{}}, std::pmr::get_default_resource()}
+      {}
+
+      token_buffer tokens;
+
+      // Where the unscanned text began before each token was lexed. Once the tokens before the
+      // chunk end at one of these offsets, the chunk's tokens from there on are exactly what the
+      // sequential lexer produces.
+      std::vector<std::uint32_t> resume_offsets;
+
+      // Where the chunk begins, and the coordinate it was given. The line table ends a line at
+      // each '\f' in a literal until the literal is stitched in, so that coordinate is one line
+      // too far on for every such literal before the chunk.
+      std::uint32_t start_offset = 0;
+      source_coordinate start_cursor;
+
+      // Where, and at which coordinate, the first token that belongs to the next chunk begins.
+      std::uint32_t stop_offset = 0;
+      source_coordinate stop_cursor;
+      bool reached_eof = false;
+
+      // Where a comment that's never closed begins. Malformed tokens are reported when they're
+      // stitched in, from the line table, so this is the only diagnostic the chunk keeps.
+      std::optional<source_coordinate> unterminated_comment;
+
+      /// Lexes from begin until the next token would start at or after end.
+      ///
+      void lex(std::uint32_t const begin, std::size_t const end, source_coordinate cursor)
+      {
+         start_offset = begin;
+         start_cursor = cursor;
+
+         auto const source = tokens.source();
+         tokens.reserve(std::min(end, source.size()) - begin);
+         auto unscanned = source.substr(begin);
+         for (;;) {
+            auto const resume = static_cast<std::uint32_t>(source.size() - unscanned.size());
+            if (resume >= end) {
+               stop_offset = resume;
+               stop_cursor = cursor;
+               return;
+            }
+            resume_offsets.push_back(resume);
+
+            if (auto const whitespace = detail_lexer::scan_whitespace_like(unscanned, cursor)) {
+               cursor = *whitespace;
+            }
+            else {
+               unterminated_comment = whitespace.error().begin();
+               cursor = whitespace.error().end();
+            }
+
+            if (unscanned.empty()) {
+               tokens.push_back(token{borrowed_spelling, token_kind::eof, eof_spelling, cursor, cursor});
+               reached_eof = true;
+               return;
+            }
+
+            auto const t = detail_lexer::scan_token(unscanned, cursor);
+            tokens.push_back(t);
+            cursor = t.position().end();
+         }
+      }
+   };
+
+   token_buffer::token_buffer(std::string_view const source, reporter& report,
+      parallel_lexing const how, file_id const file, std::pmr::memory_resource* const memory)
+      noexcept(false)
+      : token_buffer{source, file, line_table{source, memory}, memory}
+   {
+      reserve(source.size());
+
+      // Chunks begin at line starts, so that their first coordinates can be read off the line
+      // table, and so that they're unlikely to begin inside a string literal.
+      auto const chunk_count = std::clamp(source.size() / std::max(how.minimum_chunk_size, std::size_t{1}),
+         std::size_t{1}, std::max(how.threads, std::size_t{1}));
+      auto const& line_starts = lines_.line_starts();
+      auto chunk_begins = std::vector<std::uint32_t>{0};
+      for (auto k = std::size_t{1}; k < chunk_count; ++k) {
+         auto const target = static_cast<std::uint32_t>(source.size() / chunk_count * k);
+         auto const line_start = std::ranges::lower_bound(line_starts, target);
+         if (line_start != line_starts.end() and *line_start > chunk_begins.back()
+         and *line_start < source.size()) {
+            chunk_begins.push_back(*line_start);
+         }
+      }
+
+      if (chunk_begins.size() == 1) {
+         auto unscanned = source;
+         auto cursor = source_coordinate{};
+         while (lex_next(unscanned, cursor, report)) {}
+         return;
+      }
+
+      auto chunks = std::vector<std::unique_ptr<chunk>>{};
+      for (auto k = std::size_t{0}; k != chunk_begins.size(); ++k) {
+         chunks.push_back(std::make_unique<chunk>(source, file));
+      }
+
+      {
+         auto const lex_chunk = [&](std::size_t const k) {
+            auto const end = k + 1 == chunk_begins.size() ? source.size() + 1 : chunk_begins[k + 1];
+            chunks[k]->lex(chunk_begins[k], end, lines_.coordinate(chunk_begins[k]));
+         };
+
+         auto workers = std::vector<std::jthread>{};
+         for (auto k = std::size_t{1}; k != chunks.size(); ++k) {
+            workers.emplace_back(lex_chunk, k);
+         }
+         lex_chunk(0);
+      }
+
+      auto const offset_of = [source](std::string_view const unscanned) {
+         return static_cast<std::uint32_t>(source.size() - unscanned.size());
+      };
+
+      auto resume = std::uint32_t{0};
+      auto cursor = source_coordinate{};
+      auto k = std::size_t{0};
+      while (k != chunks.size()) {
+         // A chunk whose tokens all begin before resume has nothing left to contribute.
+         if (chunks[k]->resume_offsets.back() < resume) {
+            ++k;
+            continue;
+         }
+
+         auto const& c = *chunks[k];
+         auto const first = std::lower_bound(c.resume_offsets.begin(), c.resume_offsets.end(), resume);
+         if (*first == resume) {
+            // A chunk that began inside a literal with a '\f' in it took its first columns from a
+            // line that's since been joined, so it's left to the sequential lexer.
+            if (lines_.coordinate(c.start_offset).column() != source_coordinate::column_type{1}) {
+               ++k;
+               continue;
+            }
+
+            cursor = splice(c, static_cast<std::size_t>(first - c.resume_offsets.begin()), report);
+            if (c.reached_eof) {
+               return;
+            }
+
+            resume = c.stop_offset;
+            ++k;
+            continue;
+         }
+
+         // The chunk began inside a comment or string literal that the tokens before it hadn't
+         // finished, so its speculation went wrong. Lexing resumes sequentially until it catches up
+         // with a place where one of the chunks started a token.
+         auto unscanned = source.substr(resume);
+         if (not lex_next(unscanned, cursor, report)) {
+            return;
+         }
+         resume = offset_of(unscanned);
+      }
+
+      // Only a chunk that was left to the sequential lexer can stop the stitching short of eof.
+      auto unscanned = source.substr(resume);
+      while (lex_next(unscanned, cursor, report)) {}
+   }
+
+   token_buffer::token_buffer(std::string_view const source, reporter& report, two_stage_lexing_t,
+      file_id const file, std::pmr::memory_resource* const memory) noexcept(false)
+      : token_buffer{source, file, line_table{source, memory}, memory}
+   {
+      reserve(source.size());
+      auto const index = detail_lexer::structural_index{source};
+
+      // The scanners are given a placeholder cursor, because the few tokens that need their
+      // coordinates can get them from the line table.
+      auto begin = index.next_token_start(0);
+      while (begin != source.size()) {
+         auto unscanned = source.substr(begin);
+         auto const t = detail_lexer::scan_token(unscanned, source_coordinate{});
+         push_back(t);
+         if (detail_lexer::is_malformed(t.kind())) {
+            detail_lexer::report_token_error(report, t, lines_.coordinate(static_cast<std::uint32_t>(begin)));
+         }
+         begin = index.next_token_start(source.size() - unscanned.size());
+      }
+
+      if (auto const unterminated_comment = index.unterminated_comment()) {
+         detail_lexer::report_unterminated_comment(report,
+            lines_.coordinate(static_cast<std::uint32_t>(*unterminated_comment)));
+      }
+
+      auto const eof = lines_.coordinate(static_cast<std::uint32_t>(source.size()));
+      push_back(token{borrowed_spelling, token_kind::eof, eof_spelling, eof, eof});
+   }
+
+   token_edit token_buffer::edit(std::string_view const source, text_edit const change, reporter& report)
+      noexcept(false)
+   {
+      auto const& line_starts = lines_.line_starts();
+      auto const relined = *std::ranges::prev(std::ranges::lower_bound(std::ranges::next(line_starts.begin()),
+         line_starts.end(), change.offset));
+      auto relined_end = lines_.edit(source, change);
+      source_ = source;
+
+      auto const end_of = [this](std::size_t const i) { return std::size_t{offsets_[i]} + lengths_[i]; };
+      auto const old_tokens = size() - 1;
+      auto const indices = std::views::iota(std::size_t{0}, old_tokens);
+      auto const first = static_cast<std::size_t>(std::ranges::partition_point(indices, [&](std::size_t const i) {
+         return end_of(i) < change.offset;
+      }) - indices.begin());
+
+      auto scratch = token_buffer{source, file_, line_table{std::string_view{}}, kinds_.get_allocator().resource()};
+      auto const resume = first == 0 ? std::size_t{0} : end_of(first - 1);
+      auto unscanned = source.substr(resume);
+      auto cursor = lines_.coordinate(static_cast<std::uint32_t>(resume));
+      auto const changed_end = change.offset + change.inserted;
+      auto const shift = static_cast<std::uint32_t>(change.inserted - change.removed);
+
+      // Old tokens up to `last` are replaced; the eof token is replaced if lexing reaches it.
+      auto last = first;
+      while (scratch.lex_next(unscanned, cursor, report)) {
+         auto const end = source.size() - unscanned.size();
+         if (end < changed_end) {
+            continue;
+         }
+
+         auto const old_end = static_cast<std::uint32_t>(end) - shift;
+         while (last != old_tokens and end_of(last) < old_end) {
+            ++last;
+         }
+         if (last != old_tokens and end_of(last) == old_end) {
+            ++last;
+            break;
+         }
+      }
+      if (scratch.kinds_.back() == token_kind::eof) {
+         last = size();
+      }
+
+      if (decodes_values_) {
+         scratch.decode_values();
+      }
+
+      // The old tokens after the replaced ones follow the arrays' gaps, so they're shifted without
+      // being touched.
+      auto const replaced = token_edit{first, last - first, scratch.size()};
+      kinds_.replace(replaced.first, replaced.removed, scratch.kinds_);
+      offsets_.replace(replaced.first, replaced.removed, scratch.offsets_);
+      offsets_.shift_tail(shift);
+      lengths_.replace(replaced.first, replaced.removed, scratch.lengths_);
+
+      auto const first_value = std::ranges::lower_bound(valued_tokens_, first) - valued_tokens_.begin();
+      auto const last_value = std::ranges::lower_bound(valued_tokens_.begin() + first_value, valued_tokens_.end(), last)
+                            - valued_tokens_.begin();
+      auto const valued = static_cast<std::size_t>(first_value);
+      auto const devalued = static_cast<std::size_t>(last_value - first_value);
+      auto const relexed_valued_tokens = scratch.valued_tokens_
+                                       | std::views::transform([first](std::uint32_t const i) {
+                                            return static_cast<std::uint32_t>(i + first);
+                                         });
+      values_.replace(valued, devalued, scratch.values_);
+      valued_tokens_.replace(valued, devalued, relexed_valued_tokens);
+      valued_tokens_.shift_tail(static_cast<std::uint32_t>(replaced.inserted - replaced.removed));
+
+      // A token that was lexed again might have gained or lost a '\f' in a literal, so the line table
+      // looks again at least as far as the new tokens go, by replacing them with themselves. It
+      // splits the lines of every token with a '\f' in it that it looks at, and they're joined
+      // again.
+      auto const relexed_end = replaced.inserted == 0 ? std::size_t{0} : end_of(first + replaced.inserted - 1);
+      if (relexed_end > relined_end) {
+         auto const length = relexed_end - relined_end;
+         relined_end = lines_.edit(source, text_edit{relined_end, length, length});
+      }
+
+      auto const relined_tokens = std::ranges::lower_bound(offsets_, relined);
+      for (auto i = static_cast<std::size_t>(relined_tokens - offsets_.begin()); offsets_[i] < relined_end; ++i) {
+         join_lines(i);
+      }
+      return replaced;
+   }
+
+   void token_buffer::decode_values()
+   {
+      if (std::exchange(decodes_values_, true)) {
+         return;
+      }
+
+      for (auto i = std::size_t{0}; i != size(); ++i) {
+         if (kinds_[i] != token_kind::integral_literal and kinds_[i] != token_kind::floating_literal) {
+            continue;
+         }
+
+         auto t = token{borrowed_spelling, kinds_[i], spelling(i), source_coordinate{}, source_coordinate{}};
+         t.decode_value();
+         if (t.has_value_) {
+            valued_tokens_.push_back(static_cast<std::uint32_t>(i));
+            values_.push_back(t.value_);
+         }
+      }
+   }
+
+   void token_buffer::compact()
+   {
+      kinds_.compact();
+      offsets_.compact();
+      lengths_.compact();
+      valued_tokens_.compact();
+      values_.compact();
+   }
+
+   void token_buffer::reserve(std::size_t const characters)
+   {
+      // Roughly one token per five characters is typical, and over-reserving is cheap next to
+      // repeatedly growing three arrays.
+      auto const estimate = characters / 5 + 1;
+      kinds_.reserve(estimate);
+      offsets_.reserve(estimate);
+      lengths_.reserve(estimate);
+   }
+
+   bool token_buffer::lex_next(std::string_view& unscanned, source_coordinate& cursor, reporter& report)
+   {
+      auto const t = generate_token(unscanned, report, cursor);
+      push_back(t);
+      cursor = t.position().end();
+      return t.kind() != token_kind::eof;
+   }
+
+   void token_buffer::push_back(token const& t)
+   {
+      kinds_.push_back(t.kind());
+      if (t.kind() == token_kind::eof) {
+         offsets_.push_back(static_cast<std::uint32_t>(source_.size()));
+         lengths_.push_back(0);
+         return;
+      }
+
+      offsets_.push_back(static_cast<std::uint32_t>(t.spelling().data() - source_.data()));
+      lengths_.push_back(static_cast<std::uint32_t>(t.spelling().size()));
+      join_lines(kinds_.size() - 1);
+   }
+
+   bool token_buffer::holds_form_feed(std::size_t const i) const noexcept
+   { return can_hold_form_feed(kinds_[i]) and spelling(i).find('\f') != std::string_view::npos; }
+
+   void token_buffer::join_lines(std::size_t const i) noexcept
+   {
+      if (holds_form_feed(i)) {
+         lines_.join_lines(offsets_[i], offsets_[i] + lengths_[i]);
+      }
+   }
+
+   source_coordinate token_buffer::splice(chunk const& c, std::size_t const i, reporter& report)
+   {
+      // Every line that's been joined before the chunk moves its coordinates back by a line.
+      auto const joined = c.start_cursor.line() - lines_.coordinate(c.start_offset).line();
+      auto const rebase = [joined](source_coordinate const x) {
+         return source_coordinate{x.line() - joined, x.column()};
+      };
+
+      auto const& from = c.tokens;
+      for (auto j = i; j != from.size(); ++j) {
+         kinds_.push_back(from.kinds_[j]);
+         offsets_.push_back(from.offsets_[j]);
+         lengths_.push_back(from.lengths_[j]);
+         join_lines(size() - 1);
+
+         if (c.unterminated_comment and kinds_.back() == token_kind::eof) {
+            detail_lexer::report_unterminated_comment(report, rebase(*c.unterminated_comment));
+         }
+         else if (detail_lexer::is_malformed(kinds_.back())) {
+            auto const t = (*this)[size() - 1];
+            detail_lexer::report_token_error(report, t, t.position().begin());
+         }
+      }
+
+      return rebase(c.stop_cursor);
+   }
+
+   std::string_view token_buffer::spelling(std::size_t const i) const noexcept
+   { return kinds_[i] == token_kind::eof ? eof_spelling : source_.substr(offsets_[i], lengths_[i]); }
+
+   source_coordinate_range token_buffer::position(std::size_t const i) const noexcept
+   {
+      auto const begin = lines_.coordinate(offsets_[i]);
+      auto const end = source_coordinate{
+         begin.line(),
+         begin.column() + source_coordinate::column_type{lengths_[i]}
+      };
+      return source_coordinate_range{begin, end};
+   }
+
+   std::optional<std::uint64_t> token_buffer::value_bits(std::size_t const i) const noexcept
+   {
+      auto const found = std::ranges::lower_bound(valued_tokens_, i);
+      if (found == valued_tokens_.end() or *found != i) {
+         return std::nullopt;
+      }
+      return values_[static_cast<std::size_t>(found - valued_tokens_.begin())];
+   }
+
+   std::optional<std::uint64_t> token_buffer::integral_value(std::size_t const i) const noexcept
+   { return kinds_[i] == token_kind::integral_literal ? value_bits(i) : std::nullopt; }
+
+   std::optional<double> token_buffer::floating_value(std::size_t const i) const noexcept
+   {
+      if (kinds_[i] != token_kind::floating_literal) {
+         return std::nullopt;
+      }
+
+      auto const bits = value_bits(i);
+      return bits ? std::optional{std::bit_cast<double>(*bits)} : std::nullopt;
+   }
+
+   token token_buffer::operator[](std::size_t const i) const noexcept
+   {
+      auto const where = position(i);
+      auto result = token{borrowed_spelling, kinds_[i], spelling(i), where.begin(), where.end()};
+      if (auto const bits = value_bits(i)) {
+         result.has_value_ = true;
+         result.value_ = *bits;
+      }
+      return result;
+   }
+} // namespace ltcpp
@@ -0,0 +1,390 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_cache.hpp"
+
+#include "ltcpp/detail/file_descriptor.hpp"
+#include "ltcpp/lexer/detail/gap_buffer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/line_table.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace ltcpp {
+   namespace {
+      using detail::file_descriptor;
+      using detail::throw_system_error;
+
+      __extension__ using uint128 = unsigned __int128;
+
+      /// Multiplies a and b into 128 bits and folds the halves together, which mixes every bit of
+      /// each into most bits of the result.
+      ///
+      constexpr std::uint64_t fold_multiply(std::uint64_t const a, std::uint64_t const b) noexcept
+      {
+         auto const product = uint128{a} * b;
+         return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+      }
+
+      std::uint64_t read64(char const* const p) noexcept
+      {
+         auto result = std::uint64_t{};
+         std::memcpy(&result, p, sizeof(result));
+         return result;
+      }
+
+      /// A 64-bit hash in the style of XXH3 and wyhash. Four independent lanes each fold 16 bytes
+      /// at a time through a 128-bit multiply, so the main loop is bound by the multiplier's
+      /// throughput rather than its latency, and runs at several bytes per cycle.
+      ///
+      std::uint64_t content_hash(std::string_view const text) noexcept
+      {
+         constexpr auto secret = std::array<std::uint64_t, 5>{
+            0x9e37'79b9'7f4a'7c15, 0xa076'1d64'78bd'642f, 0xe703'7ed1'a0b4'28db,
+            0x8ebc'6af0'9c88'c6e3, 0x5899'65cc'7537'4cc3,
+         };
+
+         auto lanes = std::array{secret[0], secret[1], secret[2], secret[3]};
+         auto const* p = text.data();
+         auto n = text.size();
+         for (; n >= 64; p += 64, n -= 64) {
+            for (auto i = std::size_t{0}; i != lanes.size(); ++i) {
+               lanes[i] = fold_multiply(read64(p + 16 * i) ^ secret[i + 1], read64(p + 16 * i + 8) ^ lanes[i]);
+            }
+         }
+
+         auto hash = lanes[0];
+         for (auto i = std::size_t{1}; i != lanes.size(); ++i) {
+            hash = fold_multiply(hash ^ secret[4], lanes[i] ^ secret[i]);
+         }
+
+         for (; n >= 16; p += 16, n -= 16) {
+            hash = fold_multiply(read64(p) ^ secret[1], read64(p + 8) ^ hash);
+         }
+
+         auto tail = std::array<char, 16>{};
+         std::memcpy(tail.data(), p, n);
+         hash = fold_multiply(read64(tail.data()) ^ secret[2], read64(tail.data() + 8) ^ hash);
+         return fold_multiply(hash ^ text.size(), secret[4]);
+      }
+
+      /// An entry begins with a header, and then holds each of the token_buffer's arrays in turn,
+      /// widest elements first so that every array is aligned:
+      ///
+      ///    values          std::uint64_t[valued_count]
+      ///    valued tokens   std::uint32_t[valued_count]
+      ///    offsets         std::uint32_t[token_count]
+      ///    lengths         std::uint32_t[token_count]
+      ///    line starts     std::uint32_t[line_count]
+      ///    kinds           token_kind[token_count]
+      ///
+      struct entry_header {
+         /// Reads differently in the other byte order, so entries from a machine that uses it are
+         /// rejected.
+         static constexpr std::uint64_t expected_magic = 0x6c74'6370'7000'0001;
+
+         /// Changes when the layout does.
+         static constexpr std::uint32_t expected_format_version = 1;
+
+         std::uint64_t magic = expected_magic;
+         std::uint32_t format_version = expected_format_version;
+         std::uint32_t lexer_version = token_cache::lexer_version;
+         std::uint64_t hash;
+         std::uint64_t source_size;
+         std::uint64_t token_count;
+         std::uint64_t valued_count;
+         std::uint64_t line_count;
+
+         std::size_t entry_size() const noexcept
+         {
+            return sizeof(entry_header)
+                 + static_cast<std::size_t>(valued_count) * (sizeof(std::uint64_t) + sizeof(std::uint32_t))
+                 + static_cast<std::size_t>(token_count) * (2 * sizeof(std::uint32_t) + sizeof(token_kind))
+                 + static_cast<std::size_t>(line_count) * sizeof(std::uint32_t);
+         }
+
+         /// Checks everything but the hash, and that the counts are small enough for entry_size not
+         /// to overflow.
+         ///
+         bool describes(std::string_view const source, std::size_t const file_size) const noexcept
+         {
+            return magic == expected_magic
+               and format_version == expected_format_version
+               and lexer_version == token_cache::lexer_version
+               and source_size == source.size()
+               and token_count <= source_size + 1
+               and line_count <= source_size + 1
+               and valued_count <= token_count
+               and entry_size() == file_size;
+         }
+      };
+
+      static_assert(sizeof(entry_header) % alignof(std::uint64_t) == 0);
+
+      std::string to_hex(std::uint64_t const n)
+      {
+         auto result = std::string(16, '0');
+         auto const digits = std::to_chars(result.data(), result.data() + result.size(), n, 16).ptr;
+         std::rotate(result.begin(), result.begin() + (digits - result.data()), result.end());
+         return result;
+      }
+
+      template<class T>
+      void write_all(int const fd, std::span<T const> const data, std::filesystem::path const& path) noexcept(false)
+      {
+         auto bytes = std::as_bytes(data);
+         while (not bytes.empty()) {
+            auto const result = ::write(fd, bytes.data(), bytes.size());
+            if (result == -1) {
+               if (errno == EINTR) {
+                  continue;
+               }
+               throw_system_error("unable to write", path);
+            }
+            bytes = bytes.subspan(static_cast<std::size_t>(result));
+         }
+      }
+
+      /// An edited gap_buffer's elements aren't all stored as they are, so they're copied out to be
+      /// written.
+      ///
+      template<class T>
+      void write_all(int const fd, detail_lexer::gap_buffer<T> const& data, std::filesystem::path const& path)
+         noexcept(false)
+      {
+         if (data.is_contiguous()) {
+            write_all(fd, data.contiguous(), path);
+            return;
+         }
+
+         auto contiguous = std::vector<T>(data.size());
+         std::ranges::copy(data, contiguous.begin());
+         write_all(fd, std::span<T const>{contiguous}, path);
+      }
+
+      template<class T>
+      std::span<T const> take(std::byte const*& cursor, std::uint64_t const count) noexcept
+      {
+         auto const result = std::span{reinterpret_cast<T const*>(cursor), static_cast<std::size_t>(count)};
+         cursor += result.size_bytes();
+         return result;
+      }
+   } // namespace
+
+   cached_token_buffer::cached_token_buffer(cached_token_buffer&& other) noexcept
+      : mapping_{std::exchange(other.mapping_, nullptr)}
+      , mapping_size_{std::exchange(other.mapping_size_, 0)}
+      , source_{other.source_}
+      , file_{other.file_}
+      , kinds_{other.kinds_}
+      , offsets_{other.offsets_}
+      , lengths_{other.lengths_}
+      , line_starts_{other.line_starts_}
+      , valued_tokens_{other.valued_tokens_}
+      , values_{other.values_}
+   {}
+
+   cached_token_buffer& cached_token_buffer::operator=(cached_token_buffer&& other) noexcept
+   {
+      if (this != &other) {
+         release();
+         mapping_ = std::exchange(other.mapping_, nullptr);
+         mapping_size_ = std::exchange(other.mapping_size_, 0);
+         source_ = other.source_;
+         file_ = other.file_;
+         kinds_ = other.kinds_;
+         offsets_ = other.offsets_;
+         lengths_ = other.lengths_;
+         line_starts_ = other.line_starts_;
+         valued_tokens_ = other.valued_tokens_;
+         values_ = other.values_;
+      }
+      return *this;
+   }
+
+   cached_token_buffer::~cached_token_buffer()
+   { release(); }
+
+   void cached_token_buffer::release() noexcept
+   {
+      if (mapping_ != nullptr) {
+         ::munmap(mapping_, mapping_size_);
+         mapping_ = nullptr;
+      }
+   }
+
+   std::string_view cached_token_buffer::spelling(std::size_t const i) const noexcept
+   { return kinds_[i] == token_kind::eof ? eof_spelling : source_.substr(offsets_[i], lengths_[i]); }
+
+   source_coordinate_range cached_token_buffer::position(std::size_t const i) const noexcept
+   {
+      auto const begin = line_table::coordinate(line_starts_, offsets_[i]);
+      auto const end = source_coordinate{
+         begin.line(),
+         begin.column() + source_coordinate::column_type{lengths_[i]}
+      };
+      return source_coordinate_range{begin, end};
+   }
+
+   std::optional<std::uint64_t> cached_token_buffer::value_bits(std::size_t const i) const noexcept
+   {
+      auto const found = std::lower_bound(valued_tokens_.begin(), valued_tokens_.end(), i);
+      if (found == valued_tokens_.end() or *found != i) {
+         return std::nullopt;
+      }
+      return values_[static_cast<std::size_t>(found - valued_tokens_.begin())];
+   }
+
+   std::optional<std::uint64_t> cached_token_buffer::integral_value(std::size_t const i) const noexcept
+   { return kinds_[i] == token_kind::integral_literal ? value_bits(i) : std::nullopt; }
+
+   std::optional<double> cached_token_buffer::floating_value(std::size_t const i) const noexcept
+   {
+      if (kinds_[i] != token_kind::floating_literal) {
+         return std::nullopt;
+      }
+
+      auto const bits = value_bits(i);
+      return bits ? std::optional{std::bit_cast<double>(*bits)} : std::nullopt;
+   }
+
+   token cached_token_buffer::operator[](std::size_t const i) const noexcept
+   {
+      auto const where = position(i);
+      auto result = token{borrowed_spelling, kinds_[i], spelling(i), where.begin(), where.end()};
+      if (auto const bits = value_bits(i)) {
+         result.has_value_ = true;
+         result.value_ = *bits;
+      }
+      return result;
+   }
+
+   token_cache::token_cache(std::filesystem::path directory) noexcept(false)
+      : directory_{std::move(directory)}
+   { std::filesystem::create_directories(directory_); }
+
+   std::filesystem::path token_cache::entry(std::string_view const source) const
+   {
+      // The lexer version is part of the name as well as the header, so that entries from
+      // different versions can share a directory without replacing one another.
+      return directory_ / (to_hex(content_hash(source)) + ".v" + std::to_string(lexer_version) + ".tokens");
+   }
+
+   std::optional<cached_token_buffer>
+   token_cache::find(std::string_view const source, file_id const file) const noexcept(false)
+   {
+      auto const path = entry(source);
+      auto const fd = file_descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+      if (fd.get() == -1) {
+         if (errno == ENOENT) {
+            return std::nullopt;
+         }
+         throw_system_error("unable to open", path);
+      }
+
+      struct ::stat status{};
+      if (::fstat(fd.get(), &status) == -1) {
+         throw_system_error("unable to stat", path);
+      }
+
+      auto const size = static_cast<std::size_t>(status.st_size);
+      if (size < sizeof(entry_header)) {
+         return std::nullopt;
+      }
+
+      auto result = cached_token_buffer{};
+      result.mapping_ = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+      if (result.mapping_ == MAP_FAILED) {
+         result.mapping_ = nullptr;
+         throw_system_error("unable to map", path);
+      }
+      result.mapping_size_ = size;
+
+      auto header = entry_header{};
+      std::memcpy(&header, result.mapping_, sizeof(header));
+      if (not header.describes(source, size) or header.hash != content_hash(source)) {
+         return std::nullopt;
+      }
+
+      auto cursor = static_cast<std::byte const*>(result.mapping_) + sizeof(header);
+      result.values_ = take<std::uint64_t>(cursor, header.valued_count);
+      result.valued_tokens_ = take<std::uint32_t>(cursor, header.valued_count);
+      result.offsets_ = take<std::uint32_t>(cursor, header.token_count);
+      result.lengths_ = take<std::uint32_t>(cursor, header.token_count);
+      result.line_starts_ = take<std::uint32_t>(cursor, header.line_count);
+      result.kinds_ = take<token_kind>(cursor, header.token_count);
+      result.source_ = source;
+      result.file_ = file;
+      return result;
+   }
+
+   void token_cache::store(token_buffer const& tokens) const noexcept(false)
+   {
+      auto const source = tokens.source();
+      auto const& line_starts = tokens.lines().line_starts();
+      auto const header = entry_header{
+         .hash = content_hash(source),
+         .source_size = source.size(),
+         .token_count = tokens.kinds_.size(),
+         .valued_count = tokens.values_.size(),
+         .line_count = line_starts.size(),
+      };
+
+      auto const path = entry(source);
+      auto temporary = path.string() + ".XXXXXX";
+      auto const fd = file_descriptor{::mkstemp(temporary.data())};
+      if (fd.get() == -1) {
+         throw_system_error("unable to create", temporary);
+      }
+
+      try {
+         write_all(fd.get(), std::span{&header, 1}, temporary);
+         write_all(fd.get(), tokens.values_, temporary);
+         write_all(fd.get(), tokens.valued_tokens_, temporary);
+         write_all(fd.get(), tokens.offsets_, temporary);
+         write_all(fd.get(), tokens.lengths_, temporary);
+         write_all(fd.get(), line_starts, temporary);
+         write_all(fd.get(), tokens.kinds_, temporary);
+         if (::rename(temporary.c_str(), path.c_str()) == -1) {
+            throw_system_error("unable to rename", temporary);
+         }
+      }
+      catch (...) {
+         ::unlink(temporary.c_str());
+         throw;
+      }
+   }
+} // namespace ltcpp
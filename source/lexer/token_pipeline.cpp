@@ -0,0 +1,147 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_pipeline.hpp"
+
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <sstream>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace ltcpp {
+   token_pipeline::token_pipeline(std::string_view const source, reporter& report,
+      pipelined_lexing const how)
+      : report_{&report}
+      , ring_{std::max(how.batches_in_flight, std::size_t{1})}
+      , lexer_{lex, source, std::max(how.batch_size, std::size_t{1}), std::ref(ring_),
+           std::ref(lexer_returned_)}
+   {}
+
+   token_pipeline::~token_pipeline()
+   {
+      // The lexer can publish a batch after a single pass over the ring has emptied it, and then
+      // wait on a full ring, so batches are handed back until it has returned. It checks for a stop
+      // between tokens, so that doesn't take long.
+      lexer_.request_stop();
+      while (not lexer_returned_.load(std::memory_order_acquire)) {
+         while (ring_.try_front() != nullptr) {
+            ring_.pop();
+         }
+         std::this_thread::yield();
+      }
+      lexer_.join();
+   }
+
+   token const& token_pipeline::next() noexcept(false)
+   {
+      if (finished_) {
+         return current_->tokens.back();
+      }
+
+      if (current_ == nullptr or position_ == current_->tokens.size()) {
+         // A batch that the lexer gave up on is kept, so that its exception is thrown again.
+         if (current_ != nullptr and not current_->exception) {
+            ring_.pop();
+            current_ = nullptr;
+         }
+
+         if (current_ == nullptr) {
+            current_ = &ring_.front();
+            position_ = 0;
+            next_diagnostic_ = 0;
+         }
+      }
+
+      auto const& diagnostics = current_->diagnostics;
+      for (; next_diagnostic_ != diagnostics.size() and diagnostics[next_diagnostic_].token == position_;
+             ++next_diagnostic_) {
+         auto const& d = diagnostics[next_diagnostic_];
+         report_->relay(d.text, d.errors, d.warnings);
+      }
+
+      if (position_ == current_->tokens.size()) {
+         std::rethrow_exception(current_->exception);
+      }
+
+      auto const& result = current_->tokens[position_++];
+      finished_ = result.kind() == token_kind::eof;
+      return result;
+   }
+
+   void token_pipeline::lex(std::stop_token const stop, std::string_view source,
+      std::size_t const batch_size, detail_lexer::spsc_ring<batch>& ring,
+      std::atomic<bool>& returned) noexcept
+   {
+      struct on_return {
+         std::atomic<bool>& returned;
+
+         ~on_return()
+         { returned.store(true, std::memory_order_release); }
+      } const signal{returned};
+
+      auto text = std::ostringstream{};
+      auto report = reporter{text};
+      auto cursor = source_coordinate{};
+      for (auto done = false; not done;) {
+         auto& b = ring.claim();
+         if (stop.stop_requested()) {
+            return;
+         }
+
+         b.tokens.clear();
+         b.diagnostics.clear();
+         b.exception = nullptr;
+         try {
+            while (b.tokens.size() != batch_size and not done and not stop.stop_requested()) {
+               auto const errors = report.errors();
+               auto const warnings = report.warnings();
+               b.tokens.push_back(generate_token(source, report, cursor));
+               cursor = b.tokens.back().position().end();
+               done = b.tokens.back().kind() == token_kind::eof;
+
+               if (report.errors() != errors or report.warnings() != warnings) {
+                  b.diagnostics.push_back(diagnostic{
+                     b.tokens.size() - 1,
+                     std::move(text).str(),
+                     report.errors() - errors,
+                     report.warnings() - warnings
+                  });
+                  text.str({});
+               }
+            }
+         }
+         catch (...) {
+            b.exception = std::current_exception();
+            done = true;
+         }
+
+         // Nobody reads a batch once the pipeline is being destroyed.
+         if (stop.stop_requested()) {
+            return;
+         }
+         ring.publish();
+      }
+   }
+} // namespace ltcpp
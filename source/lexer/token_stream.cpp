@@ -0,0 +1,248 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_stream.hpp"
+
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/line_table.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ltcpp {
+   namespace {
+      using namespace std::string_view_literals;
+
+      constexpr auto magic = "ltcppts\0"sv;
+
+      constexpr auto same_spelling = std::uint8_t{0x80};
+
+      constexpr auto kind_count = static_cast<std::size_t>(token_kind::exponent_lacking_digit) + 1;
+      static_assert(kind_count <= same_spelling, "token_kind no longer fits in seven bits.");
+
+      void put_varint(std::string& out, std::uint64_t n)
+      {
+         for (; n >= 0x80; n >>= 7) {
+            out += static_cast<char>((n & 0x7f) | 0x80);
+         }
+         out += static_cast<char>(n);
+      }
+
+      [[noreturn]] void malformed(std::string_view const what)
+      { throw std::runtime_error{"malformed token stream: " + std::string{what}}; }
+
+      class stream_reader {
+      public:
+         explicit stream_reader(std::string_view const bytes) noexcept
+            : bytes_{bytes}
+         {}
+
+         std::uint64_t varint() noexcept(false)
+         {
+            auto result = std::uint64_t{0};
+            for (auto shift = 0; shift < 64; shift += 7) {
+               auto const b = byte();
+               result |= std::uint64_t{b & 0x7fU} << shift;
+               if ((b & 0x80) == 0) {
+                  return result;
+               }
+            }
+            malformed("varint is too long");
+         }
+
+         std::uint8_t byte() noexcept(false)
+         {
+            if (bytes_.empty()) {
+               malformed("unexpected end");
+            }
+            auto const result = static_cast<std::uint8_t>(bytes_.front());
+            bytes_.remove_prefix(1);
+            return result;
+         }
+
+         std::string_view characters(std::uint64_t const n) noexcept(false)
+         {
+            if (n > bytes_.size()) {
+               malformed("unexpected end");
+            }
+            auto const result = bytes_.substr(0, static_cast<std::size_t>(n));
+            bytes_.remove_prefix(result.size());
+            return result;
+         }
+
+         /// Reads a count of things that each take at least one byte, so that a damaged count
+         /// can't ask for more memory than the stream could describe.
+         ///
+         std::size_t count() noexcept(false)
+         {
+            auto const n = varint();
+            if (n > bytes_.size()) {
+               malformed("count is larger than the stream");
+            }
+            return static_cast<std::size_t>(n);
+         }
+
+         bool empty() const noexcept
+         { return bytes_.empty(); }
+      private:
+         std::string_view bytes_;
+      };
+   } // namespace
+
+   std::string write_token_stream(token_buffer const& tokens)
+   {
+      auto strings = std::unordered_map<std::string_view, std::size_t>{};
+      auto string_table = std::string{};
+      auto token_section = std::string{};
+      token_section.reserve(3 * tokens.size());
+
+      auto last_spelling = std::array<std::optional<std::string_view>, kind_count>{};
+      auto end = std::uint32_t{0};
+      for (auto i = std::size_t{0}; i != tokens.size(); ++i) {
+         auto const kind = tokens.kind(i);
+         auto const offset = tokens.location(i).offset;
+         if (kind == token_kind::eof) {
+            token_section += static_cast<char>(kind);
+            put_varint(token_section, offset - end);
+            end = offset;
+            continue;
+         }
+
+         auto const spelling = tokens.spelling(i);
+         auto& last = last_spelling[static_cast<std::size_t>(kind)];
+         if (last == spelling) {
+            token_section += static_cast<char>(static_cast<std::uint8_t>(kind) | same_spelling);
+            put_varint(token_section, offset - end);
+         }
+         else {
+            last = spelling;
+            token_section += static_cast<char>(kind);
+            put_varint(token_section, offset - end);
+
+            auto const [entry, inserted] = strings.try_emplace(spelling, strings.size());
+            if (inserted) {
+               put_varint(string_table, spelling.size());
+               string_table += spelling;
+            }
+            put_varint(token_section, entry->second);
+         }
+         end = offset + static_cast<std::uint32_t>(spelling.size());
+      }
+
+      auto const& line_starts = tokens.lines().line_starts();
+      auto result = std::string{magic};
+      put_varint(result, token_stream_version);
+      put_varint(result, strings.size());
+      put_varint(result, line_starts.size());
+      put_varint(result, tokens.size());
+      result += string_table;
+      for (auto i = std::size_t{1}; i < line_starts.size(); ++i) {
+         put_varint(result, line_starts[i] - line_starts[i - 1]);
+      }
+      result += token_section;
+      return result;
+   }
+
+   std::vector<token> read_token_stream(std::string_view const bytes) noexcept(false)
+   {
+      auto in = stream_reader{bytes};
+      if (in.characters(std::min(magic.size(), bytes.size())) != magic) {
+         throw std::runtime_error{"not a token stream"};
+      }
+
+      if (auto const version = in.varint(); version != token_stream_version) {
+         throw std::runtime_error{"unsupported token stream version " + std::to_string(version)};
+      }
+
+      auto const string_count = in.count();
+      auto const line_count = in.count();
+      auto const token_count = in.count();
+
+      auto strings = std::vector<std::string_view>(string_count);
+      for (auto& s : strings) {
+         s = in.characters(in.varint());
+      }
+
+      constexpr auto max_offset = std::uint64_t{std::numeric_limits<std::uint32_t>::max()};
+      auto line_starts = std::vector<std::uint32_t>{0};
+      line_starts.reserve(line_count);
+      for (auto i = std::size_t{1}; i < line_count; ++i) {
+         auto const start = line_starts.back() + in.varint();
+         if (start == line_starts.back() or start > max_offset) {
+            malformed("line starts aren't ascending");
+         }
+         line_starts.push_back(static_cast<std::uint32_t>(start));
+      }
+
+      auto last_spelling = std::array<std::optional<std::string_view>, kind_count>{};
+      auto result = std::vector<token>{};
+      result.reserve(token_count);
+      auto end = std::uint64_t{0};
+      for (auto i = std::size_t{0}; i != token_count; ++i) {
+         auto const kind_byte = in.byte();
+         auto const kind_index = static_cast<std::size_t>(kind_byte & ~same_spelling);
+         if (kind_index >= kind_count) {
+            malformed("unknown token kind");
+         }
+
+         auto const kind = static_cast<token_kind>(kind_index);
+         auto const offset = end + in.varint();
+         if (offset > max_offset) {
+            malformed("offset doesn't fit in 32 bits");
+         }
+
+         auto spelling = eof_spelling;
+         auto length = std::size_t{0};
+         if (kind != token_kind::eof) {
+            auto& last = last_spelling[kind_index];
+            if ((kind_byte & same_spelling) == 0) {
+               auto const index = in.varint();
+               if (index >= strings.size()) {
+                  malformed("string index is out of range");
+               }
+               last = strings[static_cast<std::size_t>(index)];
+            }
+            else if (not last) {
+               malformed("no earlier token of the same kind");
+            }
+            spelling = *last;
+            length = spelling.size();
+         }
+
+         auto const begin = line_table::coordinate(line_starts, static_cast<std::uint32_t>(offset));
+         auto const end_coordinate = source_coordinate{
+            begin.line(),
+            begin.column() + source_coordinate::column_type{static_cast<std::intmax_t>(length)}
+         };
+         result.emplace_back(borrowed_spelling, kind, spelling, begin, end_coordinate);
+         end = offset + length;
+      }
+
+      if (not in.empty()) {
+         malformed("trailing bytes");
+      }
+      return result;
+   }
+} // namespace ltcpp
@@ -0,0 +1,132 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/line_table.hpp"
+
+#include "ltcpp/lexer/detail/simd.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace ltcpp {
+   namespace {
+      void check_size(std::string_view const source) noexcept(false)
+      {
+         if (source.size() > std::size_t{std::numeric_limits<std::uint32_t>::max()}) {
+            throw std::length_error{"line_table can't index a source larger than 4 GiB"};
+         }
+      }
+
+      std::pmr::vector<std::uint32_t>
+      find_line_starts(std::string_view const source, std::pmr::memory_resource* const memory) noexcept(false)
+      {
+         check_size(source);
+
+         // Lines rarely average fewer than 32 characters, so this is usually the only allocation.
+         auto line_starts = std::pmr::vector<std::uint32_t>{memory};
+         line_starts.reserve(source.size() / 32 + 1);
+         line_starts.push_back(0);
+         detail_lexer::simd::append_line_starts(source, line_starts);
+         return line_starts;
+      }
+
+      template<class LineStarts>
+      source_coordinate coordinate_in(LineStarts const& line_starts, std::uint32_t const offset) noexcept
+      {
+         auto const next_line = std::ranges::upper_bound(line_starts, offset);
+         auto const line = next_line - std::ranges::begin(line_starts);
+         auto const column = std::intmax_t{offset - *std::ranges::prev(next_line)} + 1;
+         return source_coordinate{
+            source_coordinate::line_type{static_cast<std::intmax_t>(line)},
+            source_coordinate::column_type{column}
+         };
+      }
+   } // namespace
+
+   line_table::line_table(std::string_view const source, std::pmr::memory_resource* const memory)
+      noexcept(false)
+      : line_starts_{find_line_starts(source, memory)}
+   {}
+
+   std::uint32_t line_table::edit(std::string_view const source, text_edit const change) noexcept(false)
+   {
+      check_size(source);
+
+      // A line start that precedes the change was decided by characters that are all before it,
+      // and the scan that found it had paired up every line break before it, so the scan can
+      // resume there. It stops at the first line start past the change that the old scan also
+      // found, since from there on the two scans see the same characters in the same state.
+      auto const kept = static_cast<std::size_t>(std::max(
+         std::ranges::lower_bound(line_starts_, change.offset) - line_starts_.begin(), std::ptrdiff_t{1}));
+      auto const changed_end = change.offset + change.inserted;
+      auto const shift = static_cast<std::uint32_t>(change.inserted - change.removed);
+
+      auto found = std::pmr::vector<std::uint32_t>{line_starts_.get_allocator()};
+      auto resume = line_starts_.end();
+      auto i = std::size_t{line_starts_[kept - 1]};
+      for (;;) {
+         i += detail_lexer::simd::find_line_break(source.substr(i));
+         if (i == source.size()) {
+            break;
+         }
+
+         auto const c = source[i];
+         auto const next = i + 1 < source.size() ? source[i + 1] : '\0';
+         auto const paired = (c == '\n' and next == '\r') or (c == '\r' and next == '\n');
+         i += paired ? 2 : 1;
+         if (c == '\r' and not paired) {
+            continue;
+         }
+
+         if (i >= changed_end) {
+            resume = std::ranges::lower_bound(line_starts_.begin() + static_cast<std::ptrdiff_t>(kept),
+               line_starts_.end(), static_cast<std::uint32_t>(i) - shift);
+            if (resume != line_starts_.end() and *resume == static_cast<std::uint32_t>(i) - shift) {
+               break;
+            }
+            resume = line_starts_.end();
+         }
+         found.push_back(static_cast<std::uint32_t>(i));
+      }
+
+      auto const resumed = static_cast<std::size_t>(resume - line_starts_.begin());
+      line_starts_.replace(kept, resumed - kept, found);
+      line_starts_.shift_tail(shift);
+      return static_cast<std::uint32_t>(i);
+   }
+
+   void line_table::join_lines(std::uint32_t const begin, std::uint32_t const end) noexcept
+   {
+      auto const first = std::ranges::upper_bound(line_starts_, begin);
+      auto const last = std::ranges::upper_bound(first, line_starts_.end(), end);
+      line_starts_.replace(static_cast<std::size_t>(first - line_starts_.begin()),
+         static_cast<std::size_t>(last - first), std::span<std::uint32_t const>{});
+   }
+
+   source_coordinate line_table::coordinate(std::uint32_t const offset) const noexcept
+   { return coordinate_in(line_starts_, offset); }
+
+   source_coordinate
+   line_table::coordinate(std::span<std::uint32_t const> const line_starts, std::uint32_t const offset) noexcept
+   { return coordinate_in(line_starts, offset); }
+} // namespace ltcpp
@@ -0,0 +1,125 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/source_file.hpp"
+
+#include "ltcpp/detail/file_descriptor.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <filesystem>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace ltcpp {
+   namespace {
+      using detail::file_descriptor;
+      using detail::throw_system_error;
+
+      /// Reads until end-of-file. `size_hint` is only a starting capacity, since pipes and
+      /// character devices don't know how much they hold.
+      ///
+      std::vector<char> read_all(int const fd, std::size_t const size_hint,
+         std::filesystem::path const& path) noexcept(false)
+      {
+         constexpr auto minimum_read = std::size_t{16 * 1024};
+         auto buffer = std::vector<char>(std::max(size_hint, minimum_read));
+         auto size = std::size_t{0};
+         for (;;) {
+            if (size == buffer.size()) {
+               buffer.resize(buffer.size() * 2);
+            }
+
+            auto const result = ::read(fd, buffer.data() + size, buffer.size() - size);
+            if (result == 0) {
+               buffer.resize(size);
+               return buffer;
+            }
+            if (result == -1) {
+               if (errno == EINTR) {
+                  continue;
+               }
+               throw_system_error("unable to read", path);
+            }
+            size += static_cast<std::size_t>(result);
+         }
+      }
+   } // namespace
+
+   source_file::source_file(std::filesystem::path const& path) noexcept(false)
+   {
+      auto const fd = file_descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+      if (fd.get() == -1) {
+         throw_system_error("unable to open", path);
+      }
+
+      struct ::stat status{};
+      if (::fstat(fd.get(), &status) == -1) {
+         throw_system_error("unable to stat", path);
+      }
+
+      auto const size = static_cast<std::size_t>(status.st_size);
+      if (not S_ISREG(status.st_mode) or size < minimum_mapping_size) {
+         buffer_ = read_all(fd.get(), S_ISREG(status.st_mode) ? size + 1 : 0, path);
+         text_ = std::string_view{buffer_.data(), buffer_.size()};
+         return;
+      }
+
+      mapping_ = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+      if (mapping_ == MAP_FAILED) {
+         mapping_ = nullptr;
+         throw_system_error("unable to map", path);
+      }
+
+      // The lexer makes a single forward pass, so the kernel can read ahead aggressively and
+      // drop pages behind us. Both are hints; failing to apply them isn't an error.
+      ::madvise(mapping_, size, MADV_SEQUENTIAL);
+      ::madvise(mapping_, size, MADV_WILLNEED);
+      text_ = std::string_view{static_cast<char const*>(mapping_), size};
+   }
+
+   source_file::source_file(source_file&& other) noexcept
+      : mapping_{std::exchange(other.mapping_, nullptr)}
+      , buffer_{std::move(other.buffer_)}
+      , text_{std::exchange(other.text_, {})}
+   {}
+
+   source_file& source_file::operator=(source_file&& other) noexcept
+   {
+      if (this != &other) {
+         release();
+         mapping_ = std::exchange(other.mapping_, nullptr);
+         buffer_ = std::move(other.buffer_);
+         text_ = std::exchange(other.text_, {});
+      }
+      return *this;
+   }
+
+   source_file::~source_file()
+   { release(); }
+
+   void source_file::release() noexcept
+   {
+      if (mapping_ != nullptr) {
+         ::munmap(mapping_, text_.size());
+         mapping_ = nullptr;
+      }
+   }
+} // namespace ltcpp
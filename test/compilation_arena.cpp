@@ -0,0 +1,113 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/compilation_arena.hpp"
+
+#include "ltcpp/lexer/interner.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/reporter.hpp"
+#include "./simple_test.hpp"
+#include <cstddef>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+   /// Counts the blocks that pass through it on their way to and from the heap.
+   ///
+   class counting_resource : public std::pmr::memory_resource {
+   public:
+      std::size_t allocations = 0;
+      std::size_t deallocations = 0;
+   private:
+      void* do_allocate(std::size_t const bytes, std::size_t const alignment) override
+      {
+         ++allocations;
+         return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+      }
+
+      void do_deallocate(void* const p, std::size_t const bytes, std::size_t const alignment) override
+      {
+         ++deallocations;
+         std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+      }
+
+      bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+      { return this == &other; }
+   };
+} // namespace
+
+int main()
+{
+   // Checks that lexing into a compilation_arena allocates a handful of blocks, and frees them in
+   // one go.
+   auto source = std::string{};
+   for (auto i = 0; i != 200; ++i) {
+      source += "fun f" + std::to_string(i) + "(x: int32) -> int32 {\n"
+                "   let y <- x * 2; // double it\n"
+                "   return \"tab\\there\";\n"
+                "}\n";
+   }
+
+   auto errors = std::ostringstream{};
+   auto report = ltcpp::reporter{errors};
+   auto const expected = ltcpp::token_buffer{source, report};
+
+   { // A token_buffer built in an arena is the same as one built on the heap
+      auto upstream = counting_resource{};
+      {
+         auto arena = ltcpp::compilation_arena{source, &upstream};
+         auto const tokens = ltcpp::token_buffer{source, report, ltcpp::file_id{}, arena.resource()};
+         CHECK(tokens.size() == expected.size());
+         for (auto i = std::size_t{0}; i != expected.size(); ++i) {
+            CHECK(tokens[i] == expected[i]);
+         }
+
+         // This source is denser than the arena's estimate, so the token arrays outgrow their first
+         // reservation, but that costs a block or two more, not one per token.
+         CHECK(upstream.allocations <= 4U);
+      }
+      CHECK(upstream.deallocations == upstream.allocations);
+   }
+
+   { // Interned spellings and decoded literals can share the arena
+      auto upstream = counting_resource{};
+      auto arena = ltcpp::compilation_arena{4096, &upstream};
+      auto symbols = ltcpp::interner{arena.resource()};
+      auto decoded = std::pmr::string{};
+      for (auto i = std::size_t{0}; i != expected.size(); ++i) {
+         switch (expected.kind(i)) {
+         case ltcpp::token_kind::identifier:
+            symbols.intern(expected.spelling(i));
+            break;
+         case ltcpp::token_kind::string_literal:
+            decoded = expected[i].decoded_spelling(arena.resource());
+            break;
+         default:
+            break;
+         }
+      }
+      CHECK(symbols.size() == 202U); // f0..f199, x, and y
+      CHECK(decoded == "\"tab\there\"");
+      CHECK(upstream.allocations > 0U);
+
+      arena.release();
+      CHECK(upstream.deallocations == upstream.allocations);
+   }
+
+   return ::test_result();
+}
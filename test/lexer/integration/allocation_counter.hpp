@@ -0,0 +1,46 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef TEST_LEXER_ALLOCATION_COUNTER_HPP
+#define TEST_LEXER_ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/// \brief The number of times the global operator new has been called.
+///
+/// Tests that check something doesn't allocate compare this before and after. The replacement
+/// allocation functions below can't be inline, so include this header from exactly one
+/// translation unit per test.
+///
+inline std::size_t allocations = 0;
+
+void* operator new(std::size_t const size)
+{
+   ++allocations;
+   if (auto* const p = std::malloc(size == 0 ? 1 : size)) {
+      return p;
+   }
+   throw std::bad_alloc{};
+}
+
+void operator delete(void* const p) noexcept
+{ std::free(p); }
+
+void operator delete(void* const p, std::size_t) noexcept
+{ std::free(p); }
+
+#endif // TEST_LEXER_ALLOCATION_COUNTER_HPP
@@ -0,0 +1,134 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/batch_lexing.hpp"
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_location.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "../../simple_test.hpp"
+
+namespace {
+   /// Checks that a file lexed in a batch has the tokens and diagnostics it has on its own.
+   ///
+   void check_same_as_alone(ltcpp::lexed_file const& lexed, std::string_view const source,
+      std::size_t const index)
+   {
+      auto expected_errors = std::ostringstream{};
+      auto expected_report = ltcpp::reporter{expected_errors};
+      auto const expected = ltcpp::token_buffer{source, expected_report};
+
+      CHECK(lexed.tokens.source().data() == source.data());
+      CHECK(lexed.tokens.size() == expected.size());
+      for (auto i = std::size_t{0}; i < lexed.tokens.size() and i < expected.size(); ++i) {
+         CHECK(lexed.tokens[i] == expected[i]);
+         CHECK(lexed.tokens.integral_value(i) == expected.integral_value(i));
+         CHECK(lexed.tokens.location(i).file == ltcpp::file_id{static_cast<std::uint32_t>(index)});
+      }
+      CHECK(lexed.diagnostics == expected_errors.str());
+      CHECK(lexed.errors == expected_report.errors());
+      CHECK(lexed.warnings == expected_report.warnings());
+   }
+
+   /// A few large files among many small ones, some of which have lexical errors.
+   ///
+   std::vector<std::string> make_sources()
+   {
+      constexpr auto line = std::string_view{"let x <- 123 + 4.5e6; // comment\n"};
+      constexpr auto broken = std::string_view{"let y <- \"unterminated\n 1.2.3 @ /* unterminated"};
+      auto sources = std::vector<std::string>{};
+      for (auto i = 0; i != 60; ++i) {
+         auto source = std::string{};
+         auto const lines = i % 20 == 7 ? 5'000 : i % 7;
+         for (auto j = 0; j != lines; ++j) {
+            source += line;
+         }
+         if (i % 3 == 0) {
+            source += broken;
+         }
+         sources.push_back(std::move(source));
+      }
+      return sources;
+   }
+
+   std::filesystem::path write_temporary(std::string_view const name, std::string const& contents)
+   {
+      auto path = std::filesystem::temp_directory_path() / name;
+      auto out = std::ofstream{path, std::ios_base::binary};
+      out << contents;
+      return path;
+   }
+} // namespace
+
+int main()
+{
+   // Check that lexing a batch of files on several threads produces what lexing each on its own
+   // does, in the order that the files were given.
+   auto const sources = make_sources();
+   auto const views = std::vector<std::string_view>(sources.begin(), sources.end());
+
+   for (auto const threads : {0U, 1U, 2U, 3U, 8U, 100U}) {
+      auto const lexed = ltcpp::lex_files(views, ltcpp::batch_lexing{threads});
+      CHECK(lexed.size() == views.size());
+      for (auto i = std::size_t{0}; i < lexed.size() and i < views.size(); ++i) {
+         check_same_as_alone(lexed[i], views[i], i);
+      }
+   }
+
+   { // Empty batches
+      CHECK(ltcpp::lex_files(std::vector<std::string_view>{}).empty());
+      CHECK(ltcpp::lex_files(std::vector<std::filesystem::path>{}).empty());
+   }
+
+   { // Files are read as well as lexed on the pool
+      auto paths = std::vector<std::filesystem::path>{};
+      for (auto i = std::size_t{0}; i != 12; ++i) {
+         paths.push_back(write_temporary("ltcpp-batch-lexing-" + std::to_string(i) + ".lt", sources[i]));
+      }
+
+      auto const lexed = ltcpp::lex_files(paths, ltcpp::batch_lexing{4});
+      CHECK(lexed.size() == paths.size());
+      for (auto i = std::size_t{0}; i < lexed.size() and i < paths.size(); ++i) {
+         CHECK(lexed[i].file.text() == sources[i]);
+         check_same_as_alone(lexed[i].lexed, lexed[i].file.text(), i);
+      }
+
+      // A file that can't be read fails the whole batch.
+      paths.insert(paths.begin() + 5, "/this/path/does/not/exist.lt");
+      auto threw = false;
+      try {
+         auto const unused = ltcpp::lex_files(paths, ltcpp::batch_lexing{4});
+      }
+      catch (std::system_error const&) {
+         threw = true;
+      }
+      CHECK(threw);
+
+      for (auto const& path : paths) {
+         std::filesystem::remove(path);
+      }
+   }
+
+   return ::test_result();
+}
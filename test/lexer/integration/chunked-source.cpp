@@ -0,0 +1,168 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/chunked_source.hpp"
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <cstddef>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <unistd.h>
+#include "./test_common.hpp"
+
+namespace {
+   std::vector<ltcpp::token> generate_chunked_tokens(ltcpp::chunked_source& in, ltcpp::reporter& report)
+   {
+      auto tokens = std::vector<ltcpp::token>{};
+      auto cursor = ltcpp::source_coordinate{};
+      for (;;) {
+         tokens.push_back(ltcpp::generate_token(in, report, cursor));
+         if (tokens.back().kind() == ltcpp::token_kind::eof) {
+            return tokens;
+         }
+         cursor = tokens.back().position().end();
+      }
+   }
+
+   /// Lexes source through a file with every chunk size in chunk_sizes, so that chunk boundaries
+   /// fall inside every kind of token, and checks that the result matches lexing the whole buffer.
+   ///
+   void check_same_as_buffer(std::string const& source)
+   {
+      auto expected_errors = std::ostringstream{};
+      auto expected_report = ltcpp::reporter{expected_errors};
+      auto const expected_tokens = generate_buffer_tokens(source, expected_report);
+
+      auto const path = std::filesystem::temp_directory_path() / "ltcpp-chunked-source.lt";
+      std::ofstream{path, std::ios_base::binary} << source;
+
+      for (auto const chunk_size : {1, 2, 3, 5, 8, 13, 64}) {
+         auto const fd = ::open(path.c_str(), O_RDONLY);
+         assert(fd != -1);
+         auto in = ltcpp::chunked_source{fd, static_cast<std::size_t>(chunk_size)};
+
+         auto errors = std::ostringstream{};
+         auto report = ltcpp::reporter{errors};
+         auto const tokens = generate_chunked_tokens(in, report);
+         ::close(fd);
+
+         CHECK_EQUAL(tokens, expected_tokens);
+         CHECK(report.errors() == expected_report.errors());
+         CHECK(errors.str() == expected_errors.str());
+      }
+      std::filesystem::remove(path);
+   }
+} // namespace
+
+int main()
+{
+   // Check that lexing through a chunked_source produces the same tokens and diagnostics as lexing
+   // the whole buffer, wherever the chunk boundaries fall.
+   check_same_as_buffer("");
+   check_same_as_buffer(
+      "// conforming program starting on line 2\n"
+      "fun main() -> int32\n"
+      "{\n"
+      "   print(\"Hello, world!\\n\");\n"
+      "}\n");
+   check_same_as_buffer("x <- 10.10.10 .956 a.b 543e 87. 2.5e+10 /");
+   check_same_as_buffer(
+      "\tfun\rmain($) -> void\r\n"
+      "}\n\r"
+      "\treturn\"This string is terminated.\"\n"
+      "\f"
+      "return\"This string is not terminated.\n"
+      "   return \"This string is also not terminated\\\"\n"
+      "\"\\q\" /* a\r\n*/ a/b<-c<=d!=e>=f->g // trailing\r\n");
+   check_same_as_buffer(
+      "fun main/*() -> int32\n"
+      "{\n"
+      "   abacus;\n"
+      "}\n");
+
+   { // Tokens from a chunked_source own their spellings, and keep them through copies and moves
+      auto window = std::string{"identifier"};
+      auto const at = ltcpp::source_coordinate{};
+      auto original = ltcpp::token{ltcpp::borrowed_spelling, ltcpp::token_kind::identifier, window, at, at};
+      original.own_spelling();
+      window.assign(window.size(), '?');
+      CHECK(original.spelling() == "identifier");
+
+      auto copy = original;
+      CHECK(copy == original);
+      CHECK(copy.spelling().data() != original.spelling().data());
+
+      auto const moved = std::move(original);
+      CHECK(moved == copy);
+
+      original = moved;
+      copy = ltcpp::token{ltcpp::token_kind::identifier, "other", at, at};
+      CHECK(original == moved);
+      CHECK(copy.spelling() == "other");
+   }
+
+   { // Memory is bounded by the chunk size plus the longest token; comments don't count
+      auto source = std::string{};
+      for (auto i = 0; i != 10'000; ++i) {
+         source += "let x <- y + 1;\n";
+      }
+      auto const short_tokens = source.size();
+      auto const comment = "/*" + std::string(10'000, '*') + "*/";
+      auto const identifier = std::string(10'000, 'z');
+      source += comment + "x " + identifier;
+
+      auto const path = std::filesystem::temp_directory_path() / "ltcpp-chunked-source-bound.lt";
+      std::ofstream{path, std::ios_base::binary} << source;
+      auto const fd = ::open(path.c_str(), O_RDONLY);
+      assert(fd != -1);
+
+      constexpr auto chunk_size = std::size_t{64};
+      auto in = ltcpp::chunked_source{fd, chunk_size};
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+
+      auto cursor = ltcpp::source_coordinate{};
+      auto t = ltcpp::generate_token(in, report, cursor);
+      for (; t.position().end().line() < ltcpp::source_coordinate::line_type{10'000};
+             t = ltcpp::generate_token(in, report, cursor)) {
+         cursor = t.position().end();
+      }
+      CHECK(in.capacity() == 2 * chunk_size);
+
+      for (; t.spelling() != "x"; t = ltcpp::generate_token(in, report, cursor)) {
+         cursor = t.position().end();
+      }
+      CHECK(in.capacity() == 2 * chunk_size);
+
+      for (; t.kind() != ltcpp::token_kind::eof; t = ltcpp::generate_token(in, report, cursor)) {
+         cursor = t.position().end();
+      }
+      CHECK(in.capacity() > identifier.size());
+      CHECK(in.capacity() < 4 * identifier.size());
+      CHECK(report.errors() == 0);
+      CHECK(short_tokens > in.capacity());
+
+      ::close(fd);
+      std::filesystem::remove(path);
+   }
+
+   return ::test_result();
+}
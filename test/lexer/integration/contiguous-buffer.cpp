@@ -0,0 +1,81 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include "./test_common.hpp"
+
+namespace {
+   void check_same_as_istream(std::string const& source)
+   {
+      auto istream_errors = std::ostringstream{};
+      auto istream_report = ltcpp::reporter{istream_errors};
+      auto const expected_tokens = generate_tokens(source, istream_report);
+
+      auto buffer_errors = std::ostringstream{};
+      auto buffer_report = ltcpp::reporter{buffer_errors};
+      auto const tokens = generate_buffer_tokens(source, buffer_report);
+
+      CHECK_EQUAL(tokens, expected_tokens);
+      for (auto const& t : tokens) {
+         // Tokens scanned from a buffer refer to their spellings there instead of copying them.
+         if (t.kind() != ltcpp::token_kind::eof) {
+            auto const spelling = t.spelling();
+            CHECK(source.data() <= spelling.data());
+            auto const spelling_end = spelling.data() + spelling.size();
+            auto const source_end = source.data() + source.size();
+            CHECK(spelling_end <= source_end);
+         }
+      }
+      CHECK(buffer_report.errors() == istream_report.errors());
+      CHECK(buffer_report.warnings() == istream_report.warnings());
+      CHECK(buffer_errors.str() == istream_errors.str());
+   }
+} // namespace
+
+int main()
+{
+   // Check that lexing a contiguous buffer produces the same tokens and diagnostics as lexing an
+   // std::istream over the same characters.
+   check_same_as_istream("");
+   check_same_as_istream(
+      "// conforming program starting on line 2\n"
+      "fun main() -> int32\n"
+      "{\n"
+      "   print(\"Hello, world!\\n\");\n"
+      "}\n");
+   check_same_as_istream("x <- 10.10.10 .956 a.b 543e 87. /");
+   check_same_as_istream(
+      "\tfun\rmain($) -> void\n"
+      "}\n"
+      "\treturn\"This string is terminated.\"\n"
+      "\f"
+      "return\"This string is not terminated.\n"
+      "   return \"This string is also not terminated\\\"\n"
+      "\"\\q\" /* */ a/b<-c<=d!=e>=f->g\n\r");
+   check_same_as_istream(
+      "fun main/*() -> int32\n"
+      "{\n"
+      "   abacus;\n"
+      "}\n");
+
+   return ::test_result();
+}
@@ -0,0 +1,175 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/text_edit.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "../../random_source.hpp"
+#include "../../simple_test.hpp"
+#include "./test_common.hpp"
+
+namespace {
+   /// Checks that tokens hold exactly what lexing source from scratch produces.
+   ///
+   void check_same_as_fresh(ltcpp::token_buffer const& tokens, std::string_view const source)
+   {
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto expected = ltcpp::token_buffer{source, report};
+      expected.decode_values();
+
+      check_same_tokens(tokens, expected);
+      CHECK(std::ranges::equal(tokens.lines().line_starts(), expected.lines().line_starts()));
+   }
+
+   /// Replaces `removed` characters of text from offset on with inserted, and the same in tokens.
+   ///
+   ltcpp::token_edit apply(ltcpp::token_buffer& tokens, std::string& text, std::size_t const offset,
+      std::size_t const removed, std::string_view const inserted, ltcpp::reporter& report)
+   {
+      text.replace(offset, removed, inserted);
+      auto const replaced = tokens.edit(text, ltcpp::text_edit{offset, removed, inserted.size()}, report);
+      check_same_as_fresh(tokens, text);
+      return replaced;
+   }
+} // namespace
+
+int main()
+{
+   // Check that editing a token_buffer gives what lexing the edited text from scratch does, and
+   // that only the tokens near the edit are lexed again.
+   auto errors = std::ostringstream{};
+   auto report = ltcpp::reporter{errors};
+
+   { // Edits within and between tokens
+      auto text = std::string{"let x <- 12 + y;\nlet z <- 3.5;\n"};
+      auto tokens = ltcpp::token_buffer{text, report};
+      tokens.decode_values();
+      CHECK(apply(tokens, text, 11, 0, "34", report) == (ltcpp::token_edit{3, 1, 1}));
+      CHECK(tokens.integral_value(3) == 1234U);
+      CHECK(apply(tokens, text, 4, 1, "width", report) == (ltcpp::token_edit{1, 1, 1}));
+
+      // Lexing catches up at the end of the first token that it had already found.
+      CHECK(apply(tokens, text, 0, 0, "// ", report) == (ltcpp::token_edit{0, 8, 1}));
+      CHECK(apply(tokens, text, 0, 3, "", report) == (ltcpp::token_edit{0, 1, 8}));
+
+      CHECK(apply(tokens, text, text.size(), 0, "w", report) == (ltcpp::token_edit{12, 1, 2}));
+      CHECK(apply(tokens, text, 0, text.size(), "", report) == (ltcpp::token_edit{0, 14, 1}));
+      CHECK(report.errors() == 0);
+   }
+
+   { // Only the tokens that were lexed again are diagnosed
+      auto text = std::string{"a\nb\nc\n"};
+      auto tokens = ltcpp::token_buffer{text, report};
+      tokens.decode_values();
+      apply(tokens, text, 2, 1, "@", report);
+      CHECK(report.errors() == 1);
+      CHECK(errors.str().find("2:1") != std::string::npos);
+      apply(tokens, text, 4, 0, "d", report);
+      CHECK(report.errors() == 1);
+   }
+
+   { // The cost of an edit depends on what it changes, not on the size of the file
+      auto text = std::string{};
+      for (auto i = 0; i != 5'000; ++i) {
+         text += "let x <- \"a string\" + 'c'; /* comment */ // another\n";
+      }
+      auto tokens = ltcpp::token_buffer{text, report};
+      tokens.decode_values();
+
+      auto const middle = text.size() / 2 - text.size() / 2 % 52;
+      CHECK(apply(tokens, text, middle + 4, 1, "y", report).removed == 1U);
+      auto const opened = apply(tokens, text, middle + 10, 0, "\"", report);
+      CHECK(opened.removed < 10U);
+      CHECK(apply(tokens, text, middle + 10, 1, "", report).inserted < 10U);
+      auto const commented = apply(tokens, text, middle, 0, "/*", report);
+      CHECK(commented.removed < 20U);
+      CHECK(apply(tokens, text, middle, 2, "", report).inserted < 20U);
+
+      // An unterminated comment has to run to the end of the file.
+      CHECK(apply(tokens, text, middle + 4, 0, "/*", report).inserted == 1U);
+   }
+
+   { // Every line ending the lexer knows of, torn apart and put back together
+      auto text = std::string{"a\r\nb\n\rc\fd\re\n\n\r\nf /*\r\n\n\r*/ g\f\fh"};
+      auto tokens = ltcpp::token_buffer{text, report};
+      tokens.decode_values();
+      apply(tokens, text, 2, 1, "", report);
+      apply(tokens, text, 2, 0, "\n", report);
+      apply(tokens, text, 4, 0, "\r", report);
+      apply(tokens, text, 13, 2, "\n\r", report);
+      apply(tokens, text, 19, 0, "\r\n\r", report);
+   }
+
+   { // A '\f' in a literal doesn't end a line, but one that an edit moves out of a literal does
+      auto text = std::string{"a \"b\fc\" d\ne\f'\f' \"f\fg"};
+      auto tokens = ltcpp::token_buffer{text, report};
+      tokens.decode_values();
+      apply(tokens, text, 2, 1, "", report);
+      apply(tokens, text, 2, 0, "\"", report);
+      apply(tokens, text, 5, 0, "\f", report);
+      apply(tokens, text, 13, 1, "", report);
+      apply(tokens, text, 0, 0, "\"\f", report);
+   }
+
+   { // Random edits to random programs
+      constexpr auto alphabet = std::string_view{" \t\n\r\f*/\"'\\ab1.e+-<>!"};
+      auto seed = std::uint32_t{2'147'483'647};
+      auto const next = [&seed](std::size_t const bound) {
+         return std::size_t{random_below(seed, static_cast<std::uint32_t>(bound))};
+      };
+      auto const random_text = [&](std::size_t const size) { return random_source(seed, alphabet, next(size)); };
+
+      for (auto trial = 0; trial != 200; ++trial) {
+         auto text = random_text(200);
+         auto tokens = ltcpp::token_buffer{text, report};
+         tokens.decode_values();
+         for (auto edit = 0; edit != 10; ++edit) {
+            auto const offset = next(text.size() + 1);
+            auto const removed = next(std::min(text.size() - offset, std::size_t{8}) + 1);
+            apply(tokens, text, offset, removed, random_text(8), report);
+         }
+      }
+   }
+
+   { // Compacting an edited buffer makes its kinds one dense array again
+      auto text = std::string{"let x <- 12 + y;\nlet z <- 3.5;\n"};
+      auto tokens = ltcpp::token_buffer{text, report};
+      tokens.decode_values();
+      apply(tokens, text, 11, 0, " + 5", report);
+      apply(tokens, text, 4, 1, "width", report);
+      tokens.compact();
+      check_same_as_fresh(tokens, text);
+
+      auto expected = ltcpp::token_buffer{text, report};
+      CHECK(std::ranges::equal(tokens.kinds(), expected.kinds()));
+
+      // A compacted buffer can still be edited.
+      apply(tokens, text, text.size(), 0, "w", report);
+      tokens.compact();
+      expected = ltcpp::token_buffer{text, report};
+      CHECK(std::ranges::equal(tokens.kinds(), expected.kinds()));
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,193 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer_policy.hpp"
+#include "ltcpp/lexer/token_visitor.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "./test_common.hpp"
+
+namespace {
+   struct no_positions : ltcpp::unreported_lexer_policy {
+      static constexpr bool positions = false;
+   };
+
+   struct with_trivia : ltcpp::default_lexer_policy {
+      static constexpr bool trivia = true;
+   };
+
+   struct standalone_policy {
+      static constexpr bool positions = false;
+      static constexpr bool trivia = false;
+      static constexpr bool diagnostics = false;
+   };
+
+   struct trivia_without_positions : no_positions {
+      static constexpr bool trivia = true;
+   };
+
+   struct unreported_trivia : with_trivia {
+      static constexpr bool diagnostics = false;
+   };
+
+   /// Diagnostics are reported at positions, so a policy can't have one without the other.
+   struct diagnostics_without_positions : ltcpp::default_lexer_policy {
+      static constexpr bool positions = false;
+   };
+
+   static_assert(ltcpp::lexer_policy<standalone_policy>);
+   static_assert(not ltcpp::lexer_policy<diagnostics_without_positions>);
+
+   /// Trivia are recorded with the kind `eof`, which is never visited more than once at the end.
+   using visited_lexeme = std::tuple<ltcpp::token_kind, std::string_view, ltcpp::source_coordinate_range>;
+
+   struct recorder {
+      std::vector<visited_lexeme>* lexemes;
+      std::vector<bool>* is_trivia;
+
+      void operator()(ltcpp::token_kind const kind, std::string_view const spelling,
+         ltcpp::source_coordinate_range const position) const
+      {
+         lexemes->emplace_back(kind, spelling, position);
+         is_trivia->push_back(false);
+      }
+
+      void operator()(ltcpp::trivia_t, std::string_view const spelling,
+         ltcpp::source_coordinate_range const position) const
+      {
+         lexemes->emplace_back(ltcpp::token_kind::eof, spelling, position);
+         is_trivia->push_back(true);
+      }
+   };
+
+   template<class Policy>
+   std::vector<visited_lexeme> visit_all(std::string_view const source, ltcpp::reporter& report,
+      std::vector<bool>& is_trivia)
+   {
+      auto result = std::vector<visited_lexeme>{};
+      ltcpp::lex<Policy>(source, report, recorder{&result, &is_trivia});
+      return result;
+   }
+
+   template<class Policy>
+   std::vector<visited_lexeme> visit_all(std::string_view const source)
+   {
+      auto result = std::vector<visited_lexeme>{};
+      auto is_trivia = std::vector<bool>{};
+      ltcpp::lex<Policy>(source, recorder{&result, &is_trivia});
+      return result;
+   }
+} // namespace
+
+int main()
+{
+   // Check that each lexer policy keeps exactly the work that it asks for.
+   using ltcpp::source_coordinate;
+   using ltcpp::source_coordinate_range;
+   using ltcpp::token_kind;
+   using namespace std::string_view_literals;
+
+   constexpr auto source = "import io;\n"
+                           "fun main() -> int32 {\n"
+                           "   let x <- 10.5e3 + y; /* ignored\r\n */\n"
+                           "   return \"do\\qe\" @ x 1.2.3; // done\n"
+                           "}\n"
+                           "/* never closed\n"sv;
+   auto expected_errors = std::ostringstream{};
+   auto expected_report = ltcpp::reporter{expected_errors};
+   auto const expected = generate_buffer_tokens(source, expected_report);
+   auto const nowhere = source_coordinate_range{source_coordinate{}, source_coordinate{}};
+
+   { // The default policy does what generate_token does, diagnostics included
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto is_trivia = std::vector<bool>{};
+      auto const visited = visit_all<ltcpp::default_lexer_policy>(source, report, is_trivia);
+      CHECK(visited.size() == expected.size());
+      for (auto i = std::size_t{0}; i + 1 < expected.size(); ++i) {
+         CHECK(std::get<0>(visited[i]) == expected[i].kind());
+         CHECK(std::get<1>(visited[i]) == expected[i].spelling());
+         CHECK(std::get<2>(visited[i]) == expected[i].position());
+      }
+      CHECK(std::get<2>(visited.back()) == expected.back().position());
+      CHECK(errors.str() == expected_errors.str());
+      CHECK(report.errors() == expected_report.errors());
+   }
+
+   { // Without positions, tokens are still spelled, and the unterminated comment is visited
+      auto const visited = visit_all<no_positions>(source);
+      CHECK(visited.size() == expected.size() + 1);
+      for (auto i = std::size_t{0}; i + 1 < expected.size(); ++i) {
+         CHECK(std::get<0>(visited[i]) == expected[i].kind());
+         CHECK(std::get<1>(visited[i]) == expected[i].spelling());
+         CHECK(std::get<2>(visited[i]) == nowhere);
+      }
+
+      auto const& comment = visited[visited.size() - 2];
+      CHECK(std::get<0>(comment) == token_kind::unterminated_comment);
+      CHECK(std::get<1>(comment) == "/* never closed\n"sv);
+      CHECK(std::get<0>(visited.back()) == token_kind::eof);
+   }
+
+   { // A policy needn't derive from default_lexer_policy
+      auto const visited = visit_all<standalone_policy>(source);
+      auto const no_positions_visited = visit_all<no_positions>(source);
+      CHECK(visited == no_positions_visited);
+   }
+
+   { // Trivia and tokens together spell the whole source, in order and without gaps
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto is_trivia = std::vector<bool>{};
+      auto const visited = visit_all<with_trivia>(source, report, is_trivia);
+      CHECK(errors.str() == expected_errors.str());
+
+      auto spelled = std::string{};
+      auto tokens = std::size_t{0};
+      auto end = source_coordinate{};
+      for (auto i = std::size_t{0}; i + 1 < visited.size(); ++i) {
+         auto const& [kind, spelling, position] = visited[i];
+         CHECK(position.begin() == end);
+         end = position.end();
+         spelled += spelling;
+         if (not is_trivia[i]) {
+            CHECK(kind == expected[tokens++].kind());
+         }
+      }
+      CHECK(spelled == source);
+      CHECK(tokens == expected.size() - 1);
+      CHECK(std::get<2>(visited.back()) == expected.back().position());
+
+      // When the unterminated comment isn't reported, it's a token of its own rather than trivia.
+      auto const unreported = visit_all<unreported_trivia>(source);
+      auto const& comment = unreported[unreported.size() - 2];
+      CHECK(std::get<0>(comment) == token_kind::unterminated_comment);
+      CHECK(std::get<2>(comment).begin() == (std::get<2>(unreported[unreported.size() - 3]).end()));
+
+      auto const unpositioned = visit_all<trivia_without_positions>(source);
+      CHECK(unpositioned.size() == unreported.size());
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,163 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/lexer_state.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../random_source.hpp"
+#include "./test_common.hpp"
+
+namespace {
+   /// Lexes source from windows that are `window_size` characters long, widening a window only
+   /// when the lexer asks for more, so that windows end inside every kind of token and comment.
+   ///
+   std::vector<ltcpp::token>
+   generate_windowed_tokens(std::string_view const source, std::size_t const window_size,
+      ltcpp::reporter& report)
+   {
+      auto tokens = std::vector<ltcpp::token>{};
+      auto state = ltcpp::lexer_state{};
+      auto size = window_size;
+      for (;;) {
+         auto in = source.substr(state.offset, size);
+         auto const end_of_source = state.offset + in.size() == source.size();
+         auto t = ltcpp::generate_token(in, state, report, end_of_source);
+         if (not t) {
+            size += window_size;
+            continue;
+         }
+
+         size = window_size;
+         tokens.push_back(std::move(*t));
+         if (tokens.back().kind() == ltcpp::token_kind::eof) {
+            return tokens;
+         }
+      }
+   }
+
+   void check_same_as_buffer(std::string const& source)
+   {
+      auto expected_errors = std::ostringstream{};
+      auto expected_report = ltcpp::reporter{expected_errors};
+      auto const expected_tokens = generate_buffer_tokens(source, expected_report);
+
+      for (auto const window_size : {1, 2, 3, 5, 8, 13, 64}) {
+         auto errors = std::ostringstream{};
+         auto report = ltcpp::reporter{errors};
+         auto const tokens = generate_windowed_tokens(source, static_cast<std::size_t>(window_size),
+            report);
+
+         CHECK_EQUAL(tokens, expected_tokens);
+         CHECK(report.errors() == expected_report.errors());
+         CHECK(errors.str() == expected_errors.str());
+      }
+   }
+} // namespace
+
+int main()
+{
+   // Check that lexing can be stopped anywhere and restarted from a lexer_state, producing the
+   // same tokens and diagnostics as lexing the whole source at once.
+   using ltcpp::lexer_mode;
+   using ltcpp::lexer_state;
+   using namespace std::string_literals;
+   using namespace std::string_view_literals;
+
+   check_same_as_buffer("");
+   check_same_as_buffer(
+      "// conforming program starting on line 2\n"
+      "fun main() -> int32\n"
+      "{\n"
+      "   print(\"Hello, world!\\n\");\n"
+      "}\n");
+   check_same_as_buffer(
+      "\tfun\rmain($) -> void\r\n"
+      "}\n\r"
+      "\treturn\"This string is terminated.\"\n"
+      "\f"
+      "return\"This string is not terminated.\n"
+      "\"\\q\" /* a\r\n*/ a/b<-c<=d!=e>=f->g // trailing\r\n"
+      "// lone\rreturns\r/**/x/*/ ** \n\r\f */y//\n\r");
+   check_same_as_buffer("x <- 10.10.10 .956 a.b 543e 87. 2.5e+10 /");
+   check_same_as_buffer("fun main/*() -> int32\n{\n   abacus;\n}\n");
+
+   { // Random sources, so that windows end between every pair of characters that matter
+      constexpr auto alphabet = " \t\n\r\f*/\"'\\a1.e+"sv;
+      auto seed = std::uint32_t{2'147'483'647};
+      for (auto trial = 0; trial != 500; ++trial) {
+         check_same_as_buffer(random_source(seed, alphabet, static_cast<std::size_t>(trial % 89)));
+      }
+   }
+
+   { // A snapshot taken inside a long comment restarts there, even after a round trip as bytes
+      auto const source = "a /*" + std::string(1'000, '*') + "\n */ b"s;
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+
+      auto state = lexer_state{};
+      auto in = std::string_view{source}.substr(0, 500);
+      auto t = ltcpp::generate_token(in, state, report, false);
+      assert(t.has_value());
+      CHECK(t->spelling() == "a");
+
+      t = ltcpp::generate_token(in, state, report, false);
+      CHECK(not t.has_value());
+      CHECK(in.size() == 500 - state.offset);
+      CHECK(state.mode == lexer_mode::in_block_comment);
+      CHECK(state.offset < 500U);
+      CHECK(state.offset > 490U);
+      CHECK(state.comment_begin == ltcpp::source_coordinate{ltcpp::source_coordinate::line_type{1},
+         ltcpp::source_coordinate::column_type{3}});
+
+      auto bytes = std::array<unsigned char, sizeof(lexer_state)>{};
+      std::memcpy(bytes.data(), &state, sizeof(state));
+      auto restored = lexer_state{};
+      std::memcpy(&restored, bytes.data(), sizeof(restored));
+      CHECK(restored == state);
+
+      in = std::string_view{source}.substr(restored.offset);
+      t = ltcpp::generate_token(in, restored, report);
+      assert(t.has_value());
+      CHECK(t->spelling() == "b");
+      CHECK(restored.mode == lexer_mode::between_tokens);
+      CHECK(restored.offset == source.size());
+      CHECK(restored.cursor == t->position().end());
+      CHECK(report.errors() == 0);
+   }
+
+   { // An unterminated comment is reported where it began, once, however it was split
+      auto const source = "x /* never\nends"s;
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto const tokens = generate_windowed_tokens(source, 1, report);
+      CHECK(tokens.size() == 2U);
+      CHECK(report.errors() == 1);
+   }
+
+   return ::test_result();
+}
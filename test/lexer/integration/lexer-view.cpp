@@ -0,0 +1,128 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/lexer_view.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "./allocation_counter.hpp"
+#include "./test_common.hpp"
+
+int main()
+{
+   // Check that lexer_view is a lazy input range whose lookahead agrees with iterating.
+   using ltcpp::lexer_view;
+   using ltcpp::token_kind;
+   using namespace std::string_view_literals;
+
+   static_assert(std::ranges::input_range<lexer_view<std::istream>>);
+   static_assert(std::ranges::view<lexer_view<std::string_view>>);
+   static_assert(not std::ranges::forward_range<lexer_view<std::string_view>>);
+   static_assert(std::same_as<std::ranges::range_reference_t<lexer_view<std::string_view>>,
+      ltcpp::token const&>);
+
+   constexpr auto source = "fun main() -> int32 {\n"
+                           "   let x <- 10.5e3 + y; // ignored\n"
+                           "   return \"done\" @ x;\n"
+                           "}\n"sv;
+   auto errors = std::ostringstream{};
+   auto report = ltcpp::reporter{errors};
+   auto const expected = generate_buffer_tokens(source, report);
+
+   { // Every kind of source produces the same tokens, up to and including eof
+      auto in = std::istringstream{std::string{source}};
+      in.unsetf(std::ios_base::skipws);
+      auto from_stream = std::vector<ltcpp::token>{};
+      for (auto const& t : lexer_view{in, report}) {
+         from_stream.push_back(t);
+      }
+      CHECK_EQUAL(from_stream, expected);
+
+      auto from_buffer = std::vector<ltcpp::token>{};
+      for (auto const& t : lexer_view{source, report}) {
+         from_buffer.push_back(t);
+      }
+      CHECK_EQUAL(from_buffer, expected);
+   }
+
+   { // peek looks ahead without consuming, and stops at eof
+      auto view = lexer_view<std::string_view, 3>{source, report};
+      for (auto i = std::size_t{0}; i != expected.size(); ++i) {
+         CHECK(view.peek() == expected[i]);
+         CHECK(view.peek(1) == expected[std::min(i + 1, expected.size() - 1)]);
+         CHECK(view.peek(2) == expected[std::min(i + 2, expected.size() - 1)]);
+         CHECK(view.peek(1) == expected[std::min(i + 1, expected.size() - 1)]);
+         view.consume();
+      }
+      CHECK(view.begin() == view.end());
+      CHECK(view.peek(2).kind() == token_kind::eof);
+   }
+
+   { // A capacity of one is just the current token
+      auto view = lexer_view<std::string_view, 1>{source, report};
+      CHECK(std::ranges::distance(view) == static_cast<std::ptrdiff_t>(expected.size()));
+   }
+
+   { // Tokens are lexed only as they're needed, so diagnostics arrive in step with them
+      auto const before = report.errors();
+      auto view = lexer_view{source, report};
+      auto i = view.begin();
+      while (i->kind() != token_kind::return_) {
+         ++i;
+      }
+      CHECK(report.errors() == before);
+      CHECK(view.peek(2).kind() == token_kind::unknown_token);
+      CHECK(report.errors() == before + 1);
+   }
+
+   { // Views compose with the standard range adaptors
+      auto identifiers = std::vector<std::string_view>{};
+      for (auto const spelling : lexer_view{source, report}
+                                 | std::views::filter([](ltcpp::token const& t) {
+                                      return t.kind() == token_kind::identifier;
+                                   })
+                                 | std::views::transform(&ltcpp::token::spelling)) {
+         identifiers.push_back(spelling);
+      }
+      CHECK(identifiers == (std::vector{"main"sv, "x"sv, "y"sv, "x"sv}));
+   }
+
+   { // Iterating over a buffer allocates nothing per token
+      auto long_source = std::string{};
+      for (auto i = 0; i != 1'000; ++i) {
+         long_source += "let a_rather_long_identifier <- \"and a rather long string literal\";\n";
+      }
+      auto silent = std::ostringstream{};
+      auto silent_report = ltcpp::reporter{silent};
+      auto view = lexer_view{std::string_view{long_source}, silent_report};
+
+      auto const before = allocations;
+      auto count = 0;
+      for (auto const& t : view) {
+         count += t.kind() == token_kind::identifier;
+      }
+      CHECK(allocations == before);
+      CHECK(count == 1'000);
+   }
+
+   return ::test_result();
+}
@@ -99,21 +99,21 @@ int main()
       },
       token{
          token_kind::string_literal,
-         "\"Hello, world!\n\"",
+         "\"Hello, world!\\n\"",
          source_coordinate{line_type{3}, column_type{10}},
-         source_coordinate{line_type{3}, column_type{26}}
+         source_coordinate{line_type{3}, column_type{27}}
       },
       token{
          token_kind::paren_close,
          ")",
-         source_coordinate{line_type{3}, column_type{26}},
-         source_coordinate{line_type{3}, column_type{27}}
+         source_coordinate{line_type{3}, column_type{27}},
+         source_coordinate{line_type{3}, column_type{28}}
       },
       token{
          token_kind::semicolon,
          ";",
-         source_coordinate{line_type{3}, column_type{27}},
-         source_coordinate{line_type{3}, column_type{28}}
+         source_coordinate{line_type{3}, column_type{28}},
+         source_coordinate{line_type{3}, column_type{29}}
       },
       token{
          token_kind::brace_close,
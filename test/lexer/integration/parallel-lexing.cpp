@@ -0,0 +1,118 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "../../random_source.hpp"
+#include "../../simple_test.hpp"
+#include "./test_common.hpp"
+
+namespace {
+   /// Checks that splitting source into chunks of every size from one character up changes
+   /// nothing about the tokens or diagnostics.
+   ///
+   void check_same_as_sequential(std::string_view const source, std::size_t const threads = 4)
+   {
+      auto expected_errors = std::ostringstream{};
+      auto expected_report = ltcpp::reporter{expected_errors};
+      auto expected = ltcpp::token_buffer{source, expected_report};
+      expected.decode_values();
+
+      for (auto chunk_size = std::size_t{1}; chunk_size <= source.size(); chunk_size = chunk_size * 3 / 2 + 1) {
+         auto errors = std::ostringstream{};
+         auto report = ltcpp::reporter{errors};
+         auto tokens = ltcpp::token_buffer{source, report, ltcpp::parallel_lexing{threads, chunk_size}};
+         tokens.decode_values();
+
+         check_same_tokens(tokens, report, errors, expected, expected_report, expected_errors);
+      }
+   }
+} // namespace
+
+int main()
+{
+   // Check that lexing on several threads produces what lexing on one does, wherever the chunks
+   // happen to begin.
+   check_same_as_sequential("");
+   check_same_as_sequential(
+      "fun main() -> int32\n"
+      "{\n"
+      "   let x <- 12345678901234 + 0.5e3;\n"
+      "   print(\"Hello, world!\\n\");\n"
+      "}\n");
+
+   // Chunks that begin inside multi-line comments.
+   check_same_as_sequential(
+      "let a <- 1;\n"
+      "/* let b <- 2;\n"
+      "   let c <- \"3\";\n"
+      "   let d <- 4; */ let e <- 5;\n"
+      "/*\n"
+      "*/\n"
+      "let f <- 6; /**/ /*/ still a comment\n"
+      "*/ let g <- 7;\n");
+
+   // Lines that look like the start of a comment or string from the inside of one.
+   check_same_as_sequential(
+      "\"/* not a comment\"\n"
+      "x /* \"not a string\n"
+      "\" */ y\n"
+      "\"unterminated\n"
+      "*/ z /*\n"
+      "\"\n"
+      "*/ 98765432100123456789 @\n");
+
+   // An unterminated comment swallows every later chunk.
+   check_same_as_sequential(
+      "a b c\n"
+      "/* d\n"
+      "e\n"
+      "f\n");
+
+   // Every line ending the lexer knows of.
+   check_same_as_sequential("a\r\nb\n\rc\fd\re\n\n\r\nf /*\r\n\n\r*/ g\f\fh");
+
+   // A '\f' in a literal doesn't end a line, so chunks that begin after one, or inside one, are
+   // given the wrong coordinate by the line table.
+   check_same_as_sequential("a \"b\fc\" @\nd '\f' e \"f\f\fg\\q\" #\nh\fi \"j\f\nk $\n");
+
+   // The chunks after several such literals report their errors on the lines that are left once
+   // the literals' lines have been joined.
+   check_same_as_sequential(
+      "\"\f\" '\f' \"\f\f\"\n"
+      "a @ 1.2.3\n"
+      "\"b\f\fc\" #\n"
+      "d 1e $\n"
+      "\"e\\q\" /* f\n"
+      "g\n");
+
+   { // Random programs
+      constexpr auto alphabet = std::string_view{" \t\n\r\f*/\"'\\ab1.e+-<>"};
+      auto seed = std::uint32_t{2'147'483'647};
+      for (auto trial = 0; trial != 300; ++trial) {
+         auto const source = random_source(seed, alphabet, static_cast<std::size_t>(trial % 150));
+         check_same_as_sequential(source, 1 + static_cast<std::size_t>(trial % 5));
+      }
+   }
+
+   return ::test_result();
+}
@@ -18,15 +18,19 @@
 
 #include "../../simple_test.hpp"
 #include <cassert>
+#include <cstddef>
 #include <ios>
 #include <iostream>
 #include <iterator>
 #include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/lexer_view.hpp"
 #include "ltcpp/lexer/token.hpp"
+#include "ltcpp/lexer/token_buffer.hpp"
 #include "ltcpp/reporter.hpp"
 #include "ltcpp/source_coordinate.hpp"
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -62,4 +66,41 @@ inline std::vector<ltcpp::token> generate_tokens(std::string const& source, ltcp
    return tokens;
 }
 
+inline std::vector<ltcpp::token> generate_buffer_tokens(std::string_view source, ltcpp::reporter& report)
+{
+   auto tokens = std::vector<ltcpp::token>{};
+   auto cursor = ltcpp::source_coordinate{};
+   for (;;) {
+      tokens.push_back(ltcpp::generate_token(source, report, cursor));
+      if (tokens.back().kind() == ltcpp::token_kind::eof) {
+         return tokens;
+      }
+      cursor = tokens.back().position().end();
+   }
+}
+
+/// \brief Checks that tokens holds exactly the tokens that expected does, and the same values for
+///        its literals.
+///
+inline void check_same_tokens(ltcpp::token_buffer const& tokens, ltcpp::token_buffer const& expected)
+{
+   CHECK(tokens.size() == expected.size());
+   for (auto i = std::size_t{0}; i < tokens.size() and i < expected.size(); ++i) {
+      CHECK(tokens[i] == expected[i]);
+      CHECK(tokens.integral_value(i) == expected.integral_value(i));
+      CHECK(tokens.floating_value(i) == expected.floating_value(i));
+   }
+}
+
+/// \brief Checks the same, and that lexing tokens reported exactly what lexing expected did.
+///
+inline void check_same_tokens(ltcpp::token_buffer const& tokens, ltcpp::reporter const& report,
+   std::ostringstream const& errors, ltcpp::token_buffer const& expected,
+   ltcpp::reporter const& expected_report, std::ostringstream const& expected_errors)
+{
+   check_same_tokens(tokens, expected);
+   CHECK(report.errors() == expected_report.errors());
+   CHECK(errors.str() == expected_errors.str());
+}
+
 #endif // TEST_LEXER_LEXER_TEST_COMMON_HPP
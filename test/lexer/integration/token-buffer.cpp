@@ -0,0 +1,105 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_location.hpp"
+
+#include <string>
+#include <sstream>
+#include "./test_common.hpp"
+
+namespace {
+   void check_same_as_generate_token(std::string const& source)
+   {
+      auto expected_errors = std::ostringstream{};
+      auto expected_report = ltcpp::reporter{expected_errors};
+      auto expected_tokens = generate_buffer_tokens(source, expected_report);
+      for (auto& t : expected_tokens) {
+         t.decode_value();
+      }
+
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto tokens = ltcpp::token_buffer{source, report};
+      tokens.decode_values();
+
+      CHECK(tokens.size() == expected_tokens.size());
+      CHECK(tokens.kinds().size() == tokens.size());
+      for (auto i = std::size_t{0}; i < tokens.size() and i < expected_tokens.size(); ++i) {
+         CHECK(tokens[i] == expected_tokens[i]);
+         CHECK(tokens.kinds()[i] == expected_tokens[i].kind());
+         CHECK(tokens[i].integral_value() == expected_tokens[i].integral_value());
+         CHECK(tokens.integral_value(i) == expected_tokens[i].integral_value());
+         CHECK(tokens.floating_value(i) == expected_tokens[i].floating_value());
+      }
+      CHECK(report.errors() == expected_report.errors());
+      CHECK(errors.str() == expected_errors.str());
+   }
+} // namespace
+
+int main()
+{
+   // Check that a token_buffer reassembles exactly the tokens that generate_token produces.
+   check_same_as_generate_token("");
+   check_same_as_generate_token("\n\n   \f");
+   check_same_as_generate_token(
+      "// conforming program starting on line 2\n"
+      "fun main() -> int32\n"
+      "{\n"
+      "   print(\"Hello, world!\\n\");\n"
+      "}\n");
+   check_same_as_generate_token("x <- 10.10.10 .956 a.b 543e 87. /");
+
+   // A '\f' in a literal is part of it, and doesn't end the line that the literal is on.
+   check_same_as_generate_token("\"a\fb\" @\n'\f' \"c\f\fd\\q\" #\f$ '\fx \"e\f");
+   check_same_as_generate_token(
+      "\tfun\rmain($) -> void\n"
+      "}\n"
+      "\treturn\"This string is terminated.\"\n"
+      "\f"
+      "return\"This string is not terminated.\n"
+      "   return \"This string is also not terminated\\\"\n"
+      "\"\\q\" /* */ a/b<-c<=d!=e>=f->g\n\r"
+      "x /* a comment\n"
+      "   that spans lines */ y /**/ z\r\n"
+      "last");
+   check_same_as_generate_token(
+      "fun main/*() -> int32\n"
+      "{\n"
+      "   abacus;\n"
+      "}\n");
+
+   { // Check the accessors for a single token
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto const file = ltcpp::file_id{7};
+      auto tokens = ltcpp::token_buffer{"let x <- 1;", report, file};
+      CHECK(tokens.size() == 6U);
+      CHECK(tokens.kind(5) == ltcpp::token_kind::eof);
+      CHECK(tokens.spelling(2) == "<-");
+      CHECK(tokens.location(2) == ltcpp::source_location{file, 6});
+      CHECK(sizeof(tokens.kinds()[0]) == 1U);
+      CHECK(not tokens.integral_value(3));
+      tokens.decode_values();
+      CHECK(tokens.integral_value(3) == 1U);
+      CHECK(tokens[3].integral_value() == 1U);
+      CHECK(not tokens.integral_value(4));
+   }
+   check_same_as_generate_token("let big <- 98765432100123456789 + 12345678901 * 6.02e23 - 1e999;");
+
+   return ::test_result();
+}
@@ -0,0 +1,137 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/lexer/token_cache.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_location.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "../../simple_test.hpp"
+
+namespace {
+   void check_same_tokens(ltcpp::cached_token_buffer const& cached, ltcpp::token_buffer const& tokens)
+   {
+      CHECK(cached.size() == tokens.size());
+      CHECK(std::ranges::equal(cached.kinds(), tokens.kinds()));
+      CHECK(std::ranges::equal(cached.line_starts(), tokens.lines().line_starts()));
+      CHECK(cached.source().data() == tokens.source().data());
+      for (auto i = std::size_t{0}; i < tokens.size() and i < cached.size(); ++i) {
+         CHECK(cached[i] == tokens[i]);
+         CHECK(cached.spelling(i).data() == tokens.spelling(i).data());
+         CHECK(cached.location(i) == tokens.location(i));
+         CHECK(cached.integral_value(i) == tokens.integral_value(i));
+         CHECK(cached.floating_value(i) == tokens.floating_value(i));
+      }
+   }
+} // namespace
+
+int main()
+{
+   // Check that tokens stored in a token_cache are found again, unchanged, only for the same source.
+   auto const directory = std::filesystem::temp_directory_path()
+                        / ("ltcpp-token-cache-" + std::to_string(::getpid()));
+   std::filesystem::remove_all(directory);
+   auto const cache = ltcpp::token_cache{directory / "nested"};
+   CHECK(std::filesystem::is_directory(cache.directory()));
+
+   auto errors = std::ostringstream{};
+   auto report = ltcpp::reporter{errors};
+   auto const file = ltcpp::file_id{7};
+
+   { // A stored source is found, and its entry is used in place
+      auto const source = std::string{
+         "// conforming program starting on line 2\n"
+         "fun main() -> int32\r\n"
+         "{\n\r"
+         "   let x <- 0x2a + 10.5e3 * 18446744073709551616;\f"
+         "   print(\"Hello, world!\\n\");\n"
+         "}\n"};
+      auto tokens = ltcpp::token_buffer{source, report, file};
+      tokens.decode_values();
+      CHECK(not cache.find(source, file));
+
+      cache.store(tokens);
+      auto cached = cache.find(source, file);
+      assert(cached);
+      check_same_tokens(*cached, tokens);
+
+      // Moving the result doesn't unmap the entry.
+      auto const moved = std::move(*cached);
+      check_same_tokens(moved, tokens);
+
+      // Storing again replaces the entry.
+      cache.store(tokens);
+      check_same_tokens(*cache.find(source, file), tokens);
+   }
+
+   { // Any change to the source misses
+      auto const source = std::string{"let x <- 1;\n"};
+      cache.store(ltcpp::token_buffer{source, report});
+      CHECK(not cache.find("let x <- 2;\n"));
+      CHECK(not cache.find("let x <- 1;\n "));
+      CHECK(not cache.find("let x <- 1;"));
+      CHECK(cache.find(source).has_value());
+   }
+
+   { // An empty source has just the eof token
+      auto const source = std::string{};
+      auto const tokens = ltcpp::token_buffer{source, report};
+      cache.store(tokens);
+      auto const cached = cache.find(source);
+      assert(cached);
+      check_same_tokens(*cached, tokens);
+   }
+
+   { // Entries that aren't from this lexer, or are damaged, are ignored
+      auto const source = std::string(10'000, 'x') + " <- 3.25;";
+      auto const tokens = ltcpp::token_buffer{source, report};
+      cache.store(tokens);
+      auto const entry = cache.entry(source);
+      CHECK(entry.parent_path() == cache.directory());
+      auto const size = std::filesystem::file_size(entry);
+
+      std::filesystem::resize_file(entry, size - 1);
+      CHECK(not cache.find(source));
+
+      cache.store(tokens);
+      { // The lexer version follows the magic number and the format version
+         auto out = std::fstream{entry, std::ios_base::binary | std::ios_base::in | std::ios_base::out};
+         out.seekp(12);
+         out.put('\x7f');
+      }
+      CHECK(not cache.find(source));
+
+      std::ofstream{entry, std::ios_base::binary} << "ltcpp";
+      CHECK(not cache.find(source));
+
+      cache.store(tokens);
+      check_same_tokens(*cache.find(source), tokens);
+   }
+
+   CHECK(report.errors() == 0);
+   CHECK(std::distance(std::filesystem::directory_iterator{cache.directory()},
+      std::filesystem::directory_iterator{}) == 4);
+   std::filesystem::remove_all(directory);
+
+   return ::test_result();
+}
@@ -0,0 +1,130 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_generator.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <istream>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "./test_common.hpp"
+
+namespace {
+   /// A stream buffer that produces a few characters and then fails.
+   ///
+   class failing_buffer : public std::streambuf {
+   protected:
+      int_type underflow() override
+      {
+         if (remaining_ == 0) {
+            throw std::runtime_error{"the disk is on fire"};
+         }
+         --remaining_;
+         setg(&c_, &c_, &c_ + 1);
+         return traits_type::to_int_type(c_);
+      }
+   private:
+      char c_ = 'x';
+      int remaining_ = 3;
+   };
+
+   template<class Generator>
+   std::vector<ltcpp::token> collect(Generator&& tokens)
+   {
+      auto result = std::vector<ltcpp::token>{};
+      for (auto const& t : tokens) {
+         result.push_back(t);
+      }
+      return result;
+   }
+} // namespace
+
+int main()
+{
+   // Check that the coroutine lexer yields the same tokens as generate_token, and no more than
+   // it's asked for.
+   using ltcpp::token_kind;
+   using ltcpp::yield_tokens;
+   using namespace std::string_view_literals;
+
+   static_assert(std::ranges::input_range<ltcpp::token_generator>);
+   static_assert(std::ranges::view<ltcpp::token_generator>);
+   static_assert(std::same_as<std::ranges::range_reference_t<ltcpp::token_generator>,
+      ltcpp::token const&>);
+
+   constexpr auto source = "fun main() -> int32 {\n"
+                           "   let x <- 10.5e3 + y; /* ignored */\n"
+                           "   return \"done\" @ x;\n"
+                           "}\n"sv;
+   auto errors = std::ostringstream{};
+   auto report = ltcpp::reporter{errors};
+   auto const expected = generate_buffer_tokens(source, report);
+
+   { // Every kind of source yields the same tokens, up to and including eof
+      auto const from_buffer = collect(yield_tokens(source, report));
+      CHECK_EQUAL(from_buffer, expected);
+
+      auto in = std::istringstream{std::string{source}};
+      in.unsetf(std::ios_base::skipws);
+      auto const from_stream = collect(yield_tokens(in, report));
+      CHECK_EQUAL(from_stream, expected);
+
+      auto const from_nothing = collect(yield_tokens(std::string{}, report));
+      CHECK_EQUAL(from_nothing, (std::vector{ltcpp::token{token_kind::eof, "$", {}, {}}}));
+   }
+
+   { // Lexing stops when the consumer does
+      auto const before = report.errors();
+      for (auto const& t : yield_tokens(source, report)) {
+         if (t.kind() == token_kind::return_) {
+            break;
+         }
+      }
+      CHECK(report.errors() == before);
+   }
+
+   { // Generators compose with the standard range adaptors
+      auto kinds = std::vector<token_kind>{};
+      for (auto const kind : yield_tokens(source, report)
+                             | std::views::transform(&ltcpp::token::kind)
+                             | std::views::take(3)) {
+         kinds.push_back(kind);
+      }
+      CHECK(kinds == (std::vector{token_kind::fun_, token_kind::identifier, token_kind::paren_open}));
+   }
+
+   { // Exceptions reach the consumer
+      auto buffer = failing_buffer{};
+      auto in = std::istream{&buffer};
+      auto threw = false;
+      try {
+         for (auto const& t : yield_tokens(in, report)) {
+            (void)t;
+         }
+      }
+      catch (std::runtime_error const&) {
+         threw = true;
+      }
+      CHECK(threw);
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,150 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_pipeline.hpp"
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "./test_common.hpp"
+
+namespace {
+   /// Stands in for a parser: it complains about every identifier that's followed by an unknown
+   /// token, so its diagnostics have to interleave with the lexer's.
+   ///
+   class fussy_consumer {
+   public:
+      explicit fussy_consumer(ltcpp::reporter& report) noexcept
+         : report_{&report}
+      {}
+
+      void consume(ltcpp::token const& t)
+      {
+         if (t.kind() == ltcpp::token_kind::unknown_token and previous_ == ltcpp::token_kind::identifier) {
+            report_->error(ltcpp::pass::syntax, t.position().begin(), "expected an operator.");
+         }
+         previous_ = t.kind();
+      }
+   private:
+      ltcpp::reporter* report_;
+      ltcpp::token_kind previous_ = ltcpp::token_kind::eof;
+   };
+
+   /// Lexes and consumes source in turn on this thread.
+   ///
+   std::string consume_sequentially(std::string_view source, std::vector<ltcpp::token>& tokens)
+   {
+      auto diagnostics = std::ostringstream{};
+      auto report = ltcpp::reporter{diagnostics};
+      auto consumer = fussy_consumer{report};
+      auto cursor = ltcpp::source_coordinate{};
+      do {
+         tokens.push_back(ltcpp::generate_token(source, report, cursor));
+         cursor = tokens.back().position().end();
+         consumer.consume(tokens.back());
+      } while (tokens.back().kind() != ltcpp::token_kind::eof);
+      return diagnostics.str();
+   }
+
+   void check_same_as_sequential(std::string_view const source)
+   {
+      auto expected_tokens = std::vector<ltcpp::token>{};
+      auto const expected_diagnostics = consume_sequentially(source, expected_tokens);
+
+      for (auto const batch_size : {1, 2, 7, 512}) {
+         for (auto const batches_in_flight : {1, 2, 8}) {
+            auto diagnostics = std::ostringstream{};
+            auto report = ltcpp::reporter{diagnostics};
+            auto consumer = fussy_consumer{report};
+            auto pipeline = ltcpp::token_pipeline{source, report, {
+               .batch_size = static_cast<std::size_t>(batch_size),
+               .batches_in_flight = static_cast<std::size_t>(batches_in_flight),
+            }};
+
+            auto tokens = std::vector<ltcpp::token>{};
+            do {
+               tokens.push_back(pipeline.next());
+               consumer.consume(tokens.back());
+            } while (tokens.back().kind() != ltcpp::token_kind::eof);
+
+            CHECK_EQUAL(tokens, expected_tokens);
+            CHECK(diagnostics.str() == expected_diagnostics);
+            CHECK(pipeline.next().kind() == ltcpp::token_kind::eof);
+            CHECK(pipeline.next().kind() == ltcpp::token_kind::eof);
+         }
+      }
+   }
+} // namespace
+
+int main()
+{
+   // Check that a token_pipeline hands over the same tokens as lexing on one thread, with
+   // diagnostics from both threads in source order.
+   check_same_as_sequential("");
+   check_same_as_sequential(
+      "fun main() -> int32 {\n"
+      "   let x <- y @ z $ 10.10.10;\n"
+      "   return \"unterminated;\n"
+      "   a ` b \"\\q\" 1e+ c # d;\n"
+      "}\n"
+      "/* never closed");
+
+   {
+      auto source = std::string{};
+      for (auto i = 0; i != 2'000; ++i) {
+         source += "let x" + std::to_string(i) + " <- y @ 3.5e-1;\n";
+      }
+      check_same_as_sequential(source);
+
+      { // Stopping early doesn't wait for the lexer to finish, or leave it waiting for room
+         auto diagnostics = std::ostringstream{};
+         auto report = ltcpp::reporter{diagnostics};
+         auto pipeline = ltcpp::token_pipeline{source, report, {.batch_size = 1, .batches_in_flight = 1}};
+         CHECK(pipeline.next().kind() == ltcpp::token_kind::let_);
+         CHECK(pipeline.next().spelling() == "x0");
+      }
+   }
+
+   { // Destroying the pipeline while the lexer is part way through a batch, or has just finished
+     // one and is waiting for room, doesn't leave it waiting
+      auto source = std::string{};
+      while (source.size() < 3'000'000) {
+         source += "let x <- y @ 3.5e-1;\n";
+      }
+
+      for (auto const wait : {0, 1, 5, 50}) {
+         auto diagnostics = std::ostringstream{};
+         auto report = ltcpp::reporter{diagnostics};
+         auto pipeline = ltcpp::token_pipeline{source, report,
+            {.batch_size = 1'000'000, .batches_in_flight = 1}};
+         std::this_thread::sleep_for(std::chrono::milliseconds{wait});
+      }
+
+      auto diagnostics = std::ostringstream{};
+      auto report = ltcpp::reporter{diagnostics};
+      auto pipeline = ltcpp::token_pipeline{source, report,
+         {.batch_size = 1'000'000, .batches_in_flight = 1}};
+      CHECK(pipeline.next().kind() == ltcpp::token_kind::let_);
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,125 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/lexer/token_stream.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "../../simple_test.hpp"
+
+namespace {
+   /// Writes source's tokens as a token stream, and checks that they read back unchanged.
+   ///
+   std::string check_round_trip(std::string const& source)
+   {
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto tokens = ltcpp::token_buffer{source, report};
+      auto const stream = ltcpp::write_token_stream(tokens);
+      auto read = ltcpp::read_token_stream(stream);
+
+      // Values aren't written, and are decoded afresh on request.
+      tokens.decode_values();
+      assert(read.size() == tokens.size());
+      for (auto i = std::size_t{0}; i != tokens.size(); ++i) {
+         CHECK(read[i] == tokens[i]);
+         CHECK(not read[i].integral_value());
+         CHECK(not read[i].floating_value());
+         read[i].decode_value();
+         CHECK(read[i].integral_value() == tokens.integral_value(i));
+         CHECK(read[i].floating_value() == tokens.floating_value(i));
+      }
+      return stream;
+   }
+
+   bool rejects(std::string_view const stream)
+   {
+      try {
+         (void)ltcpp::read_token_stream(stream);
+         return false;
+      }
+      catch (std::runtime_error const&) {
+         return true;
+      }
+   }
+} // namespace
+
+int main()
+{
+   // Check that token streams round-trip, are compact, and that damaged ones are rejected.
+   check_round_trip("");
+   check_round_trip(
+      "// conforming program starting on line 2\n"
+      "fun main() -> int32\r\n"
+      "{\n\r"
+      "   let x <- 0x2a + 10.5e3 * 18446744073709551616 - true - false - true;\f"
+      "   print(\"Hello, world!\\n\", 'c', x, x, y, x);\n"
+      "}\n");
+   check_round_trip(
+      "\tfun\rmain($) -> void\r\n"
+      "}\n\r"
+      "return\"This string is not terminated.\n"
+      "\"\\q\" 10.10.10 .956 543e /* a\r\n*/ a/b<-c<=d!=e>=f->g\n"
+      "x /* this comment never ends");
+
+   { // An order of magnitude smaller than a text dump
+      auto source = std::string{"module compact;\n"};
+      for (auto i = 0; i != 500; ++i) {
+         source += "fun f" + std::to_string(i) + "(x: int32, y: ref string) -> int32 {\n"
+                   "   // add them up\n"
+                   "   let count: int32 <- x + y.size * 2;\n"
+                   "   while (count > 0) { count <- count - 1; }\n"
+                   "   return count;\n"
+                   "}\n";
+      }
+      auto const stream = check_round_trip(source);
+
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+      auto const tokens = ltcpp::token_buffer{source, report};
+      auto dump = std::ostringstream{};
+      for (auto i = std::size_t{0}; i != tokens.size(); ++i) {
+         dump << tokens[i] << '\n';
+      }
+      auto const ratio = dump.str().size() / stream.size();
+      CHECK(ratio >= 10U);
+   }
+
+   { // Anything that isn't a whole, well-formed stream of this version is rejected
+      auto const stream = check_round_trip("let x <- y + 1;\nlet z <- \"z\";\n");
+      for (auto n = std::size_t{0}; n != stream.size(); ++n) {
+         CHECK(rejects(std::string_view{stream}.substr(0, n)));
+      }
+      CHECK(rejects(stream + '\0'));
+
+      auto wrong_magic = stream;
+      wrong_magic[0] = 'L';
+      CHECK(rejects(wrong_magic));
+
+      auto wrong_version = stream;
+      wrong_version[8] = '\2';
+      CHECK(rejects(wrong_version));
+
+      CHECK(not rejects(stream));
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,133 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_visitor.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/source_coordinate_range.hpp"
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "./allocation_counter.hpp"
+#include "./test_common.hpp"
+
+namespace {
+   using visited_token = std::tuple<ltcpp::token_kind, std::string_view, ltcpp::source_coordinate_range>;
+
+   std::vector<visited_token> visit_all(std::string_view const source)
+   {
+      auto result = std::vector<visited_token>{};
+      ltcpp::lex(source, [&result](ltcpp::token_kind const kind, std::string_view const spelling,
+                                   ltcpp::source_coordinate_range const position) {
+         result.emplace_back(kind, spelling, position);
+      });
+      return result;
+   }
+} // namespace
+
+int main()
+{
+   // Check that visiting tokens agrees with generating them, without allocating.
+   using ltcpp::source_coordinate;
+   using ltcpp::source_coordinate_range;
+   using ltcpp::token_kind;
+   using column_type = source_coordinate::column_type;
+   using line_type = source_coordinate::line_type;
+   using namespace std::string_view_literals;
+
+   constexpr auto source = "import io;\n"
+                           "fun main() -> int32 {\n"
+                           "   let x <- 10.5e3 + y; /* ignored\r\n */\n"
+                           "   return \"do\\ne\" @ x 1.2.3;\n"
+                           "}\n"sv;
+   auto errors = std::ostringstream{};
+   auto report = ltcpp::reporter{errors};
+
+   { // Tokens are visited as generate_token produces them, spelled in place
+      auto const expected = generate_buffer_tokens(source, report);
+      auto const visited = visit_all(source);
+      CHECK(visited.size() == expected.size());
+      for (auto i = std::size_t{0}; i + 1 < expected.size(); ++i) {
+         auto const& [kind, spelling, position] = visited[i];
+         CHECK(kind == expected[i].kind());
+         CHECK(spelling == expected[i].spelling());
+         CHECK(position == expected[i].position());
+         CHECK(source.substr(static_cast<std::size_t>(spelling.data() - source.data()), spelling.size()) == spelling);
+      }
+
+      auto const& [kind, spelling, position] = visited.back();
+      CHECK(kind == token_kind::eof);
+      CHECK(spelling.data() == source.data() + source.size());
+      CHECK(spelling.empty());
+      CHECK(position == expected.back().position());
+   }
+
+   { // Lexing stops as soon as the visitor returns false
+      auto visited = std::size_t{0};
+      auto module_name = std::string_view{};
+      auto saw_import = false;
+      ltcpp::lex(source, [&](token_kind const kind, std::string_view const spelling, source_coordinate_range) {
+         ++visited;
+         if (saw_import) {
+            module_name = spelling;
+            return false;
+         }
+         saw_import = kind == token_kind::import_;
+         return true;
+      });
+      CHECK(visited == 2U);
+      CHECK(module_name == "io"sv);
+   }
+
+   { // A comment that's never closed is visited, then eof
+      auto const unterminated = "let x; // a /* b\n"
+                                "\t/* c */ \r /* d\n"
+                                "\n\r e"sv;
+      auto const visited = visit_all(unterminated);
+      CHECK(visited.size() == 5U);
+
+      auto const& [kind, spelling, position] = visited[3];
+      CHECK(kind == token_kind::unterminated_comment);
+      CHECK(spelling == "/* d\n\n\r e"sv);
+      CHECK(position.begin() == (source_coordinate{line_type{2}, column_type{12}}));
+      CHECK(position.end() == (source_coordinate{line_type{4}, column_type{3}}));
+      CHECK(std::get<0>(visited[4]) == token_kind::eof);
+   }
+
+   { // Visiting a buffer allocates nothing
+      auto long_source = std::string{};
+      for (auto i = 0; i != 1'000; ++i) {
+         long_source += "let a_rather_long_identifier <- \"and a rather long string literal\" + 1.5;\n";
+      }
+
+      auto const before = allocations;
+      auto identifiers = 0;
+      auto tokens = 0;
+      ltcpp::lex(long_source, [&](token_kind const kind, std::string_view, source_coordinate_range) noexcept {
+         identifiers += kind == token_kind::identifier;
+         ++tokens;
+      });
+      CHECK(allocations == before);
+      CHECK(identifiers == 1'000);
+      CHECK(tokens == 7'001);
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,121 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/token_buffer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "../../random_source.hpp"
+#include "../../simple_test.hpp"
+#include "./test_common.hpp"
+
+namespace {
+   /// Checks that lexing source in two stages changes nothing about the tokens or diagnostics,
+   /// wherever the source falls relative to the 64-byte blocks that the first stage works in.
+   ///
+   void check_same_as_sequential(std::string_view const source)
+   {
+      for (auto const padding : {0, 1, 31, 62, 63}) {
+         auto const padded = std::string(static_cast<std::size_t>(padding), ' ') + std::string{source};
+
+         auto expected_errors = std::ostringstream{};
+         auto expected_report = ltcpp::reporter{expected_errors};
+         auto expected = ltcpp::token_buffer{padded, expected_report};
+         expected.decode_values();
+
+         auto errors = std::ostringstream{};
+         auto report = ltcpp::reporter{errors};
+         auto tokens = ltcpp::token_buffer{padded, report, ltcpp::two_stage_lexing};
+         tokens.decode_values();
+
+         check_same_tokens(tokens, report, errors, expected, expected_report, expected_errors);
+      }
+   }
+} // namespace
+
+int main()
+{
+   // Check that finding where tokens begin ahead of scanning them produces what the sequential
+   // lexer does.
+   check_same_as_sequential("");
+   check_same_as_sequential(
+      "fun main() -> int32\n"
+      "{\n"
+      "   let x <- 12345678901234 + 0.5e3;\n"
+      "   print(\"Hello, world!\\n\");\n"
+      "}\n");
+
+   // Comments, including ones that look like they're inside strings and vice versa.
+   check_same_as_sequential(
+      "let a <- 1; // a comment with \"a string\" in it\n"
+      "/* let b <- 2;\n"
+      "   let c <- \"3\";\n"
+      "   let d <- 4; */ let e <- 5;\n"
+      "let f <- 6; /**/ /*/ still a comment\n"
+      "*/ let g <- 7 / 8 /= 9;\n"
+      "\"/* not a comment\" \"// nor this\"\n"
+      "// a lone \r doesn't end this comment, but this does\r\n"
+      "h\n");
+
+   // Strings and character literals, well-formed or not.
+   check_same_as_sequential(
+      "\"\\\\\" \"\\\"\" \"\\\\\\\"\" \"\\q\" \"unterminated\n"
+      "\"also unterminated\\\n"
+      "'a' '\\\"' '\"' ''' '/'*x '/*' '//' 'ab' '\n"
+      "\\ \"\\\"\n");
+
+   // Strings, escapes, and comment openers that straddle a block boundary.
+   check_same_as_sequential(std::string(61, 'x') + " \"" + std::string(70, 'y') + "\" z");
+   check_same_as_sequential(std::string(62, 'x') + "\"\\\\" + std::string(70, '\\') + "\" z");
+   check_same_as_sequential(std::string(63, 'x') + "/" + "/ comment\n z");
+   check_same_as_sequential(std::string(63, 'x') + "/" + "* comment */ z");
+   check_same_as_sequential("\"" + std::string(62, 'x') + "\\\n\" z");
+
+   // Runs of backslashes decide whether what follows them is a comment.
+   for (auto run = std::size_t{1}; run != 6; ++run) {
+      auto const backslashes = std::string(run, '\\');
+      check_same_as_sequential(std::string(60, 'x') + " \"" + backslashes + "\" y // z \" w\n v");
+      check_same_as_sequential("a \"" + backslashes + "\" b /* c \" d */ e");
+   }
+
+   // An unterminated comment swallows everything after it.
+   check_same_as_sequential(
+      "a b c\n"
+      "/* d\n"
+      "e \"\n"
+      "f\n");
+
+   // Every line ending the lexer knows of.
+   check_same_as_sequential("a\r\nb\n\rc\fd\re\n\n\r\nf /*\r\n\n\r*/ g\f\fh \"i\fj\" 'k\f'");
+
+   // A '\f' in a literal doesn't end a line, so the diagnostics after one are a line earlier
+   // than the line table alone would say.
+   check_same_as_sequential("\"a\f\fb\" @\n'\f' # \"c\fd\\q\" $\n'\fx /* \"e\f");
+
+   { // Random programs
+      constexpr auto alphabet = std::string_view{" \t\n\r\f*/\"'\\ab1.e+-<>!"};
+      auto seed = std::uint32_t{2'147'483'647};
+      for (auto trial = 0; trial != 1'000; ++trial) {
+         check_same_as_sequential(random_source(seed, alphabet, static_cast<std::size_t>(trial % 400)));
+      }
+   }
+
+   return ::test_result();
+}
@@ -19,11 +19,20 @@
 #include "ltcpp/lexer/token.hpp"
 #include "ltcpp/source_coordinate.hpp"
 #include "../../simple_test.hpp"
+#include <cstddef>
 #include <iterator>
 #include <sstream>
 #include <string>
 #include <string_view>
 
+/// \brief Returns the characters that have not yet been extracted from in.
+///
+inline std::string unscanned(std::istringstream& in)
+{
+   in.clear();
+   return in.str().substr(static_cast<std::size_t>(in.tellg()));
+}
+
 #define CHECK_SCAN(f, spelling_, expected_kind, expected_spelling_) {                              \
    using ltcpp::source_coordinate;                                                                 \
    auto spelling = std::string(spelling_);                                                         \
@@ -36,13 +45,17 @@
    auto expected_spelling = std::string_view{expected_spelling_ == "" ? spelling : expected_spelling_}; \
    CHECK(result.spelling() == expected_spelling);                                                  \
                                                                                                    \
-   auto const begin = result.cursor_range().begin();                                               \
-   auto const end = result.cursor_range().end();                                                   \
+   auto const begin = result.position().begin();                                               \
+   auto const end = result.position().end();                                                   \
    CHECK(begin.line() == end.line());                                                              \
                                                                                                    \
    auto const column_distance =                                                                    \
       static_cast<std::intmax_t>(end.column()) - static_cast<std::intmax_t>(begin.column());       \
    CHECK(column_distance == static_cast<std::intmax_t>(size(expected_spelling)));                  \
+                                                                                                   \
+   auto buffer = std::string_view{spelling};                                                       \
+   CHECK(f(buffer, source_coordinate{}) == result);                                                \
+   CHECK(buffer == unscanned(in));                                                                 \
 }                                                                                                  \
 
 
@@ -0,0 +1,168 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ltcpp/lexer/detail/gap_buffer.hpp"
+
+#include "../../simple_test.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+namespace {
+   using ltcpp::detail_lexer::gap_buffer;
+
+   /// Makes a buffer of 0, 1, ..., n - 1, along with a plain vector to check it against.
+   ///
+   template<class T>
+   std::pair<gap_buffer<T>, std::vector<T>> make_buffer(std::size_t const n)
+   {
+      auto model = std::vector<T>(n);
+      std::iota(model.begin(), model.end(), T{0});
+      return {gap_buffer<T>{std::pmr::vector<T>(model.begin(), model.end())}, model};
+   }
+
+   /// Replaces the `removed` elements of both buffer and model from first on with inserted, and
+   /// checks that they still agree.
+   ///
+   template<class T>
+   void check_replace(gap_buffer<T>& buffer, std::vector<T>& model, std::size_t const first,
+      std::size_t const removed, std::vector<T> const& inserted)
+   {
+      buffer.replace(first, removed, inserted);
+      auto const at = model.begin() + static_cast<std::ptrdiff_t>(first);
+      model.insert(model.erase(at, at + static_cast<std::ptrdiff_t>(removed)), inserted.begin(), inserted.end());
+
+      CHECK(buffer.size() == model.size());
+      CHECK(std::ranges::equal(buffer, model));
+   }
+
+   /// Adds delta to both buffer's tail and every element of model from first on, and checks that
+   /// they still agree.
+   ///
+   void check_shift_tail(gap_buffer<std::uint32_t>& buffer, std::vector<std::uint32_t>& model,
+      std::size_t const first, std::uint32_t const delta)
+   {
+      buffer.shift_tail(delta);
+      for (auto i = first; i != model.size(); ++i) {
+         model[i] += delta;
+      }
+      CHECK(std::ranges::equal(buffer, model));
+   }
+} // namespace
+
+int main()
+{
+   // Checks that a gap_buffer reads back as the same sequence as a vector given the same edits,
+   // wherever the gap is.
+   { // Replacing before, after, and across the gap
+      auto [buffer, model] = make_buffer<int>(20);
+      CHECK(std::ranges::equal(buffer, model));
+
+      check_replace(buffer, model, 10, 2, {-1, -2, -3});
+      check_replace(buffer, model, 3, 1, {-4});
+      check_replace(buffer, model, 15, 3, {});
+      check_replace(buffer, model, 2, 4, {-5, -6});
+      check_replace(buffer, model, 0, 0, {-7});
+      check_replace(buffer, model, model.size(), 0, {-8, -9});
+      check_replace(buffer, model, 0, model.size(), {-10});
+      CHECK(buffer.back() == -10);
+   }
+
+   { // The gap moving past elements that shift_tail has moved, in both directions
+      auto [buffer, model] = make_buffer<std::uint32_t>(30);
+      check_replace(buffer, model, 10, 2, {100, 101, 102});
+      check_shift_tail(buffer, model, 13, 1000);
+
+      check_replace(buffer, model, 4, 1, {200});
+      check_shift_tail(buffer, model, 5, 7);
+
+      check_replace(buffer, model, 25, 1, {300, 301});
+      check_shift_tail(buffer, model, 27, 50);
+
+      check_replace(buffer, model, 0, 0, {});
+      check_replace(buffer, model, model.size(), 0, {});
+      check_shift_tail(buffer, model, model.size(), 9);
+
+      // Text that shrinks shifts the tail by a delta that wraps around.
+      check_replace(buffer, model, 12, 0, {});
+      check_shift_tail(buffer, model, 12, static_cast<std::uint32_t>(-1000));
+   }
+
+   { // Growing the gap past its capacity
+      auto [buffer, model] = make_buffer<std::uint32_t>(50);
+      auto inserted = std::vector<std::uint32_t>(1000);
+      std::iota(inserted.begin(), inserted.end(), std::uint32_t{5000});
+      check_replace(buffer, model, 20, 5, inserted);
+      check_shift_tail(buffer, model, 1020, 3);
+
+      for (auto i = std::size_t{0}; i != 100; ++i) {
+         check_replace(buffer, model, 30 + i * 7, 1, {static_cast<std::uint32_t>(i), 1, 2});
+      }
+   }
+
+   { // Appending after a replacement in the middle
+      auto [buffer, model] = make_buffer<std::uint32_t>(10);
+      check_replace(buffer, model, 4, 1, {40, 41});
+      check_shift_tail(buffer, model, 6, 100);
+
+      buffer.push_back(500);
+      model.push_back(500);
+      CHECK(std::ranges::equal(buffer, model));
+      CHECK(buffer.back() == 500U);
+
+      check_replace(buffer, model, 8, 2, {80});
+      check_shift_tail(buffer, model, 9, 3);
+      buffer.push_back(600);
+      model.push_back(600);
+      CHECK(std::ranges::equal(buffer, model));
+   }
+
+   { // Compacting closes the gap and folds in shift_tail
+      auto [buffer, model] = make_buffer<std::uint32_t>(20);
+      CHECK(buffer.is_contiguous());
+      CHECK(std::ranges::equal(buffer.contiguous(), model));
+
+      check_replace(buffer, model, 5, 2, {50});
+      check_shift_tail(buffer, model, 6, 10);
+      CHECK(not buffer.is_contiguous());
+
+      buffer.compact();
+      CHECK(buffer.is_contiguous());
+      CHECK(std::ranges::equal(buffer.contiguous(), model));
+
+      check_replace(buffer, model, 10, 1, {60, 61});
+      buffer.push_back(70);
+      model.push_back(70);
+      buffer.compact();
+      CHECK(std::ranges::equal(buffer.contiguous(), model));
+   }
+
+   { // An empty buffer
+      auto buffer = gap_buffer<std::uint32_t>{};
+      CHECK(buffer.empty());
+      CHECK(buffer.begin() == buffer.end());
+
+      auto model = std::vector<std::uint32_t>{};
+      check_replace(buffer, model, 0, 0, {1, 2, 3});
+      buffer.push_back(4);
+      model.push_back(4);
+      CHECK(std::ranges::equal(buffer, model));
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,123 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/interner.hpp"
+
+#include "../../simple_test.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+int main()
+{
+   // Checks that ltcpp::interner and ltcpp::concurrent_interner hand out dense, stable symbols.
+   using ltcpp::symbol;
+   using namespace std::string_view_literals;
+
+   { // Symbols are dense and are handed out in order of first appearance
+      auto table = ltcpp::interner{};
+      CHECK(table.size() == 0U);
+      CHECK(not table.find("hello"sv));
+
+      CHECK(table.intern("hello"sv) == symbol{0});
+      CHECK(table.intern("world"sv) == symbol{1});
+      CHECK(table.intern("hello"sv) == symbol{0});
+      CHECK(table.intern(""sv) == symbol{2});
+      CHECK(table.size() == 3U);
+
+      CHECK(table.find("world"sv) == symbol{1});
+      CHECK(table.find(""sv) == symbol{2});
+      CHECK(not table.find("hell"sv));
+      CHECK(table.spelling(symbol{0}) == "hello"sv);
+      CHECK(table.spelling(symbol{2}).empty());
+   }
+
+   { // Spellings are copied, and stay put while the table grows
+      auto table = ltcpp::interner{};
+      auto source = std::string{"transient"};
+      auto const first = table.intern(source);
+      auto const first_view = table.spelling(first);
+      source = "overwritten";
+      CHECK(first_view == "transient"sv);
+
+      auto names = std::vector<std::string>{};
+      for (auto i = 0; i != 20'000; ++i) {
+         names.push_back("name_" + std::to_string(i));
+      }
+      names.push_back(std::string(40'000, 'x')); // too big to share a block
+
+      for (auto const& name : names) {
+         table.intern(name);
+      }
+      CHECK(table.size() == names.size() + 1);
+      CHECK(table.spelling(first).data() == first_view.data());
+      for (auto i = std::size_t{0}; i != names.size(); ++i) {
+         auto const s = table.find(names[i]);
+         CHECK(s == symbol{static_cast<std::uint32_t>(i + 1)});
+         CHECK(table.spelling(symbol{static_cast<std::uint32_t>(i + 1)}) == names[i]);
+      }
+   }
+
+   { // Threads that intern overlapping spellings agree on their symbols
+      auto table = ltcpp::concurrent_interner{};
+      constexpr auto thread_count = 4;
+      constexpr auto name_count = 5'000;
+      auto results = std::vector<std::vector<symbol>>(thread_count);
+      {
+         auto threads = std::vector<std::jthread>{};
+         for (auto t = 0; t != thread_count; ++t) {
+            threads.emplace_back([&table, &result = results[static_cast<std::size_t>(t)], t] {
+               // Each thread walks the names in a different order.
+               for (auto i = 0; i != name_count; ++i) {
+                  auto const n = (i * (2 * t + 1)) % name_count;
+                  result.push_back(table.intern("name_" + std::to_string(n)));
+               }
+            });
+         }
+      }
+
+      CHECK(table.size() == static_cast<std::size_t>(name_count));
+      auto seen = std::vector<bool>(name_count);
+      for (auto i = 0; i != name_count; ++i) {
+         auto const name = "name_" + std::to_string(i);
+         auto const s = table.find(name);
+         CHECK(s.has_value());
+         if (not s) {
+            continue;
+         }
+         CHECK(table.spelling(*s) == name);
+
+         auto const id = static_cast<std::size_t>(*s);
+         CHECK(id < seen.size());
+         if (id < seen.size()) {
+            CHECK(not seen[id]);
+            seen[id] = true;
+         }
+      }
+
+      for (auto t = 0; t != thread_count; ++t) {
+         auto const& result = results[static_cast<std::size_t>(t)];
+         for (auto i = 0; i != name_count; ++i) {
+            auto const n = (i * (2 * t + 1)) % name_count;
+            CHECK(table.spelling(result[static_cast<std::size_t>(i)]) == "name_" + std::to_string(n));
+         }
+      }
+   }
+
+   return ::test_result();
+}
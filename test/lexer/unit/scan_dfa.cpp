@@ -0,0 +1,138 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/lexer/detail/scan_dfa.hpp"
+
+#include "ltcpp/lexer/detail/character_source.hpp"
+#include "ltcpp/lexer/detail/scan_identifier.hpp"
+#include "ltcpp/lexer/detail/scan_number.hpp"
+#include "ltcpp/lexer/detail/scan_string_literal.hpp"
+#include "ltcpp/lexer/detail/scan_symbol.hpp"
+#include "ltcpp/lexer/detail/scan_whitespace.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "../../simple_test.hpp"
+#include <cassert>
+#include <string>
+#include <string_view>
+
+#define CHECK_SCAN_DFA(input, expected_kind, expected_spelling) {                                  \
+   auto buffer = std::string_view{input};                                                          \
+   auto const result = scan_dfa(buffer, source_coordinate{});                                      \
+   CHECK(result.kind() == expected_kind);                                                          \
+   CHECK(result.spelling() == expected_spelling);                                                  \
+   CHECK(buffer == std::string_view{input}.substr(std::string_view{expected_spelling}.size()));    \
+}                                                                                                  \
+
+namespace {
+   /// Scans one token with the hand-written scanners, dispatching the way the lexer does.
+   ///
+   ltcpp::token scan_hand_written(std::string_view& in, ltcpp::source_coordinate const cursor)
+   {
+      namespace detail = ltcpp::detail_lexer;
+      auto const c = detail::char_traits::to_int_type(in.front());
+      return detail::is_digit(c)           ? detail::scan_number(in, cursor)
+           : detail::is_identifier_head(c) ? detail::scan_identifier(in, cursor)
+           : c == '"'                      ? detail::scan_string_literal(in, cursor)
+           : c == '\''                     ? detail::scan_character_literal(in, cursor)
+                                           : detail::scan_symbol(in, cursor);
+   }
+} // namespace
+
+int main()
+{
+   // Checks that ltcpp::detail_lexer::scan_dfa recognises the terminals of lingua.g4.
+   using ltcpp::source_coordinate;
+   using ltcpp::token_kind;
+   using ltcpp::detail_lexer::scan_dfa;
+   using namespace std::string_view_literals;
+
+   { // Check keywords and the identifiers that they prefix
+      CHECK_SCAN_DFA("module", token_kind::module_, "module"sv);
+      CHECK_SCAN_DFA("export", token_kind::export_, "export"sv);
+      CHECK_SCAN_DFA("int64", token_kind::int64, "int64"sv);
+      CHECK_SCAN_DFA("true", token_kind::boolean_literal, "true"sv);
+      CHECK_SCAN_DFA("in", token_kind::in_, "in"sv);
+      CHECK_SCAN_DFA("int", token_kind::identifier, "int"sv);
+      CHECK_SCAN_DFA("int65", token_kind::identifier, "int65"sv);
+      CHECK_SCAN_DFA("modules", token_kind::identifier, "modules"sv);
+      CHECK_SCAN_DFA("export_value;", token_kind::identifier, "export_value"sv);
+   }
+   { // Check that the longest symbol wins
+      CHECK_SCAN_DFA("+", token_kind::plus, "+"sv);
+      CHECK_SCAN_DFA("+++", token_kind::increment, "++"sv);
+      CHECK_SCAN_DFA("-->", token_kind::decrement, "--"sv);
+      CHECK_SCAN_DFA("->", token_kind::arrow, "->"sv);
+      CHECK_SCAN_DFA("<-", token_kind::assign, "<-"sv);
+      CHECK_SCAN_DFA("<=", token_kind::less_equal, "<="sv);
+      CHECK_SCAN_DFA("!=", token_kind::not_equal_to, "!="sv);
+      CHECK_SCAN_DFA("%", token_kind::modulo, "%"sv);
+   }
+   { // Check literals
+      CHECK_SCAN_DFA("1234;", token_kind::integral_literal, "1234"sv);
+      CHECK_SCAN_DFA("12.5e-3", token_kind::floating_literal, "12.5e-3"sv);
+      CHECK_SCAN_DFA("12.5e", token_kind::floating_literal, "12.5"sv);
+      CHECK_SCAN_DFA("12.", token_kind::integral_literal, "12"sv);
+      CHECK_SCAN_DFA("'a'", token_kind::character_literal, "'a'"sv);
+      CHECK_SCAN_DFA(R"('\"')", token_kind::character_literal, R"('\"')"sv);
+      CHECK_SCAN_DFA(R"("hello")", token_kind::string_literal, R"("hello")"sv);
+      CHECK_SCAN_DFA(R"("a" "b")", token_kind::string_literal, R"("a")"sv);
+      CHECK_SCAN_DFA(R"("a\"b" c")", token_kind::string_literal, R"("a\"b")"sv);
+   }
+   { // Check input that no terminal matches
+      CHECK_SCAN_DFA("!", token_kind::unknown_token, "!"sv);
+      CHECK_SCAN_DFA("#x", token_kind::unknown_token, "#"sv);
+      CHECK_SCAN_DFA("\"hello", token_kind::unknown_token, "\""sv);
+      CHECK_SCAN_DFA("'ab'", token_kind::unknown_token, "'"sv);
+   }
+   { // The DFA agrees with the hand-written scanners wherever neither needs to report an error
+      constexpr auto program = "module hello.world;\n"
+                               "import lingua.io;\n"
+                               "export fun main(args: ref string) -> int32 {\n"
+                               "   let x: mutable float64 <- 12.5e+3 * (2.0 - 0.25) / 3;\n"
+                               "   let c: char8 <- 'q';\n"
+                               "   for i in [0, 10] { x <- x + i % 2; i++; --x; }\n"
+                               "   if (not (x <= 1) and x != 2 or x >= 3) { return sizeof(x); }\n"
+                               "   assert(valueof(addressof(x)) = copy(x) -> \"fine\");\n"
+                               "   while (x > 0 and x < 100) { break; }\n"
+                               "   type t <- enum { readable, writable, continue_, void0 };\n"
+                               "}\n"sv;
+      auto dfa_input = program;
+      auto hand_written_input = program;
+      auto cursor = source_coordinate{};
+      while (true) {
+         auto const whitespace = ltcpp::detail_lexer::scan_whitespace_like(dfa_input, cursor);
+         assert(whitespace);
+         [[maybe_unused]] auto const hand_written_whitespace =
+            ltcpp::detail_lexer::scan_whitespace_like(hand_written_input, cursor);
+         assert(hand_written_whitespace);
+         if (dfa_input.empty()) {
+            break;
+         }
+
+         cursor = *whitespace;
+         auto const expected = scan_hand_written(hand_written_input, cursor);
+         auto const result = scan_dfa(dfa_input, cursor);
+         CHECK(result == expected);
+         CHECK(dfa_input == hand_written_input);
+         if (dfa_input != hand_written_input) {
+            break;
+         }
+         cursor = result.position().end();
+      }
+   }
+
+   return ::test_result();
+}
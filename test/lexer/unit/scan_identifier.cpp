@@ -51,6 +51,7 @@ int main()
       CHECK_SCAN(scan_identifier, "int16", token_kind::int16, ""sv);
       CHECK_SCAN(scan_identifier, "int32", token_kind::int32, ""sv);
       CHECK_SCAN(scan_identifier, "int64", token_kind::int64, ""sv);
+      CHECK_SCAN(scan_identifier, "string", token_kind::string_, ""sv);
       CHECK_SCAN(scan_identifier, "void", token_kind::void_, ""sv);
    }
    { // Check boolean literals
@@ -58,26 +59,57 @@ int main()
       CHECK_SCAN(scan_identifier, "false", token_kind::boolean_literal, ""sv);
    }
    { // Check keywords
+      CHECK_SCAN(scan_identifier, "addressof", token_kind::addressof_, ""sv);
       CHECK_SCAN(scan_identifier, "assert", token_kind::assert_, ""sv);
       CHECK_SCAN(scan_identifier, "break", token_kind::break_, ""sv);
       CHECK_SCAN(scan_identifier, "continue", token_kind::continue_, ""sv);
+      CHECK_SCAN(scan_identifier, "copy", token_kind::copy_, ""sv);
+      CHECK_SCAN(scan_identifier, "enum", token_kind::enum_, ""sv);
+      CHECK_SCAN(scan_identifier, "export", token_kind::export_, ""sv);
       CHECK_SCAN(scan_identifier, "for", token_kind::for_, ""sv);
       CHECK_SCAN(scan_identifier, "fun", token_kind::fun_, ""sv);
       CHECK_SCAN(scan_identifier, "if", token_kind::if_, ""sv);
       CHECK_SCAN(scan_identifier, "import", token_kind::import_, ""sv);
+      CHECK_SCAN(scan_identifier, "in", token_kind::in_, ""sv);
       CHECK_SCAN(scan_identifier, "let", token_kind::let_, ""sv);
       CHECK_SCAN(scan_identifier, "module", token_kind::module_, ""sv);
       CHECK_SCAN(scan_identifier, "mutable", token_kind::mutable_, ""sv);
       CHECK_SCAN(scan_identifier, "readable", token_kind::readable_, ""sv);
       CHECK_SCAN(scan_identifier, "ref", token_kind::ref_, ""sv);
       CHECK_SCAN(scan_identifier, "return", token_kind::return_, ""sv);
+      CHECK_SCAN(scan_identifier, "sizeof", token_kind::sizeof_, ""sv);
+      CHECK_SCAN(scan_identifier, "type", token_kind::type_, ""sv);
+      CHECK_SCAN(scan_identifier, "valueof", token_kind::valueof_, ""sv);
       CHECK_SCAN(scan_identifier, "while", token_kind::while_, ""sv);
       CHECK_SCAN(scan_identifier, "writable", token_kind::writable_, ""sv);
    }
+   { // Check spellings that are close to keywords
+      CHECK_SCAN(scan_identifier, "a", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "an", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "anD", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "int33", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "float65", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "fon", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "writeable", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "readablE", token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "True", token_kind::identifier, ""sv);
+   }
    { // Check strings with symbols that aren't part of the set of identifiers
       CHECK_SCAN(scan_identifier, "cursor 1", token_kind::identifier, "cursor"sv);
       CHECK_SCAN(scan_identifier, "cursor!1", token_kind::identifier, "cursor"sv);
    }
+   { // Check identifiers that span several 16- and 32-byte blocks
+      constexpr auto long_identifier = "the_quick_brown_fox_jumps_over_the_lazy_dog_0123456789_ABCDEFGHIJKLMNOPQRSTUVWXYZ"sv;
+      CHECK_SCAN(scan_identifier, long_identifier, token_kind::identifier, ""sv);
+      CHECK_SCAN(scan_identifier, "continue_continue_continue_continue", token_kind::identifier, ""sv);
+
+      // Each of these is just outside one of the character ranges, or folds onto one.
+      auto const prefix = std::string(40, 'x');
+      for (auto const boundary : "@[`{/:^\x7f\x80\xc1\xdb\xe0\xfa\xff"sv) {
+         auto const text = prefix + boundary + "y";
+         CHECK_SCAN(scan_identifier, text, token_kind::identifier, prefix);
+      }
+   }
 
    return ::test_result();
 }
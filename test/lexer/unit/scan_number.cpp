@@ -59,5 +59,50 @@ int main()
       CHECK_SCAN(scan_number, "756E", token_kind::exponent_lacking_digit, ""sv);
    }
 
+   { // Values are only decoded on request
+      auto in = "20"sv;
+      auto t = scan_number(in, ltcpp::source_coordinate{});
+      CHECK(not t.integral_value());
+      t.decode_value();
+      CHECK(t.integral_value() == 20U);
+   }
+
+   { // Integral literals are decoded exactly
+      auto const value = [](std::string_view in) {
+         auto t = scan_number(in, ltcpp::source_coordinate{});
+         t.decode_value();
+         return t.integral_value();
+      };
+      CHECK(value("0") == 0U);
+      CHECK(value("20") == 20U);
+      CHECK(value("12345678") == 12'345'678U);
+      CHECK(value("1234567890123456") == 1'234'567'890'123'456U);
+      CHECK(value("0000000000000000000000042") == 42U);
+      CHECK(value("18446744073709551615") == 18'446'744'073'709'551'615U);
+
+      // Too large for 64 bits: the token is still an integral literal, but it has no value.
+      CHECK(not value("18446744073709551616"));
+      CHECK(not value("98765432100123456789"));
+      CHECK(not value("123456789012345678901"));
+      CHECK(not value("1.5"));
+   }
+
+   { // Floating-point literals are decoded to the nearest double
+      auto const value = [](std::string_view in) {
+         auto t = scan_number(in, ltcpp::source_coordinate{});
+         t.decode_value();
+         return t.floating_value();
+      };
+      CHECK(value("1.") == 1.0);
+      CHECK(value(".65") == 0.65);
+      CHECK(value("48.65e-9") == 48.65e-9);
+      CHECK(value("72E+4") == 72e4);
+      CHECK(value("0.1") == 0.1);
+      CHECK(value("9007199254740993.0") == 9007199254740992.0); // ties round to even
+      CHECK(not value("1e400"));
+      CHECK(not value("20"));
+      CHECK(not value("1.2.3"));
+   }
+
    return ::test_result();
 }
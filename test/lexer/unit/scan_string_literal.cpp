@@ -28,25 +28,31 @@ int main()
    using namespace std::string_literals;
    using namespace std::string_view_literals;
 
-   { // Well-formed string literals
+   { // Well-formed string literals are spelled as written
       CHECK_SCAN(scan_string_literal, R"("")", token_kind::string_literal, ""sv);
       CHECK_SCAN(scan_string_literal, R"("hello")", token_kind::string_literal, ""sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\bworld")", token_kind::string_literal,
-         "\"hello\bworld\""sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\fworld")", token_kind::string_literal,
-         "\"hello\fworld\""sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\nworld")", token_kind::string_literal,
-         "\"hello\nworld\""sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\rworld")", token_kind::string_literal,
-         "\"hello\rworld\""sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\tworld")", token_kind::string_literal,
-         "\"hello\tworld\""sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\'world")", token_kind::string_literal,
-         "\"hello'world\""sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\"world")", token_kind::string_literal,
-         R"("hello"world")"sv);
-      CHECK_SCAN(scan_string_literal, R"("hello\\world")", token_kind::string_literal,
-         R"("hello\world")"sv);
+      CHECK_SCAN(scan_string_literal, R"("hello\bworld")", token_kind::string_literal, ""sv);
+      CHECK_SCAN(scan_string_literal, R"("hello\"world")", token_kind::string_literal, ""sv);
+      CHECK_SCAN(scan_string_literal, R"("hello\\" world")", token_kind::string_literal,
+         R"("hello\\")"sv);
+      CHECK_SCAN(scan_string_literal, "\"hello\fworld\"", token_kind::string_literal, ""sv);
+   }
+
+   { // Escape sequences are decoded on request
+      auto const decode = [](std::string_view in) {
+         return scan_string_literal(in, ltcpp::source_coordinate{}).decoded_spelling();
+      };
+      CHECK(decode(R"("hello")") == "\"hello\""s);
+      CHECK(decode(R"("hello\bworld")") == "\"hello\bworld\""s);
+      CHECK(decode(R"("hello\fworld")") == "\"hello\fworld\""s);
+      CHECK(decode(R"("hello\nworld")") == "\"hello\nworld\""s);
+      CHECK(decode(R"("hello\rworld")") == "\"hello\rworld\""s);
+      CHECK(decode(R"("hello\tworld")") == "\"hello\tworld\""s);
+      CHECK(decode(R"("hello\'world")") == "\"hello'world\""s);
+      CHECK(decode(R"("hello\"world")") == R"("hello"world")"s);
+      CHECK(decode(R"("hello\\world")") == R"("hello\world")"s);
+      CHECK(decode(R"("\\n")") == R"("\n")"s);
+      CHECK(decode(R"("hell\o")") == R"("hell\o")"s);
    }
 
    { // Unterminated string literals
@@ -62,5 +68,24 @@ int main()
       CHECK_SCAN(scan_string_literal, R"("\thell\\\o")", token_kind::invalid_escape_sequence, ""sv);
    }
 
+   using ltcpp::detail_lexer::scan_character_literal;
+   { // Character literals
+      CHECK_SCAN(scan_character_literal, "'a'", token_kind::character_literal, ""sv);
+      CHECK_SCAN(scan_character_literal, "' '", token_kind::character_literal, ""sv);
+      CHECK_SCAN(scan_character_literal, "'\f'", token_kind::character_literal, ""sv);
+      CHECK_SCAN(scan_character_literal, "'''", token_kind::character_literal, ""sv);
+      CHECK_SCAN(scan_character_literal, R"('\'')", token_kind::character_literal, R"('\')"sv);
+      CHECK_SCAN(scan_character_literal, R"('\"')", token_kind::character_literal, ""sv);
+      CHECK_SCAN(scan_character_literal, "'a'b'", token_kind::character_literal, "'a'"sv);
+   }
+
+   { // Malformed character literals
+      CHECK_SCAN(scan_character_literal, "'", token_kind::unknown_token, ""sv);
+      CHECK_SCAN(scan_character_literal, "'\n'", token_kind::unknown_token, "'"sv);
+      CHECK_SCAN(scan_character_literal, "'ab'", token_kind::unknown_token, "'a"sv);
+      CHECK_SCAN(scan_character_literal, R"('\n')", token_kind::unknown_token, R"('\)"sv);
+      CHECK_SCAN(scan_character_literal, R"('\"x')", token_kind::unknown_token, R"('\")"sv);
+   }
+
    return ::test_result();
 }
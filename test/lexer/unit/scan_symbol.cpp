@@ -33,6 +33,8 @@ int main()
       CHECK_SCAN(scan_symbol, "*", token_kind::times, ""sv);
       CHECK_SCAN(scan_symbol, "/", token_kind::divide, ""sv);
       CHECK_SCAN(scan_symbol, "%", token_kind::modulo, ""sv);
+      CHECK_SCAN(scan_symbol, "++", token_kind::increment, ""sv);
+      CHECK_SCAN(scan_symbol, "--", token_kind::decrement, ""sv);
    }
 
    { // assignment
@@ -65,8 +67,9 @@ int main()
    { // Check tokens with strange ends to ensure they only conform to the first token.
       CHECK_SCAN(scan_symbol, "+ =", token_kind::plus, "+"sv);
       CHECK_SCAN(scan_symbol, "+-", token_kind::plus, "+"sv);
-      CHECK_SCAN(scan_symbol, "++", token_kind::plus, "+"sv);
-      CHECK_SCAN(scan_symbol, "--", token_kind::minus, "-"sv);
+      CHECK_SCAN(scan_symbol, "+++", token_kind::increment, "++"sv);
+      CHECK_SCAN(scan_symbol, "--->", token_kind::decrement, "--"sv);
+      CHECK_SCAN(scan_symbol, "-->", token_kind::decrement, "--"sv);
       CHECK_SCAN(scan_symbol, "%%", token_kind::modulo, "%"sv);
    }
 
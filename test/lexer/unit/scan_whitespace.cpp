@@ -16,11 +16,14 @@
 #include "ltcpp/lexer/detail/scan_whitespace.hpp"
 #include "ltcpp/lexer/token.hpp"
 
+#include "../../random_source.hpp"
 #include "./check_scan.hpp"
 #include <cassert>
+#include <cstdint>
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #define CHECK_SCAN_WHITESPACE_IMPL(spaces, coord, expected) {                                      \
    auto in = std::istringstream{spaces};                                                           \
@@ -28,6 +31,12 @@
    auto result = scan_whitespace_like(in, coord);                                                  \
    assert(result);                                                                                 \
    CHECK(*result == expected);                                                                     \
+                                                                                                   \
+   auto buffer = std::string_view{spaces};                                                         \
+   auto buffer_result = scan_whitespace_like(buffer, coord);                                       \
+   assert(buffer_result);                                                                          \
+   CHECK(*buffer_result == expected);                                                              \
+   CHECK(buffer == unscanned(in));                                                                 \
 }                                                                                                  \
 
 template<class R>
@@ -59,6 +68,7 @@ int main()
    // Check numbers can be correctly scanned in
    using ltcpp::source_coordinate;
    using ltcpp::detail_lexer::scan_whitespace_like;
+   using ltcpp::detail_lexer::skip_whitespace_like;
    using column_type = source_coordinate::column_type;
    using line_type = source_coordinate::line_type;
    using namespace std::string_literals;
@@ -127,11 +137,65 @@ int main()
          constexpr auto multi_line = "/**\n"
                                     " * \\brief This is a multi-line comment\r\n"
                                     " */"sv;
-         CHECK_SCAN_WHITESPACE(multi_line, line_type{2}, column_type{3});
+         CHECK_SCAN_WHITESPACE(multi_line, line_type{2}, column_type{4});
 
          constexpr auto fake_end = "/*/ hahaha */"sv;
          CHECK_SCAN_WHITESPACE(fake_end, line_type{0}, column_type{distance(fake_end)});
       }
+      { // Comments that span several 16- and 32-byte blocks
+         constexpr auto long_line = "// the quick brown fox jumps over the lazy dog, twice over\n"sv;
+         CHECK_SCAN_WHITESPACE(long_line, line_type{1}, column_type{0});
+
+         constexpr auto lone_carriage_returns = "// a lone\rcarriage return\rdoesn't end this line\r\n"sv;
+         CHECK_SCAN_WHITESPACE(lone_carriage_returns, line_type{1}, column_type{0});
+
+         constexpr auto mixed_line_breaks = "/* abcdefghijklmnopqrstuvwxyz0123\n"
+                                            "abcdefghijklmnopqrstuvwxyz012345\n\r"
+                                            "abcdefghijklmnopqrstuvwxyz01234\r\n"
+                                            "\f\r * ** ********************* */"sv;
+         CHECK_SCAN_WHITESPACE(mixed_line_breaks, line_type{4}, column_type{32});
+
+         // Each '\n' falls on the last byte of a 32-byte block, and a '\r' starts the next.
+         constexpr auto split_pairs = "/* 4567890123456789012345678901\n"
+                                      "\r234567890123456789012345678901\n"
+                                      "\r*/"sv;
+         CHECK_SCAN_WHITESPACE(split_pairs, line_type{2}, column_type{3});
+      }
+      { // Long runs of blanks
+         CHECK_SCAN_WHITESPACE(std::string(100, ' '), line_type{0}, column_type{100});
+         CHECK_SCAN_WHITESPACE(std::string(31, '\t') + "x", line_type{0}, column_type{31});
+         CHECK_SCAN_WHITESPACE(std::string(40, ' ') + "\n" + std::string(17, '\t'), line_type{1}, column_type{18});
+      }
+      { // The buffer path agrees with the stream path, however the characters line up
+         constexpr auto alphabet = " \t\n\r\f*/ab"sv;
+         auto seed = std::uint32_t{2'147'483'647};
+         for (auto trial = 0; trial != 2'000; ++trial) {
+            auto comment = std::string{trial % 2 == 0 ? "/*" : "//"};
+            comment += random_source(seed, alphabet, static_cast<std::size_t>(trial % 97));
+            comment += trial % 3 == 0 ? "" : "*/";
+
+            auto in = std::istringstream{comment};
+            in.unsetf(std::ios_base::skipws);
+            auto const result = scan_whitespace_like(in, source_coordinate{});
+
+            auto buffer = std::string_view{comment};
+            auto const buffer_result = scan_whitespace_like(buffer, source_coordinate{});
+            CHECK(buffer_result.has_value() == result.has_value());
+            if (result and buffer_result) {
+               CHECK(*buffer_result == *result);
+            }
+            else if (not result and not buffer_result) {
+               CHECK(buffer_result.error() == result.error());
+            }
+            CHECK(buffer == unscanned(in));
+
+            // Skipping without coordinates stops in the same place.
+            auto skipped = std::string_view{comment};
+            auto const unterminated = skip_whitespace_like(skipped);
+            CHECK(skipped == buffer);
+            CHECK(unterminated.has_value() == not buffer_result.has_value());
+         }
+      }
       { // Unterminated comment
          auto comment = "\n"
                         "   /* this is the comment that never ends,\n"
@@ -146,6 +210,17 @@ int main()
          assert(not result);
          CHECK(result.error().begin() == source_coordinate{line_type{2}, column_type{4}});
          CHECK(result.error().end() == source_coordinate{line_type{7}, column_type{1}});
+
+         auto buffer = std::string_view{comment};
+         auto const buffer_result = scan_whitespace_like(buffer, source_coordinate{});
+         assert(empty(buffer));
+         assert(not buffer_result);
+         CHECK(buffer_result.error() == result.error());
+
+         auto skipped = std::string_view{comment};
+         auto const unterminated = skip_whitespace_like(skipped);
+         assert(empty(skipped));
+         CHECK(unterminated == comment.substr(comment.find("/*")));
       }
    }
 
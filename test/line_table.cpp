@@ -0,0 +1,127 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/line_table.hpp"
+
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include "ltcpp/source_coordinate.hpp"
+#include "ltcpp/text_edit.hpp"
+#include "./random_source.hpp"
+#include "./simple_test.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+   using ltcpp::source_coordinate;
+
+   source_coordinate at(std::intmax_t const line, std::intmax_t const column)
+   { return source_coordinate{source_coordinate::line_type{line}, source_coordinate::column_type{column}}; }
+
+   /// Checks that the table places every token where the lexer does.
+   ///
+   void check_same_as_lexer(std::string_view const source)
+   {
+      auto const table = ltcpp::line_table{source};
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+
+      auto unscanned = source;
+      auto cursor = source_coordinate{};
+      for (;;) {
+         auto const t = ltcpp::generate_token(unscanned, report, cursor);
+         auto const offset = t.kind() == ltcpp::token_kind::eof
+                           ? source.size()
+                           : static_cast<std::size_t>(t.spelling().data() - source.data());
+         CHECK(table.coordinate(static_cast<std::uint32_t>(offset)) == t.position().begin());
+         if (t.kind() == ltcpp::token_kind::eof) {
+            return;
+         }
+         cursor = t.position().end();
+      }
+   }
+} // namespace
+
+int main()
+{
+   // Checks that line_table maps offsets to the coordinates that the lexer tracks.
+   using namespace std::string_view_literals;
+
+   { // Each kind of line break
+      auto const table = ltcpp::line_table{"a\nb\r\nc\n\rd\fe\rf"};
+      CHECK(table.line_count() == 5U);
+      CHECK(table.coordinate(0) == at(1, 1));
+      CHECK(table.coordinate(2) == at(2, 1));
+      CHECK(table.coordinate(5) == at(3, 1));
+      CHECK(table.coordinate(8) == at(4, 1));
+      CHECK(table.coordinate(10) == at(5, 1));
+      CHECK(table.coordinate(12) == at(5, 3));
+      CHECK(table.coordinate(13) == at(5, 4));
+   }
+   { // Adjacent pairs are split the way the lexer splits them
+      CHECK(ltcpp::line_table{"\n\r\n"}.line_count() == 3U);
+      CHECK(ltcpp::line_table{"\r\n\n"}.line_count() == 3U);
+      CHECK(ltcpp::line_table{"\r\r\n"}.line_count() == 2U);
+      CHECK(ltcpp::line_table{"\r\r"}.line_count() == 1U);
+      CHECK(ltcpp::line_table{""}.line_count() == 1U);
+   }
+   { // The table agrees with the lexer, however the line breaks line up with the vector blocks
+      check_same_as_lexer("fun main() -> int32\n{\n   print(\"Hello, world!\\n\");\n}\n");
+      constexpr auto alphabet = " \t\n\r\fx;"sv;
+      auto seed = std::uint32_t{2'147'483'647};
+      for (auto trial = 0; trial != 500; ++trial) {
+         check_same_as_lexer(random_source(seed, alphabet, static_cast<std::size_t>(trial % 211)));
+      }
+   }
+   { // Edits that join and split pairs of line breaks
+      auto const check_edit = [](std::string before, std::size_t const offset, std::size_t const removed,
+         std::string_view const inserted) {
+         auto table = ltcpp::line_table{before};
+         auto after = before.replace(offset, removed, inserted);
+         table.edit(after, ltcpp::text_edit{offset, removed, inserted.size()});
+         auto const expected = ltcpp::line_table{after};
+         CHECK(std::ranges::equal(table.line_starts(), expected.line_starts()));
+      };
+      check_edit("a\nb\nc", 2, 1, "xyz");
+      check_edit("\n\n\n\n", 0, 0, "\r");
+      check_edit("\n\r\n\r\n\r\n", 1, 1, "");
+      check_edit("\r\r\r\r", 2, 0, "\n");
+      check_edit("a\r\nb", 2, 0, "\f");
+      check_edit("a\nb", 0, 4, "");
+      check_edit("", 0, 0, "\n\r\n");
+   }
+   { // Joining the lines that a '\f' in a literal split
+      auto table = ltcpp::line_table{"a \"b\f\fc\" d\fe\n\"f\f"};
+      CHECK(table.line_count() == 6U);
+      table.join_lines(2, 8);
+      CHECK(table.line_count() == 4U);
+      CHECK(table.coordinate(9) == at(1, 10));
+      CHECK(table.coordinate(11) == at(2, 1));
+      table.join_lines(13, 16);
+      CHECK(table.line_count() == 3U);
+      CHECK(table.coordinate(16) == at(3, 4));
+
+      // An edit looks again at the whole of the line it's on, and splits it again.
+      CHECK(table.edit("a \"b\f\fc\" d\fe\n\"f\fg", ltcpp::text_edit{16, 0, 1}) == 17U);
+      CHECK(table.line_count() == 4U);
+   }
+
+   return ::test_result();
+}
@@ -0,0 +1,49 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef TEST_RANDOM_SOURCE_HPP
+#define TEST_RANDOM_SOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// \brief Advances seed, a linear congruential generator's state, and returns a number below
+///        bound, or 0 if bound is 0.
+///
+/// The sequence is the same on every platform, so a failure can be reproduced from the seed.
+///
+inline std::uint32_t random_below(std::uint32_t& seed, std::uint32_t const bound) noexcept
+{
+   seed = seed * 1'664'525 + 1'013'904'223;
+   return bound == 0 ? 0 : (seed >> 8) % bound;
+}
+
+/// \brief Returns size characters drawn from alphabet, advancing seed past them so that each call
+///        gives a different source.
+/// \pre `not alphabet.empty()`
+///
+inline std::string random_source(std::uint32_t& seed, std::string_view const alphabet, std::size_t const size)
+{
+   auto result = std::string{};
+   result.reserve(size);
+   for (auto i = std::size_t{0}; i != size; ++i) {
+      result += alphabet[random_below(seed, static_cast<std::uint32_t>(alphabet.size()))];
+   }
+   return result;
+}
+
+#endif // TEST_RANDOM_SOURCE_HPP
@@ -0,0 +1,137 @@
+//
+//  Copyright Christopher Di Bella
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "ltcpp/source_file.hpp"
+
+#include "./simple_test.hpp"
+#include "ltcpp/lexer/lexer.hpp"
+#include "ltcpp/lexer/token.hpp"
+#include "ltcpp/reporter.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+   std::filesystem::path write_temporary(std::string_view const name, std::string const& contents)
+   {
+      auto path = std::filesystem::temp_directory_path() / (std::to_string(::getpid()) + "-" + std::string{name});
+      auto out = std::ofstream{path, std::ios_base::binary};
+      out << contents;
+      return path;
+   }
+
+   std::string make_program(std::size_t const minimum_size)
+   {
+      auto result = std::string{};
+      while (result.size() < minimum_size) {
+         result += "fun f() -> int32 // comment\n"
+                   "{\n"
+                   "   let x <- 10.5e3; /* another\n"
+                   "   comment */ return \"hello\\tworld\";\n"
+                   "}\n";
+      }
+      return result;
+   }
+
+   void check_lexes_like_a_buffer(ltcpp::source_file const& file, std::string_view const expected)
+   {
+      auto errors = std::ostringstream{};
+      auto report = ltcpp::reporter{errors};
+
+      auto actual_in = file.text();
+      auto expected_in = expected;
+      auto cursor = ltcpp::source_coordinate{};
+      for (;;) {
+         auto const actual = ltcpp::generate_token(actual_in, report, cursor);
+         CHECK(actual == ltcpp::generate_token(expected_in, report, cursor));
+         if (actual.kind() == ltcpp::token_kind::eof) {
+            break;
+         }
+         cursor = actual.position().end();
+      }
+      CHECK(report.errors() == 0);
+   }
+} // namespace
+
+int main()
+{
+   // Checks that ltcpp::source_file exposes exactly the contents of the file.
+   using ltcpp::source_file;
+
+   { // Small files are read rather than mapped
+      auto const contents = make_program(1);
+      auto const path = write_temporary("ltcpp-source-file-small.lt", contents);
+      auto const file = source_file{path};
+      CHECK(not file.is_mapped());
+      CHECK(file.text() == contents);
+      check_lexes_like_a_buffer(file, contents);
+      std::filesystem::remove(path);
+   }
+
+   { // Large files are mapped
+      auto const contents = make_program(4 * source_file::minimum_mapping_size);
+      auto const path = write_temporary("ltcpp-source-file-large.lt", contents);
+      auto file = source_file{path};
+      CHECK(file.is_mapped());
+      CHECK(file.text() == contents);
+      check_lexes_like_a_buffer(file, contents);
+
+      // Moving doesn't invalidate the text
+      auto const text = file.text();
+      auto const moved = std::move(file);
+      CHECK(moved.text().data() == text.data());
+      CHECK(moved.text() == contents);
+      std::filesystem::remove(path);
+   }
+
+   { // Empty files
+      auto const path = write_temporary("ltcpp-source-file-empty.lt", "");
+      auto const file = source_file{path};
+      CHECK(file.text().empty());
+      std::filesystem::remove(path);
+   }
+
+   { // Pipes are read
+      int fds[2];
+      CHECK(::pipe(fds) == 0);
+      auto const contents = std::string{"module hello;\n"};
+      CHECK(::write(fds[1], contents.data(), contents.size()) == static_cast<ssize_t>(contents.size()));
+      ::close(fds[1]);
+
+      auto const file = source_file{"/dev/fd/" + std::to_string(fds[0])};
+      CHECK(not file.is_mapped());
+      CHECK(file.text() == contents);
+      ::close(fds[0]);
+   }
+
+   { // Missing files throw
+      auto threw = false;
+      try {
+         auto const file = source_file{"/this/path/does/not/exist.lt"};
+      }
+      catch (std::system_error const&) {
+         threw = true;
+      }
+      CHECK(threw);
+   }
+
+   return ::test_result();
+}